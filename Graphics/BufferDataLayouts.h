@@ -53,6 +53,12 @@ namespace Graphics {
         { T::getDescriptorBindingFlags() } -> std::same_as<vk::DescriptorBindingFlags>;
     };
 
+    template<typename T>
+    concept PushConstantDefinition = requires {
+        typename T::Type;
+        { T::getPushConstantRange() } -> std::same_as<vk::PushConstantRange>;
+    };
+
     template <VertexDefinition... Defs>
     class VertexDefinitions : public TypeErasedArray<Defs...> {
     public:
@@ -103,6 +109,20 @@ namespace Graphics {
         }
     };
 
+    template <PushConstantDefinition... Defs>
+    class PushConstantDefinitions : public TypeErasedArray<Defs...> {
+    public:
+        auto enumerateRanges() const
+        {
+            std::vector<vk::PushConstantRange> ranges;
+            ranges.reserve(this->size());
+            this->iterateComplete([&]<PushConstantDefinition T>(const T & elem) {
+                ranges.push_back(elem.getPushConstantRange());
+            });
+            return ranges;
+        }
+    };
+
     struct VertexBasic
     {
         glm::vec4 position;
@@ -342,6 +362,251 @@ namespace Graphics {
         }
     };
 
+    // tightly packed, the default glm vectors are 16 byte aligned in this project
+    using PackedVec2 = glm::vec<2, float, glm::packed>;
+    using PackedVec3 = glm::vec<3, float, glm::packed>;
+
+    // quantized attribute types, each maps to a single vertex input format
+
+    // 4 half floats, w is padding for positions since 3 component 16 bit formats are rarely supported
+    struct PackedHalf4
+    {
+        uint64_t bits = 0;
+
+        static PackedHalf4 pack(const glm::vec4& value) { return { glm::packHalf4x16(value) }; };
+        glm::vec4 unpack() const { return glm::unpackHalf4x16(bits); };
+    };
+
+    struct PackedHalf2
+    {
+        uint32_t bits = 0;
+
+        static PackedHalf2 pack(const glm::vec2& value) { return { glm::packHalf2x16(value) }; };
+        glm::vec2 unpack() const { return glm::unpackHalf2x16(bits); };
+    };
+
+    // positions divided by a scale into [-1, 1], the shader multiplies the scale back in,
+    // evenly spaced precision unlike half floats, meant for meshes with known bounds
+    struct PackedSnorm16x4
+    {
+        uint64_t bits = 0;
+
+        static PackedSnorm16x4 pack(const glm::vec3& value, float scale) {
+            return { glm::packSnorm4x16(glm::vec4(value / scale, 1.0f)) };
+        };
+        glm::vec3 unpack(float scale) const { return glm::vec3(glm::unpackSnorm4x16(bits)) * scale; };
+    };
+
+    // unit vector in 10:10:10:2, stored as unorm since snorm 2_10_10_10 vertex fetch is optional,
+    // the shader decodes with n * 2.0 - 1.0, w is free for a tangent sign
+    struct PackedNormal
+    {
+        uint32_t bits = 0;
+
+        static PackedNormal pack(const glm::vec3& normal, float w = 1.0f) {
+            return { glm::packUnorm3x10_1x2(glm::vec4(normal * 0.5f + 0.5f, w)) };
+        };
+        glm::vec3 unpack() const { return glm::vec3(glm::unpackUnorm3x10_1x2(bits)) * 2.0f - 1.0f; };
+    };
+
+    // the top 3 rows of an affine transform, 48 bytes instead of a full mat4,
+    // the shader rebuilds the position as vec3(dot(rows[0], p), dot(rows[1], p), dot(rows[2], p))
+    struct AffineTransform
+    {
+        glm::vec4 rows[3];
+
+        static AffineTransform fromMatrix(const glm::mat4& matrix) {
+            return { { glm::row(matrix, 0), glm::row(matrix, 1), glm::row(matrix, 2) } };
+        };
+
+        glm::mat4 toMatrix() const {
+            return glm::transpose(glm::mat4(rows[0], rows[1], rows[2], glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+        };
+    };
+
+    // maps an attribute type to its format, types wider than 16 bytes take several consecutive locations
+    template<typename T>
+    struct VertexFormat;
+
+    template<glm::length_t L, glm::qualifier Q>
+    struct VertexFormat<glm::vec<L, float, Q>> {
+        static constexpr vk::Format format = L == 1 ? vk::Format::eR32Sfloat :
+            L == 2 ? vk::Format::eR32G32Sfloat : L == 3 ? vk::Format::eR32G32B32Sfloat : vk::Format::eR32G32B32A32Sfloat;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<glm::length_t L, glm::qualifier Q>
+    struct VertexFormat<glm::vec<L, uint32_t, Q>> {
+        static constexpr vk::Format format = L == 1 ? vk::Format::eR32Uint :
+            L == 2 ? vk::Format::eR32G32Uint : L == 3 ? vk::Format::eR32G32B32Uint : vk::Format::eR32G32B32A32Uint;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<>
+    struct VertexFormat<float> : VertexFormat<glm::vec<1, float, glm::defaultp>> {};
+
+    template<>
+    struct VertexFormat<uint32_t> : VertexFormat<glm::vec<1, uint32_t, glm::defaultp>> {};
+
+    template<>
+    struct VertexFormat<PackedHalf4> {
+        static constexpr vk::Format format = vk::Format::eR16G16B16A16Sfloat;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<>
+    struct VertexFormat<PackedHalf2> {
+        static constexpr vk::Format format = vk::Format::eR16G16Sfloat;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<>
+    struct VertexFormat<PackedSnorm16x4> {
+        static constexpr vk::Format format = vk::Format::eR16G16B16A16Snorm;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<>
+    struct VertexFormat<PackedNormal> {
+        static constexpr vk::Format format = vk::Format::eA2B10G10R10UnormPack32;
+        static constexpr uint32_t locations = 1;
+        static constexpr uint32_t locationStride = 0;
+    };
+
+    template<>
+    struct VertexFormat<AffineTransform> {
+        static constexpr vk::Format format = vk::Format::eR32G32B32A32Sfloat;
+        static constexpr uint32_t locations = 3;
+        static constexpr uint32_t locationStride = sizeof(glm::vec4);
+    };
+
+    template<>
+    struct VertexFormat<glm::mat4> {
+        static constexpr vk::Format format = vk::Format::eR32G32B32A32Sfloat;
+        static constexpr uint32_t locations = 4;
+        static constexpr uint32_t locationStride = sizeof(glm::vec4);
+    };
+
+    // one member of a vertex struct, the offset comes from offsetof so it always matches the struct
+    template<typename T, size_t offset>
+    struct VertexAttribute {
+        using Type = T;
+        static constexpr uint32_t OFFSET = offset;
+        static constexpr vk::Format FORMAT = VertexFormat<T>::format;
+        static constexpr uint32_t LOCATION_COUNT = VertexFormat<T>::locations;
+        static constexpr uint32_t LOCATION_STRIDE = VertexFormat<T>::locationStride;
+    };
+
+    template<uint32_t binding, uint32_t firstLocation, typename... Attributes>
+    constexpr auto makeAttributeDescriptions()
+    {
+        std::array<vk::VertexInputAttributeDescription, (Attributes::LOCATION_COUNT + ...)> descriptions{};
+        uint32_t location = firstLocation;
+        size_t index = 0;
+        ([&]() {
+            for (uint32_t i = 0; i < Attributes::LOCATION_COUNT; i++)
+                descriptions[index++] = vk::VertexInputAttributeDescription(location++, binding,
+                    Attributes::FORMAT, Attributes::OFFSET + i * Attributes::LOCATION_STRIDE);
+            }(), ...);
+        return descriptions;
+    }
+
+    // builds the binding and attribute tables of a single interleaved binding from a struct and its attribute list,
+    // locations are handed out in order starting at firstLocation
+    template<typename T, uint32_t binding, vk::VertexInputRate inputRate, uint32_t firstLocation, typename... Attributes>
+    struct StructVertexDefinition {
+    public:
+        static_assert(sizeof...(Attributes) > 0, "StructVertexDefinition needs at least one attribute");
+        static_assert(((Attributes::OFFSET + sizeof(typename Attributes::Type) <= sizeof(T)) && ...),
+            "StructVertexDefinition attribute lies outside of the vertex struct");
+
+        static constexpr size_t BINDING_COUNT = 1;
+        static constexpr size_t ATTRIBUTE_COUNT = (Attributes::LOCATION_COUNT + ...);
+        static constexpr size_t DATA_SIZE = sizeof(T);
+
+        using Type = T;
+
+        static constexpr vk::VertexInputBindingDescription bindings[] = {
+            {
+                binding,                                // binding
+                DATA_SIZE,                              // stride
+                inputRate                               // input rate
+            }
+        };
+
+        static constexpr auto attributes = makeAttributeDescriptions<binding, firstLocation, Attributes...>();
+
+        static ArrayInterface<vk::VertexInputBindingDescription> getBindingDescriptions() {
+            return ArrayInterface<vk::VertexInputBindingDescription>(bindings, BINDING_COUNT);
+        }
+
+        static ArrayInterface<vk::VertexInputAttributeDescription> getAttributeDescriptions() {
+            return ArrayInterface<vk::VertexInputAttributeDescription>(attributes.data(), ATTRIBUTE_COUNT);
+        }
+    };
+
+    // position, uv and normal in one stream, 24 bytes
+    struct VertexInterleaved
+    {
+        PackedVec3 position;
+        PackedVec2 UV;
+        PackedNormal normal;
+    };
+
+    using VertexDefinitionInterleaved = StructVertexDefinition<VertexInterleaved, 0, vk::VertexInputRate::eVertex, 0,
+        VertexAttribute<PackedVec3, offsetof(VertexInterleaved, position)>,
+        VertexAttribute<PackedVec2, offsetof(VertexInterleaved, UV)>,
+        VertexAttribute<PackedNormal, offsetof(VertexInterleaved, normal)>>;
+
+    // same stream with half float position and uv, 16 bytes
+    struct VertexQuantized
+    {
+        PackedHalf4 position;
+        PackedHalf2 UV;
+        PackedNormal normal;
+    };
+
+    using VertexDefinitionQuantized = StructVertexDefinition<VertexQuantized, 0, vk::VertexInputRate::eVertex, 0,
+        VertexAttribute<PackedHalf4, offsetof(VertexQuantized, position)>,
+        VertexAttribute<PackedHalf2, offsetof(VertexQuantized, UV)>,
+        VertexAttribute<PackedNormal, offsetof(VertexQuantized, normal)>>;
+
+    // snorm16 position scaled by the mesh bounds, 16 bytes
+    struct VertexQuantizedSnorm
+    {
+        PackedSnorm16x4 position;
+        PackedHalf2 UV;
+        PackedNormal normal;
+    };
+
+    using VertexDefinitionQuantizedSnorm = StructVertexDefinition<VertexQuantizedSnorm, 0, vk::VertexInputRate::eVertex, 0,
+        VertexAttribute<PackedSnorm16x4, offsetof(VertexQuantizedSnorm, position)>,
+        VertexAttribute<PackedHalf2, offsetof(VertexQuantizedSnorm, UV)>,
+        VertexAttribute<PackedNormal, offsetof(VertexQuantizedSnorm, normal)>>;
+
+    // greedy meshed voxel faces, uvs count blocks so merged faces repeat the texture,
+    // textureId indexes the bindless textures[] array, 24 bytes
+    struct VertexVoxel
+    {
+        PackedVec3 position;
+        PackedVec2 UV;
+        uint32_t textureId;
+    };
+
+    using VertexDefinitionVoxel = StructVertexDefinition<VertexVoxel, 0, vk::VertexInputRate::eVertex, 0,
+        VertexAttribute<PackedVec3, offsetof(VertexVoxel, position)>,
+        VertexAttribute<PackedVec2, offsetof(VertexVoxel, UV)>,
+        VertexAttribute<uint32_t, offsetof(VertexVoxel, textureId)>>;
+
+    // per instance 3x4 transform, locations 3 to 5 so it fits next to the interleaved vertex
+    using VertexDefinitionAffineTransform = StructVertexDefinition<AffineTransform, 2, vk::VertexInputRate::eInstance, 3,
+        VertexAttribute<AffineTransform, 0>>;
+
     struct UniformTransforms {
         glm::mat4 view;
         glm::mat4 proj;
@@ -410,7 +675,8 @@ namespace Graphics {
         static constexpr vk::DescriptorBindingFlags descriptorSetLayoutBindingFlags =
             vk::DescriptorBindingFlagBits::ePartiallyBound |
             vk::DescriptorBindingFlagBits::eVariableDescriptorCount |
-            vk::DescriptorBindingFlagBits::eUpdateAfterBind;
+            vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+            vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
 
         static vk::DescriptorSetLayoutBinding
             getDescriptorSetLayoutBinding()
@@ -424,4 +690,136 @@ namespace Graphics {
             return descriptorSetLayoutBindingFlags;
         };
     };
+
+    template <size_t binding, vk::ShaderStageFlagBits stage>
+    struct UniformBufferDefinition {
+        static constexpr size_t BINDING_COUNT = 1;
+
+        static constexpr vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = {
+                binding,                                // binding
+                vk::DescriptorType::eUniformBuffer,     // descriptor type
+                1,                                      // descriptor count
+                stage,                                  // stage flags
+                nullptr                                 // immutable samplers
+        };
+
+        static vk::DescriptorSetLayoutBinding
+            getDescriptorSetLayoutBinding()
+        {
+            return descriptorSetLayoutBinding;
+        };
+
+        static vk::DescriptorBindingFlags
+            getDescriptorBindingFlags()
+        {
+            return vk::DescriptorBindingFlags();
+        };
+    };
+
+    template <size_t binding, vk::ShaderStageFlagBits stage>
+    struct StorageBufferDefinition {
+        static constexpr size_t BINDING_COUNT = 1;
+
+        static constexpr vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = {
+                binding,                                // binding
+                vk::DescriptorType::eStorageBuffer,     // descriptor type
+                1,                                      // descriptor count
+                stage,                                  // stage flags
+                nullptr                                 // immutable samplers
+        };
+
+        static vk::DescriptorSetLayoutBinding
+            getDescriptorSetLayoutBinding()
+        {
+            return descriptorSetLayoutBinding;
+        };
+
+        static vk::DescriptorBindingFlags
+            getDescriptorBindingFlags()
+        {
+            return vk::DescriptorBindingFlags();
+        };
+    };
+
+    // the offset is supplied at bind time through dynamicOffsets, see DynamicBufferRing
+    template <size_t binding, vk::ShaderStageFlagBits stage>
+    struct DynamicUniformBufferDefinition {
+        static constexpr size_t BINDING_COUNT = 1;
+
+        static constexpr vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = {
+                binding,                                    // binding
+                vk::DescriptorType::eUniformBufferDynamic,  // descriptor type
+                1,                                          // descriptor count
+                stage,                                      // stage flags
+                nullptr                                     // immutable samplers
+        };
+
+        static vk::DescriptorSetLayoutBinding
+            getDescriptorSetLayoutBinding()
+        {
+            return descriptorSetLayoutBinding;
+        };
+
+        static vk::DescriptorBindingFlags
+            getDescriptorBindingFlags()
+        {
+            return vk::DescriptorBindingFlags();
+        };
+    };
+
+    template <size_t binding, vk::ShaderStageFlagBits stage>
+    struct DynamicStorageBufferDefinition {
+        static constexpr size_t BINDING_COUNT = 1;
+
+        static constexpr vk::DescriptorSetLayoutBinding descriptorSetLayoutBinding = {
+                binding,                                    // binding
+                vk::DescriptorType::eStorageBufferDynamic,  // descriptor type
+                1,                                          // descriptor count
+                stage,                                      // stage flags
+                nullptr                                     // immutable samplers
+        };
+
+        static vk::DescriptorSetLayoutBinding
+            getDescriptorSetLayoutBinding()
+        {
+            return descriptorSetLayoutBinding;
+        };
+
+        static vk::DescriptorBindingFlags
+            getDescriptorBindingFlags()
+        {
+            return vk::DescriptorBindingFlags();
+        };
+    };
+
+    // a block of push constants, stages is a VkShaderStageFlags mask since vk::ShaderStageFlags can't be a template argument
+    template <typename T, VkShaderStageFlags stages, uint32_t offset = 0>
+    struct PushConstantBlockDefinition {
+        static_assert(std::is_trivially_copyable_v<T>, "push constant blocks are copied as raw bytes");
+        static_assert(sizeof(T) % 4 == 0 && offset % 4 == 0, "push constant size and offset must be multiples of 4");
+
+        using Type = T;
+
+        static constexpr vk::PushConstantRange pushConstantRange = {
+                vk::ShaderStageFlags(stages),           // stage flags
+                offset,                                 // offset
+                sizeof(T)                               // size
+        };
+
+        static vk::PushConstantRange
+            getPushConstantRange()
+        {
+            return pushConstantRange;
+        };
+    };
+
+    // small per draw parameters that don't warrant a buffer write
+    struct DrawParameters {
+        uint32_t materialIndex;
+        float lodFade;
+        uint32_t pad[2];
+    };
+
+    using DrawParametersDefinition = PushConstantBlockDefinition<DrawParameters,
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT>;
 }
\ No newline at end of file
@@ -21,6 +21,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/packing.hpp>
 #include <glm/gtx/euler_angles.hpp>
 
 #include <stb_image.h>
@@ -42,6 +44,7 @@
 #include <chrono>
 
 #include "FrameRateCalculator.h"
+#include "FramePacer.h"
 
 namespace Graphics {
 
@@ -200,6 +203,19 @@ namespace Graphics {
         return current;
     }
 
+    // 64 bit FNV-1a, unlike std::hash it is stable between runs so it can be written to disk
+    static constexpr uint64_t hashSeed = 14695981039346656037ull;
+
+    static uint64_t hashBytes(const void* data, size_t size, uint64_t hash = hashSeed)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
     enum class DescriptorType
     {
         UniformBuffer = vk::DescriptorType::eUniformBuffer,
@@ -210,6 +226,14 @@ namespace Graphics {
         InputAttachment = vk::DescriptorType::eInputAttachment,
         UniformTexelBuffer = vk::DescriptorType::eUniformTexelBuffer,
         StorageTexelBuffer = vk::DescriptorType::eStorageTexelBuffer,
+        UniformBufferDynamic = vk::DescriptorType::eUniformBufferDynamic,
+        StorageBufferDynamic = vk::DescriptorType::eStorageBufferDynamic,
+    };
+
+    enum class IndexType
+    {
+        Uint16 = vk::IndexType::eUint16,
+        Uint32 = vk::IndexType::eUint32,
     };
 
 } // namespace Graphics
\ No newline at end of file
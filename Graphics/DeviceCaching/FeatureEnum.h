@@ -35,6 +35,7 @@ namespace Graphics {
         ShaderBufferInt64Atomics,    // Requires VkPhysicalDeviceShaderAtomicInt64Features
         ShaderSharedInt64Atomics,
         ShaderInt8,    // Requires VkPhysicalDeviceShaderFloat16Int8Features
+        TimelineSemaphore,    // Requires VkPhysicalDeviceTimelineSemaphoreFeatures
 
         // Bindless Texture Features (Vulkan 1.2 - Descriptor Indexing)
         DescriptorBindingPartiallyBound,         // Allow partially bound descriptor arrays
@@ -46,6 +47,9 @@ namespace Graphics {
         ShaderSampledImageArrayNonUniformIndexing,
         RuntimeDescriptorArray,                   // Allow variable-sized descriptor arrays
 
+        // Indirect Drawing Features
+        DrawIndirectCount,    // Requires VK_KHR_draw_indirect_count, the device enables the extension along with it
+
         FeaturesNum
     };
 
@@ -82,6 +86,7 @@ namespace Graphics {
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::ShaderBufferInt64Atomics> { using Type = bool; };
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::ShaderSharedInt64Atomics> { using Type = bool; };
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::ShaderInt8> { using Type = bool; };
+    template<> struct DeviceFeatureTypeTrait<DeviceFeature::TimelineSemaphore> { using Type = bool; };
 
     // Bindless Texture Features
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::DescriptorBindingPartiallyBound> { using Type = bool; };
@@ -93,4 +98,7 @@ namespace Graphics {
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::ShaderSampledImageArrayNonUniformIndexing> { using Type = bool; };
     template<> struct DeviceFeatureTypeTrait<DeviceFeature::RuntimeDescriptorArray> { using Type = bool; };
 
+    // Indirect Drawing Features
+    template<> struct DeviceFeatureTypeTrait<DeviceFeature::DrawIndirectCount> { using Type = bool; };
+
 }
\ No newline at end of file
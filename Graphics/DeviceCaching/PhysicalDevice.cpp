@@ -143,6 +143,8 @@ namespace Graphics {
                 static_cast<bool>(shaderAtomicInt64Features.shaderSharedInt64Atomics));
             storeFeature(DeviceFeature::ShaderInt8,
                 static_cast<bool>(shaderFloat16Int8Features.shaderInt8));
+            storeFeature(DeviceFeature::TimelineSemaphore,
+                static_cast<bool>(timelineSemaphoreFeatures.timelineSemaphore));
         }
 
         // Store Vulkan 1.2 indexing features
@@ -165,6 +167,14 @@ namespace Graphics {
             storeFeature(DeviceFeature::RuntimeDescriptorArray,
                 static_cast<bool>(descriptorIndexingFeatures.runtimeDescriptorArray));
         }
+
+        // Store indirect drawing features
+        {
+            // core in 1.2 only through VkPhysicalDeviceVulkan12Features, which can't be chained next to the
+            // structs above, so it goes through the extension, which has no feature struct
+            storeFeature(DeviceFeature::DrawIndirectCount,
+                m_availableExtensions.contains(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME));
+        }
     }
 
     void PhysicalDevice::enumerateProperties(const Context& instance)
@@ -228,6 +238,10 @@ namespace Graphics {
             static_cast<PhysicalDeviceType>(baseProps.deviceType));
         storeProperty(DeviceProperty::PhysicalDeviceName,
             std::string(static_cast<const char*>(baseProps.deviceName)));
+        std::array<uint8_t, VK_UUID_SIZE> pipelineCacheUuid;
+        std::copy(std::begin(baseProps.pipelineCacheUUID), std::end(baseProps.pipelineCacheUUID),
+            pipelineCacheUuid.begin());
+        storeProperty(DeviceProperty::PipelineCacheUuid, pipelineCacheUuid);
 
         // Core Limits
         storeProperty(DeviceProperty::MaxImageDimension2d,
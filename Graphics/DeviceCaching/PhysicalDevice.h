@@ -40,9 +40,9 @@ namespace Graphics {
 		PhysicalDevice(const Context& instance, vk::PhysicalDevice device) :
 			m_physicalDevice(device)
 		{
+			enumerateExtensions(instance);
 			enumerateFeatures(instance);
 			enumerateProperties(instance);
-			enumerateExtensions(instance);
 			enumerateQueueFamilies(instance);
 		}
 
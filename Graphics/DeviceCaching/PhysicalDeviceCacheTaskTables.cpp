@@ -138,6 +138,14 @@ namespace Graphics {
                     vk::StructureType::ePhysicalDeviceShaderFloat16Int8Features));
             vkStorageSpecific.shaderInt8 = std::any_cast<bool>(required);
         },
+        //TimelineSemaphore,    // Requires VkPhysicalDeviceTimelineSemaphoreFeatures
+            [](vk::PhysicalDeviceFeatures2& vkStorage, const std::any& required)
+        {
+            auto& vkStorageSpecific = *static_cast<vk::PhysicalDeviceTimelineSemaphoreFeatures*>
+                (getRequiredVkStorage(vkStorage,
+                    vk::StructureType::ePhysicalDeviceTimelineSemaphoreFeatures));
+            vkStorageSpecific.timelineSemaphore = std::any_cast<bool>(required);
+        },
 
         //// Bindless Texture Features (Vulkan 1.2 - Descriptor Indexing)
         //DescriptorBindingPartiallyBound,         // Allow partially bound descriptor arrays
@@ -206,6 +214,12 @@ namespace Graphics {
                     vk::StructureType::ePhysicalDeviceDescriptorIndexingFeatures));
             vkStorageSpecific.runtimeDescriptorArray = std::any_cast<bool>(required);
         },
+
+        //// Indirect Drawing Features
+        //DrawIndirectCount,    // Requires VK_KHR_draw_indirect_count, enabled by the Device constructor
+            [](vk::PhysicalDeviceFeatures2& vkStorage, const std::any& required)
+        {
+        },
     };
 
     const std::array<PhysicalDeviceCache::TaskTableSignature,
@@ -264,6 +278,10 @@ namespace Graphics {
         { return std::any_cast<bool>(required) == std::any_cast<bool>(available); },
             [](const std::any& required, const std::any& available)
         { return std::any_cast<bool>(required) == std::any_cast<bool>(available); },
+            [](const std::any& required, const std::any& available)
+        { return std::any_cast<bool>(required) == std::any_cast<bool>(available); },
+            [](const std::any& required, const std::any& available)
+        { return std::any_cast<bool>(required) == std::any_cast<bool>(available); },
     };
 
 
@@ -288,6 +306,9 @@ namespace Graphics {
             [](const std::any& required, const std::any& available) //PhysicalDeviceName
         { return std::any_cast<const std::string&>(required) ==
         std::any_cast<const std::string&>(available); },
+            [](const std::any& required, const std::any& available) //PipelineCacheUuid
+        { return std::any_cast<const std::array<uint8_t, VK_UUID_SIZE>&>(required) ==
+        std::any_cast<const std::array<uint8_t, VK_UUID_SIZE>&>(available); },
 
             [](const std::any& required, const std::any& available) //MaxImageDimension2d
         { return std::any_cast<const uint32_t&>(required) <=
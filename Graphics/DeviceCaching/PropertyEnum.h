@@ -10,6 +10,7 @@ namespace Graphics {
         PhysicalDeviceId,                         // expects std::any containing uint32_t
         PhysicalDeviceType,                       // expects std::any containing PhysicalDeviceType
         PhysicalDeviceName,                       // expects std::any containing std::string
+        PipelineCacheUuid,                        // expects std::any containing std::array<uint8_t, VK_UUID_SIZE>
 
         // Core Limits
         MaxImageDimension2d,                     // expects std::any containing uint32_t
@@ -73,6 +74,7 @@ namespace Graphics {
     template<> struct DevicePropertyTypeTrait<DeviceProperty::PhysicalDeviceId> { using Type = uint32_t; };
     template<> struct DevicePropertyTypeTrait<DeviceProperty::PhysicalDeviceType> { using Type = PhysicalDeviceType; };
     template<> struct DevicePropertyTypeTrait<DeviceProperty::PhysicalDeviceName> { using Type = std::string; };
+    template<> struct DevicePropertyTypeTrait<DeviceProperty::PipelineCacheUuid> { using Type = std::array<uint8_t, VK_UUID_SIZE>; };
 
     // Core Limits
     template<> struct DevicePropertyTypeTrait<DeviceProperty::MaxImageDimension2d> { using Type = uint32_t; };
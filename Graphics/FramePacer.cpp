@@ -0,0 +1,63 @@
+#include "FramePacer.h"
+
+FramePacer::FramePacer(double targetFrameRate /*= 0.0*/, size_t sampleCount /*= 128*/) :
+    m_latencies("Latencies", sampleCount), m_frameTimes("FrameTimes", sampleCount)
+{
+    setTargetFrameRate(targetFrameRate);
+}
+
+void FramePacer::setTargetFrameRate(double targetFrameRate)
+{
+    if (targetFrameRate <= 0.0) {
+        setTargetFrameTime(Clock::duration::zero());
+        return;
+    }
+
+    setTargetFrameTime(std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(1.0 / targetFrameRate)));
+}
+
+void FramePacer::setTargetFrameTime(Clock::duration targetFrameTime)
+{
+    m_targetFrameTime = targetFrameTime;
+    m_nextFrame = Clock::now();
+}
+
+void FramePacer::beginFrame()
+{
+    if (isLimiting()) {
+        waitUntil(m_nextFrame);
+
+        // deadlines advance by whole frames so the pace doesn't drift,
+        // but after a hitch they restart from now instead of letting several frames through at once
+        m_nextFrame += m_targetFrameTime;
+        auto now = Clock::now();
+        if (m_nextFrame < now)
+            m_nextFrame = now + m_targetFrameTime;
+    }
+
+    auto now = Clock::now();
+    if (m_frameStarted)
+        m_frameTimes.addSample(std::chrono::duration<float>(now - m_frameStart).count());
+    m_frameStart = now;
+    m_frameStarted = true;
+}
+
+void FramePacer::presented()
+{
+    if (!m_frameStarted)
+        return;
+
+    m_lastLatency = std::chrono::duration<float>(Clock::now() - m_frameStart).count();
+    m_latencies.addSample(m_lastLatency);
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline) const
+{
+    auto now = Clock::now();
+    if (deadline - now > spinThreshold)
+        std::this_thread::sleep_for(deadline - now - spinThreshold);
+
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
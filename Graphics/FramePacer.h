@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <thread>
+
+#include "Utilities/SampleTracker.h"
+
+// optional cpu side frame limiter and cpu to present latency tracking
+// beginFrame() goes right before polling input and presented() right after the present call,
+// the time between them is how old the input is by the time the frame is handed to the presentation engine,
+// the actual scanout can come later depending on the present mode and image count
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // the limiter sleeps until this close to the deadline and spins the rest,
+    // sleep granularity on windows is too coarse to hit a frame time with sleeping alone
+    static constexpr std::chrono::microseconds spinThreshold = std::chrono::microseconds(1500);
+
+private:
+    Clock::duration m_targetFrameTime = Clock::duration::zero();
+    Clock::time_point m_nextFrame;
+    Clock::time_point m_frameStart;
+    bool m_frameStarted = false;
+
+    // in seconds, same as FrameRateCalculator
+    Utils::SampleTracker<float> m_latencies;
+    Utils::SampleTracker<float> m_frameTimes;
+    float m_lastLatency = 0.f;
+
+public:
+    // a target frame rate of 0 disables the limiter
+    FramePacer(double targetFrameRate = 0.0, size_t sampleCount = 128);
+
+    void setTargetFrameRate(double targetFrameRate);
+    void setTargetFrameTime(Clock::duration targetFrameTime);
+
+    // sleeps until the next frame is due if the limiter is on, then starts timing the frame
+    void beginFrame();
+
+    // records the latency of the frame started by the last beginFrame()
+    void presented();
+
+    Clock::duration getTargetFrameTime() const { return m_targetFrameTime; };
+    bool isLimiting() const { return m_targetFrameTime > Clock::duration::zero(); };
+
+    float getLatency() const { return m_lastLatency; };
+    float getAverageLatency() const { return m_latencies.getAverage(); };
+    float getPeakLatency() const { return m_latencies.getPeak(); };
+    float getAverageFrameTime() const { return m_frameTimes.getAverage(); };
+
+private:
+    void waitUntil(Clock::time_point deadline) const;
+};
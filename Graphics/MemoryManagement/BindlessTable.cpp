@@ -0,0 +1,163 @@
+#include "BindlessTable.h"
+
+namespace Graphics {
+
+    BindlessTable::BindlessTable(const Context& instance, const Device& device,
+        vk::DescriptorSet set, uint32_t binding, uint32_t capacity, uint32_t framesInFlight,
+        const Image& placeholder, const Sampler& sampler,
+        vk::DescriptorType type /*= vk::DescriptorType::eCombinedImageSampler*/) :
+        m_set(set), m_binding(binding), m_type(type), m_framesInFlight(framesInFlight)
+    {
+        m_placeholder.imageLayout = placeholder.getLayout();
+        m_placeholder.imageView = placeholder.getView();
+        m_placeholder.sampler = sampler.getSampler();
+
+        m_infos.resize(capacity, m_placeholder);
+        m_isDirty.resize(capacity, false);
+        m_isAllocated.resize(capacity, false);
+        m_isPublished.resize(capacity, false);
+
+        m_freeSlots.reserve(capacity);
+        for (Slot slot = capacity; slot > 0; slot--)
+            m_freeSlots.push_back(slot - 1);
+
+        // the only full write the table ever does
+        if (capacity != 0) {
+            vk::WriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = vk::StructureType::eWriteDescriptorSet;
+            descriptorWrite.dstSet = m_set;
+            descriptorWrite.dstBinding = m_binding;
+            descriptorWrite.dstArrayElement = 0;
+            descriptorWrite.descriptorType = m_type;
+            descriptorWrite.descriptorCount = capacity;
+            descriptorWrite.pImageInfo = m_infos.data();
+
+            device.getDevice().updateDescriptorSets(1, &descriptorWrite, 0, nullptr, instance.getDispatchLoader());
+        }
+
+        m_initialized = true;
+    }
+
+    void BindlessTable::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        for (auto& retiring : m_retiring)
+            if (retiring.onRetire)
+                retiring.onRetire();
+        m_retiring.clear();
+
+        m_infos.clear();
+        m_freeSlots.clear();
+        m_dirty.clear();
+        m_isDirty.clear();
+        m_isAllocated.clear();
+        m_isPublished.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed BindlessTable" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    BindlessTable::Slot BindlessTable::allocate()
+    {
+        assert(m_initialized && "BindlessTable::allocate() - BindlessTable is not initialized");
+
+        if (m_freeSlots.empty())
+            return invalidSlot;
+
+        Slot slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_isAllocated[slot] = true;
+        return slot;
+    }
+
+    void BindlessTable::set(Slot slot, const Image& image, const Sampler& sampler)
+    {
+        assert(slot < m_infos.size() && "BindlessTable::set() - Slot out of range");
+        assert(m_isAllocated[slot] && "BindlessTable::set() - Slot is not allocated");
+        assert(!m_isPublished[slot] && "BindlessTable::set() - Slot may be read by pending frames, free it and allocate a new one");
+
+        m_infos[slot].imageLayout = image.getLayout();
+        m_infos[slot].imageView = image.getView();
+        m_infos[slot].sampler = sampler.getSampler();
+        markDirty(slot);
+    }
+
+    void BindlessTable::free(Slot slot, RetireFunc onRetire /*= {}*/)
+    {
+        assert(slot < m_infos.size() && "BindlessTable::free() - Slot out of range");
+        assert(m_isAllocated[slot] && "BindlessTable::free() - Slot is not allocated, double free?");
+
+        m_isAllocated[slot] = false;
+        m_retiring.push_back({ slot, m_frame, std::move(onRetire) });
+    }
+
+    void BindlessTable::update(const Context& instance, const Device& device)
+    {
+        assert(m_initialized && "BindlessTable::update() - BindlessTable is not initialized");
+
+        // frees are queued in frame order, so the retired ones are always at the front
+        while (!m_retiring.empty() && m_retiring.front().frame + m_framesInFlight <= m_frame) {
+            RetiringSlot& retiring = m_retiring.front();
+            if (retiring.onRetire)
+                retiring.onRetire();
+
+            // point it back at the placeholder so no stale view is left in the array
+            m_infos[retiring.slot] = m_placeholder;
+            m_isPublished[retiring.slot] = false;
+            markDirty(retiring.slot);
+
+            auto position = std::upper_bound(m_freeSlots.begin(), m_freeSlots.end(),
+                retiring.slot, std::greater<Slot>());
+            m_freeSlots.insert(position, retiring.slot);
+            m_retiring.pop_front();
+        }
+        m_frame++;
+
+        if (m_dirty.empty())
+            return;
+
+        std::sort(m_dirty.begin(), m_dirty.end());
+
+        std::vector<vk::WriteDescriptorSet> writes;
+        for (size_t i = 0; i < m_dirty.size();) {
+            size_t end = i + 1;
+            while (end < m_dirty.size() && m_dirty[end] == m_dirty[end - 1] + 1)
+                end++;
+
+            vk::WriteDescriptorSet descriptorWrite{};
+            descriptorWrite.sType = vk::StructureType::eWriteDescriptorSet;
+            descriptorWrite.dstSet = m_set;
+            descriptorWrite.dstBinding = m_binding;
+            descriptorWrite.dstArrayElement = m_dirty[i];
+            descriptorWrite.descriptorType = m_type;
+            descriptorWrite.descriptorCount = static_cast<uint32_t>(end - i);
+            descriptorWrite.pImageInfo = &m_infos[m_dirty[i]];
+            writes.push_back(descriptorWrite);
+
+            i = end;
+        }
+
+        device.getDevice().updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(),
+            0, nullptr, instance.getDispatchLoader());
+
+        for (Slot slot : m_dirty) {
+            m_isDirty[slot] = false;
+            if (m_isAllocated[slot])
+                m_isPublished[slot] = true;
+        }
+        m_dirty.clear();
+    }
+
+    void BindlessTable::markDirty(Slot slot)
+    {
+        if (m_isDirty[slot])
+            return;
+        m_isDirty[slot] = true;
+        m_dirty.push_back(slot);
+    }
+
+}
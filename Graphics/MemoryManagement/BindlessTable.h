@@ -0,0 +1,143 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/Sampler.h"
+#include "Image.h"
+
+#include <deque>
+
+namespace Graphics {
+
+    // slot allocator on top of a bindless image array (see BindlessImageSamplerDefinition)
+    // set() only stages the descriptor, update() writes the changed slots as contiguous
+    // dstArrayElement ranges in a single call instead of rewriting the whole array
+    // a freed slot may still be read by frames in flight, so it is only handed out again
+    // framesInFlight update() calls later, that is also when its retire callback runs
+    // update() is meant to be called once per frame from the render thread, after the frame's wait
+    // it writes while earlier frames may still be pending, so the binding needs the update after bind and
+    // update unused while pending flags (BindlessImageSamplerDefinition has both, the device needs the
+    // DescriptorBindingSampledImageUpdateAfterBind and DescriptorBindingUpdateUnusedWhilePending features)
+    // that only covers slots no pending frame uses, so a slot is set once after allocate and never again,
+    // to change what it points to free it and allocate a new one
+    class BindlessTable
+    {
+    public:
+        using Slot = uint32_t;
+        using RetireFunc = std::function<void()>;
+
+        static constexpr Slot invalidSlot = std::numeric_limits<Slot>::max();
+
+    private:
+        struct RetiringSlot
+        {
+            Slot slot;
+            uint64_t frame;
+            RetireFunc onRetire;
+        };
+
+        vk::DescriptorSet m_set = nullptr;
+        uint32_t m_binding = 0;
+        vk::DescriptorType m_type = vk::DescriptorType::eCombinedImageSampler;
+        uint32_t m_framesInFlight = 0;
+
+        std::vector<vk::DescriptorImageInfo> m_infos;
+        vk::DescriptorImageInfo m_placeholder{};
+
+        // kept sorted high to low so the lowest slot is popped first and the used range stays dense
+        std::vector<Slot> m_freeSlots;
+        std::deque<RetiringSlot> m_retiring;
+        std::vector<Slot> m_dirty;
+        std::vector<bool> m_isDirty;
+        std::vector<bool> m_isAllocated;
+        // written by an update() since it was allocated, frames may read it from then on
+        std::vector<bool> m_isPublished;
+
+        uint64_t m_frame = 0;
+
+        bool m_initialized = false;
+    public:
+
+        BindlessTable() {};
+
+        // every slot starts out as the placeholder, which also stands in for freed slots once they retire
+        // all capacity descriptors are written up front, so a variable count set has to be allocated with at least capacity
+        BindlessTable(const Context& instance, const Device& device,
+            vk::DescriptorSet set, uint32_t binding, uint32_t capacity, uint32_t framesInFlight,
+            const Image& placeholder, const Sampler& sampler,
+            vk::DescriptorType type = vk::DescriptorType::eCombinedImageSampler);
+
+        BindlessTable(BindlessTable&& other) noexcept {
+            m_set = std::exchange(other.m_set, nullptr);
+            m_binding = std::exchange(other.m_binding, 0);
+            m_type = std::exchange(other.m_type, vk::DescriptorType::eCombinedImageSampler);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_infos = std::exchange(other.m_infos, {});
+            m_placeholder = std::exchange(other.m_placeholder, {});
+            m_freeSlots = std::exchange(other.m_freeSlots, {});
+            m_retiring = std::exchange(other.m_retiring, {});
+            m_dirty = std::exchange(other.m_dirty, {});
+            m_isDirty = std::exchange(other.m_isDirty, {});
+            m_isAllocated = std::exchange(other.m_isAllocated, {});
+            m_isPublished = std::exchange(other.m_isPublished, {});
+            m_frame = std::exchange(other.m_frame, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized table is undefined behavior, destroy before moving
+        BindlessTable& operator=(BindlessTable&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "BindlessTable::operator=() - BindlessTable already initialized");
+
+            m_set = std::exchange(other.m_set, nullptr);
+            m_binding = std::exchange(other.m_binding, 0);
+            m_type = std::exchange(other.m_type, vk::DescriptorType::eCombinedImageSampler);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_infos = std::exchange(other.m_infos, {});
+            m_placeholder = std::exchange(other.m_placeholder, {});
+            m_freeSlots = std::exchange(other.m_freeSlots, {});
+            m_retiring = std::exchange(other.m_retiring, {});
+            m_dirty = std::exchange(other.m_dirty, {});
+            m_isDirty = std::exchange(other.m_isDirty, {});
+            m_isAllocated = std::exchange(other.m_isAllocated, {});
+            m_isPublished = std::exchange(other.m_isPublished, {});
+            m_frame = std::exchange(other.m_frame, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        BindlessTable(const BindlessTable&) noexcept = delete;
+        BindlessTable& operator=(const BindlessTable&) noexcept = delete;
+
+        ~BindlessTable() { assert(!m_initialized && "BindlessTable was not destroyed!"); };
+
+        // runs the retire callbacks of every freed slot, the gpu must be idle
+        void destroy(const Context& instance, const Device& device);
+
+        // returns invalidSlot when the table is full
+        Slot allocate();
+
+        // stages the descriptor for a freshly allocated slot, written on the next update()
+        // can be called again until that update(), after it the slot may be in use by pending frames
+        void set(Slot slot, const Image& image, const Sampler& sampler);
+
+        // the slot and whatever it points to stay untouched until every frame that could read it has retired,
+        // onRetire is the place to destroy the image
+        void free(Slot slot, RetireFunc onRetire = {});
+
+        // recycles retired slots and writes every changed range
+        void update(const Context& instance, const Device& device);
+
+        uint32_t getCapacity() const { return static_cast<uint32_t>(m_infos.size()); };
+        size_t getFreeCount() const { return m_freeSlots.size(); };
+        size_t getRetiringCount() const { return m_retiring.size(); };
+
+    private:
+        void markDirty(Slot slot);
+    };
+
+}
@@ -0,0 +1,213 @@
+#include "DescriptorAllocator.h"
+
+namespace Graphics {
+
+    void DescriptorSetRef::write(const Context& instance, const Device& device,
+        const Buffer& buffer, uint32_t binding,
+        size_t offset, size_t range) const
+    {
+        vk::DescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = buffer.getBuffer();
+        bufferInfo.offset = offset;
+        bufferInfo.range = range;
+
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = vk::StructureType::eWriteDescriptorSet;
+        descriptorWrite.dstSet = m_set;
+        descriptorWrite.dstBinding = binding;
+        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.descriptorType = getBinding(binding).descriptorType;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.pBufferInfo = &bufferInfo;
+
+        device.getDevice().updateDescriptorSets(1, &descriptorWrite, 0, nullptr, instance.getDispatchLoader());
+    }
+
+    void DescriptorSetRef::write(const Context& instance, const Device& device,
+        const Image& image, const Sampler& sampler, uint32_t binding,
+        uint32_t arrayElement /*= 0*/, uint32_t count /*= 1*/) const
+    {
+        vk::DescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = image.getLayout();
+        imageInfo.imageView = image.getView();
+        imageInfo.sampler = sampler.getSampler();
+        std::vector<vk::DescriptorImageInfo> imageInfos(count, imageInfo);
+
+        const auto& layoutBinding = getBinding(binding);
+        if (arrayElement + count > layoutBinding.descriptorCount)
+            throw std::runtime_error("array element out of range");
+
+        vk::WriteDescriptorSet descriptorWrite{};
+        descriptorWrite.sType = vk::StructureType::eWriteDescriptorSet;
+        descriptorWrite.dstSet = m_set;
+        descriptorWrite.dstBinding = binding;
+        descriptorWrite.dstArrayElement = arrayElement;
+        descriptorWrite.descriptorType = layoutBinding.descriptorType;
+        descriptorWrite.descriptorCount = count;
+        descriptorWrite.pImageInfo = imageInfos.data();
+
+        device.getDevice().updateDescriptorSets(1, &descriptorWrite, 0, nullptr, instance.getDispatchLoader());
+    }
+
+    const vk::DescriptorSetLayoutBinding& DescriptorSetRef::getBinding(uint32_t binding) const
+    {
+        // layouts have a handful of bindings, a linear search beats keeping a map per set
+        const auto& layoutInfo = m_layout->getLayoutInfo();
+        for (uint32_t i = 0; i < layoutInfo.bindingCount; i++)
+            if (layoutInfo.pBindings[i].binding == binding)
+                return layoutInfo.pBindings[i];
+
+        throw std::runtime_error("invalid binding");
+    }
+
+    DescriptorAllocator::DescriptorAllocator(const Context& instance, const Device& device,
+        const std::vector<DescriptorPool::Size>& ratios, uint32_t framesInFlight,
+        uint32_t setsPerPool /*= 64*/, uint32_t maxSetsPerPool /*= 4096*/,
+        DescriptorPoolCreateFlags::Flags flags /*= DescriptorPoolCreateFlags::Bits::None*/) :
+        m_flags(flags), m_setsPerPool(std::max(1u, setsPerPool)),
+        m_maxSetsPerPool(std::max(m_setsPerPool, maxSetsPerPool))
+    {
+        for (const auto& ratio : ratios)
+            m_ratios.push_back(ratio);
+
+        m_frames.resize(framesInFlight);
+        m_initialized = true;
+    }
+
+    void DescriptorAllocator::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        auto destroyPool = [&](vk::DescriptorPool pool) {
+            if (pool)
+                device.getDevice().destroyDescriptorPool(pool, nullptr, instance.getDispatchLoader());
+            };
+
+        auto destroyChain = [&](PoolChain& chain) {
+            destroyPool(chain.current);
+            for (auto pool : chain.full)
+                destroyPool(pool);
+            chain = {};
+            };
+
+        destroyChain(m_persistent);
+        for (auto& frame : m_frames)
+            destroyChain(frame);
+        for (auto pool : m_freePools)
+            destroyPool(pool);
+
+        m_frames.clear();
+        m_freePools.clear();
+        m_poolCount = 0;
+
+#ifdef _DEBUG
+        std::cout << "Destroyed DescriptorAllocator" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    DescriptorSetRef DescriptorAllocator::allocate(const Context& instance, const Device& device,
+        const DescriptorSetLayout& layout, uint32_t variableCount /*= 0*/)
+    {
+        assert(m_initialized && "DescriptorAllocator::allocate() - DescriptorAllocator is not initialized");
+        return allocateFrom(instance, device, m_persistent, layout, variableCount);
+    }
+
+    DescriptorSetRef DescriptorAllocator::allocateTransient(const Context& instance, const Device& device,
+        uint32_t frameIndex, const DescriptorSetLayout& layout, uint32_t variableCount /*= 0*/)
+    {
+        assert(m_initialized && "DescriptorAllocator::allocateTransient() - DescriptorAllocator is not initialized");
+        return allocateFrom(instance, device, m_frames[frameIndex], layout, variableCount);
+    }
+
+    void DescriptorAllocator::resetFrame(const Context& instance, const Device& device, uint32_t frameIndex)
+    {
+        assert(m_initialized && "DescriptorAllocator::resetFrame() - DescriptorAllocator is not initialized");
+
+        PoolChain& chain = m_frames[frameIndex];
+        if (chain.current)
+            chain.full.push_back(chain.current);
+
+        for (auto pool : chain.full) {
+            device.getDevice().resetDescriptorPool(pool, {}, instance.getDispatchLoader());
+            m_freePools.push_back(pool);
+        }
+        chain = {};
+    }
+
+    DescriptorSetRef DescriptorAllocator::allocateFrom(const Context& instance, const Device& device, PoolChain& chain,
+        const DescriptorSetLayout& layout, uint32_t variableCount)
+    {
+        vk::DescriptorSetLayout layoutRaw = layout.getLayout();
+
+        vk::DescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo{};
+        variableCountInfo.sType = vk::StructureType::eDescriptorSetVariableDescriptorCountAllocateInfo;
+        variableCountInfo.descriptorSetCount = 1;
+        variableCountInfo.pDescriptorCounts = &variableCount;
+
+        vk::DescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = vk::StructureType::eDescriptorSetAllocateInfo;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &layoutRaw;
+        allocInfo.pNext = variableCount != 0 ? &variableCountInfo : nullptr;
+
+        // one retry with a fresh pool, a set that doesn't fit an empty pool never will
+        for (int attempt = 0; attempt < 2; attempt++) {
+            if (!chain.current)
+                chain.current = acquirePool(instance, device);
+
+            allocInfo.descriptorPool = chain.current;
+
+            // raw call so a full pool comes back as a result instead of an exception
+            vk::DescriptorSet set;
+            vk::Result result = device.getDevice().allocateDescriptorSets(&allocInfo, &set, instance.getDispatchLoader());
+            if (result == vk::Result::eSuccess)
+                return DescriptorSetRef(set, layout);
+
+            if (result != vk::Result::eErrorOutOfPoolMemory && result != vk::Result::eErrorFragmentedPool)
+                throw std::runtime_error("failed to allocate descriptor set: " + vk::to_string(result));
+
+            chain.full.push_back(chain.current);
+            chain.current = nullptr;
+        }
+
+        throw std::runtime_error("failed to allocate descriptor set: layout does not fit in an empty pool");
+    }
+
+    vk::DescriptorPool DescriptorAllocator::acquirePool(const Context& instance, const Device& device)
+    {
+        if (!m_freePools.empty()) {
+            vk::DescriptorPool pool = m_freePools.back();
+            m_freePools.pop_back();
+            return pool;
+        }
+
+        std::vector<vk::DescriptorPoolSize> sizes = m_ratios;
+        for (auto& size : sizes)
+            size.descriptorCount *= m_setsPerPool;
+
+        vk::DescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = vk::StructureType::eDescriptorPoolCreateInfo;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(sizes.size());
+        poolInfo.pPoolSizes = sizes.data();
+        poolInfo.maxSets = m_setsPerPool;
+        poolInfo.flags = m_flags;
+
+        vk::DescriptorPool pool;
+        try {
+            pool = device.getDevice().createDescriptorPool(poolInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("Failed to create a DescriptorPool: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error creating a DescriptorPool: " + std::string(e.what()));
+        }
+
+        m_poolCount++;
+        m_setsPerPool = std::min(m_setsPerPool * 2, m_maxSetsPerPool);
+        return pool;
+    }
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/DescriptorSetLayout.h"
+#include "../Rendering/Sampler.h"
+#include "Buffer.h"
+#include "Image.h"
+#include "DescriptorPool.h"
+
+namespace Graphics {
+
+    // non owning view of a set handed out by a DescriptorAllocator, cheap to copy around
+    // the set stays valid until its frame is reset or the allocator is destroyed
+    class DescriptorSetRef
+    {
+    private:
+        vk::DescriptorSet m_set = nullptr;
+        const DescriptorSetLayout* m_layout = nullptr;
+
+    public:
+        DescriptorSetRef() {};
+        DescriptorSetRef(vk::DescriptorSet set, const DescriptorSetLayout& layout) :
+            m_set(set), m_layout(&layout) {};
+
+        void write(const Context& instance, const Device& device,
+            const Buffer& buffer, uint32_t binding,
+            size_t offset, size_t range) const;
+
+        void write(const Context& instance, const Device& device,
+            const Image& image, const Sampler& sampler, uint32_t binding,
+            uint32_t arrayElement = 0, uint32_t count = 1) const;
+
+        // throws if the layout has no such binding
+        const vk::DescriptorSetLayoutBinding& getBinding(uint32_t binding) const;
+
+        bool isValid() const { return m_set != vk::DescriptorSet(); };
+
+        vk::DescriptorSet getSet() const { return m_set; };
+        const DescriptorSetLayout& getLayout() const { return *m_layout; };
+    };
+
+    // hands out descriptor sets from a chain of pools that grows whenever the current pool runs dry
+    // persistent sets live as long as the allocator, transient sets go into per frame pools
+    // that are reset in one call once the gpu is done with that frame
+    // pools are sized from a per set ratio, each new pool holds twice the sets of the last one up to maxSetsPerPool
+    // not thread safe, use one allocator per recording thread
+    class DescriptorAllocator
+    {
+    private:
+        struct PoolChain
+        {
+            vk::DescriptorPool current = nullptr;
+            std::vector<vk::DescriptorPool> full;
+        };
+
+        std::vector<vk::DescriptorPoolSize> m_ratios;
+        DescriptorPoolCreateFlags::Flags m_flags = DescriptorPoolCreateFlags::Bits::None;
+        uint32_t m_setsPerPool = 0;
+        uint32_t m_maxSetsPerPool = 0;
+
+        PoolChain m_persistent;
+        std::vector<PoolChain> m_frames;
+
+        // reset pools waiting to be picked up by whichever chain fills up next
+        std::vector<vk::DescriptorPool> m_freePools;
+        size_t m_poolCount = 0;
+
+        bool m_initialized = false;
+    public:
+
+        DescriptorAllocator() {};
+
+        // ratios are descriptors per set of each type, setsPerPool is the size of the first pool
+        DescriptorAllocator(const Context& instance, const Device& device,
+            const std::vector<DescriptorPool::Size>& ratios, uint32_t framesInFlight,
+            uint32_t setsPerPool = 64, uint32_t maxSetsPerPool = 4096,
+            DescriptorPoolCreateFlags::Flags flags = DescriptorPoolCreateFlags::Bits::None);
+
+        DescriptorAllocator(DescriptorAllocator&& other) noexcept {
+            m_ratios = std::exchange(other.m_ratios, {});
+            m_flags = std::exchange(other.m_flags, DescriptorPoolCreateFlags::Bits::None);
+            m_setsPerPool = std::exchange(other.m_setsPerPool, 0);
+            m_maxSetsPerPool = std::exchange(other.m_maxSetsPerPool, 0);
+            m_persistent = std::exchange(other.m_persistent, {});
+            m_frames = std::exchange(other.m_frames, {});
+            m_freePools = std::exchange(other.m_freePools, {});
+            m_poolCount = std::exchange(other.m_poolCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized allocator is undefined behavior, destroy before moving
+        DescriptorAllocator& operator=(DescriptorAllocator&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "DescriptorAllocator::operator=() - DescriptorAllocator already initialized");
+
+            m_ratios = std::exchange(other.m_ratios, {});
+            m_flags = std::exchange(other.m_flags, DescriptorPoolCreateFlags::Bits::None);
+            m_setsPerPool = std::exchange(other.m_setsPerPool, 0);
+            m_maxSetsPerPool = std::exchange(other.m_maxSetsPerPool, 0);
+            m_persistent = std::exchange(other.m_persistent, {});
+            m_frames = std::exchange(other.m_frames, {});
+            m_freePools = std::exchange(other.m_freePools, {});
+            m_poolCount = std::exchange(other.m_poolCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        DescriptorAllocator(const DescriptorAllocator&) noexcept = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator&) noexcept = delete;
+
+        ~DescriptorAllocator() { assert(!m_initialized && "DescriptorAllocator was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        // variableCount is only used for layouts whose last binding has a variable descriptor count
+        DescriptorSetRef allocate(const Context& instance, const Device& device,
+            const DescriptorSetLayout& layout, uint32_t variableCount = 0);
+
+        // valid until resetFrame is called for the same frame index
+        DescriptorSetRef allocateTransient(const Context& instance, const Device& device,
+            uint32_t frameIndex, const DescriptorSetLayout& layout, uint32_t variableCount = 0);
+
+        // call once the gpu finished the frame, e.g. right after FrameScheduler::beginFrame returned it
+        void resetFrame(const Context& instance, const Device& device, uint32_t frameIndex);
+
+        size_t getPoolCount() const { return m_poolCount; };
+        uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_frames.size()); };
+
+    private:
+        DescriptorSetRef allocateFrom(const Context& instance, const Device& device, PoolChain& chain,
+            const DescriptorSetLayout& layout, uint32_t variableCount);
+        vk::DescriptorPool acquirePool(const Context& instance, const Device& device);
+    };
+
+}
@@ -45,6 +45,8 @@ namespace Graphics {
 
         DescriptorPool(DescriptorPool&& other) noexcept {
             m_pool = std::exchange(other.m_pool, nullptr);
+            m_allocatedSets = std::exchange(other.m_allocatedSets, {});
+            m_sizes = std::exchange(other.m_sizes, {});
             m_initialized = std::exchange(other.m_initialized, false);
         };
 
@@ -57,6 +59,8 @@ namespace Graphics {
             assert(!m_initialized && "DescriptorPool::operator=() - DescriptorPool already initialized");
 
             m_pool = std::exchange(other.m_pool, nullptr);
+            m_allocatedSets = std::exchange(other.m_allocatedSets, {});
+            m_sizes = std::exchange(other.m_sizes, {});
             m_initialized = std::exchange(other.m_initialized, false);
 
             return *this;
@@ -158,6 +162,19 @@ namespace Graphics {
             return setsWrapped;
         }
 
+        // returns every set to the pool, handles handed out before are invalidated
+        // the gpu must be done with all of them, for sets that churn every frame use a DescriptorAllocator
+        void reset(const Context& instance, const Device& device) {
+            device.getDevice().resetDescriptorPool(m_pool, {}, instance.getDispatchLoader());
+
+            for (auto& set : m_allocatedSets)
+            {
+                set->m_set = nullptr;
+                set->m_initialized = false;
+            }
+            m_allocatedSets.clear();
+        }
+
         //void freeBuffer(const Context& instance, const Device& device, CommandBufferHandle& buffer) {
 
         //    if (m_allocatedBuffers.find(buffer) == m_allocatedBuffers.end())
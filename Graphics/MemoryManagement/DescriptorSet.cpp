@@ -71,27 +71,31 @@ namespace Graphics {
     }
 
     void DescriptorSet::write(const Context& instance, const Device& device,
-        const Image& image, const Sampler& sampler, uint32_t binding)
+        const Image& image, const Sampler& sampler, uint32_t binding,
+        uint32_t arrayElement /*= 0*/, uint32_t count /*= 1*/)
     {
         vk::DescriptorImageInfo imageInfo{};
         imageInfo.imageLayout = image.getLayout();
         imageInfo.imageView = image.getView();
         imageInfo.sampler = sampler.getSampler();
+        std::vector<vk::DescriptorImageInfo> imageInfos(count, imageInfo);
 
         vk::WriteDescriptorSet descriptorWrite{};
         descriptorWrite.sType = vk::StructureType::eWriteDescriptorSet;
         descriptorWrite.dstSet = m_set;
         descriptorWrite.dstBinding = binding;
-        descriptorWrite.dstArrayElement = 0;
+        descriptorWrite.dstArrayElement = arrayElement;
 
         auto it = m_layout.find(binding);
         if (it == m_layout.end())
             throw std::runtime_error("invalid binding");
+        if (arrayElement + count > it->second.descriptorCount)
+            throw std::runtime_error("array element out of range");
 
         descriptorWrite.descriptorType = it->second.descriptorType;
-        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.descriptorCount = count;
 
-        descriptorWrite.pImageInfo = &imageInfo;
+        descriptorWrite.pImageInfo = imageInfos.data();
         descriptorWrite.pBufferInfo = nullptr;
         descriptorWrite.pTexelBufferView = nullptr;
 
@@ -128,4 +132,12 @@ namespace Graphics {
 
         device.getDevice().updateDescriptorSets(1, &descriptorWrite, 0, nullptr, instance.getDispatchLoader());
     }
+
+    const vk::DescriptorSetLayoutBinding& DescriptorSet::getBinding(uint32_t binding) const
+    {
+        auto it = m_layout.find(binding);
+        if (it == m_layout.end())
+            throw std::runtime_error("invalid binding");
+        return it->second;
+    }
 }
\ No newline at end of file
@@ -62,12 +62,17 @@ namespace Graphics {
             const std::vector<Buffer>& buffers, uint32_t binding,
             const std::vector<size_t>& offsets, const std::vector<size_t>& ranges);
 
+        // writes the same image into count consecutive array elements starting at arrayElement
         void write(const Context& instance, const Device& device,
-            const Image& image, const Sampler& sampler, uint32_t binding);
+            const Image& image, const Sampler& sampler, uint32_t binding,
+            uint32_t arrayElement = 0, uint32_t count = 1);
 
         void write(const Context& instance, const Device& device,
             const std::vector<Image>& images, const std::vector<const Sampler*>& samplers, uint32_t binding);
 
+        // throws if the layout has no such binding
+        const vk::DescriptorSetLayoutBinding& getBinding(uint32_t binding) const;
+
         vk::DescriptorSet getSet() const { return m_set; };
 
         friend class DescriptorPool;
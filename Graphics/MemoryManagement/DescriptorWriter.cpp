@@ -0,0 +1,89 @@
+#include "DescriptorWriter.h"
+
+namespace Graphics {
+
+    DescriptorWriter& DescriptorWriter::writeBuffer(vk::DescriptorSet set, vk::DescriptorType type, uint32_t binding,
+        const Buffer& buffer, size_t offset, size_t range, uint32_t arrayElement /*= 0*/)
+    {
+        vk::DescriptorBufferInfo bufferInfo{};
+        bufferInfo.buffer = buffer.getBuffer();
+        bufferInfo.offset = offset;
+        bufferInfo.range = range;
+
+        // consecutive elements of the same binding collapse into one write
+        if (!m_pending.empty()) {
+            PendingWrite& last = m_pending.back();
+            if (!last.isImage && last.set == set && last.binding == binding && last.type == type &&
+                last.arrayElement + last.count == arrayElement) {
+                m_bufferInfos.push_back(bufferInfo);
+                last.count++;
+                return *this;
+            }
+        }
+
+        m_pending.push_back({ set, binding, arrayElement, 1, type, m_bufferInfos.size(), false });
+        m_bufferInfos.push_back(bufferInfo);
+        return *this;
+    }
+
+    DescriptorWriter& DescriptorWriter::writeImage(vk::DescriptorSet set, vk::DescriptorType type, uint32_t binding,
+        const Image& image, const Sampler& sampler, uint32_t arrayElement /*= 0*/)
+    {
+        vk::DescriptorImageInfo imageInfo{};
+        imageInfo.imageLayout = image.getLayout();
+        imageInfo.imageView = image.getView();
+        imageInfo.sampler = sampler.getSampler();
+
+        if (!m_pending.empty()) {
+            PendingWrite& last = m_pending.back();
+            if (last.isImage && last.set == set && last.binding == binding && last.type == type &&
+                last.arrayElement + last.count == arrayElement) {
+                m_imageInfos.push_back(imageInfo);
+                last.count++;
+                return *this;
+            }
+        }
+
+        m_pending.push_back({ set, binding, arrayElement, 1, type, m_imageInfos.size(), true });
+        m_imageInfos.push_back(imageInfo);
+        return *this;
+    }
+
+    void DescriptorWriter::flush(const Context& instance, const Device& device)
+    {
+        if (m_pending.empty())
+            return;
+
+        // info vectors may have reallocated while queueing, so pointers are only taken here
+        m_writes.clear();
+        m_writes.reserve(m_pending.size());
+        for (const auto& pending : m_pending) {
+            vk::WriteDescriptorSet write{};
+            write.sType = vk::StructureType::eWriteDescriptorSet;
+            write.dstSet = pending.set;
+            write.dstBinding = pending.binding;
+            write.dstArrayElement = pending.arrayElement;
+            write.descriptorType = pending.type;
+            write.descriptorCount = pending.count;
+            if (pending.isImage)
+                write.pImageInfo = &m_imageInfos[pending.infoIndex];
+            else
+                write.pBufferInfo = &m_bufferInfos[pending.infoIndex];
+            m_writes.push_back(write);
+        }
+
+        device.getDevice().updateDescriptorSets(static_cast<uint32_t>(m_writes.size()), m_writes.data(),
+            0, nullptr, instance.getDispatchLoader());
+
+        clear();
+    }
+
+    void DescriptorWriter::clear()
+    {
+        m_pending.clear();
+        m_bufferInfos.clear();
+        m_imageInfos.clear();
+        m_writes.clear();
+    }
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/Sampler.h"
+#include "Buffer.h"
+#include "Image.h"
+#include "DescriptorSet.h"
+#include "DescriptorAllocator.h"
+
+namespace Graphics {
+
+    // collects descriptor writes for any number of sets and submits them with a single updateDescriptorSets
+    // the descriptor type is resolved when the write is queued, flush only patches pointers and makes the call
+    // storage is kept between flushes so a writer reused every frame stops allocating after the first one
+    class DescriptorWriter
+    {
+    private:
+        struct PendingWrite
+        {
+            vk::DescriptorSet set;
+            uint32_t binding;
+            uint32_t arrayElement;
+            uint32_t count;
+            vk::DescriptorType type;
+            size_t infoIndex; // first element in m_bufferInfos or m_imageInfos depending on type
+            bool isImage;
+        };
+
+        std::vector<PendingWrite> m_pending;
+        std::vector<vk::DescriptorBufferInfo> m_bufferInfos;
+        std::vector<vk::DescriptorImageInfo> m_imageInfos;
+        std::vector<vk::WriteDescriptorSet> m_writes;
+
+    public:
+        DescriptorWriter() {};
+
+        DescriptorWriter(DescriptorWriter&&) noexcept = default;
+        DescriptorWriter& operator=(DescriptorWriter&&) noexcept = default;
+
+        DescriptorWriter(const DescriptorWriter&) noexcept = delete;
+        DescriptorWriter& operator=(const DescriptorWriter&) noexcept = delete;
+
+        DescriptorWriter& writeBuffer(vk::DescriptorSet set, vk::DescriptorType type, uint32_t binding,
+            const Buffer& buffer, size_t offset, size_t range, uint32_t arrayElement = 0);
+
+        DescriptorWriter& writeBuffer(const DescriptorSetRef& set, uint32_t binding,
+            const Buffer& buffer, size_t offset, size_t range, uint32_t arrayElement = 0) {
+            return writeBuffer(set.getSet(), set.getBinding(binding).descriptorType,
+                binding, buffer, offset, range, arrayElement);
+        };
+
+        DescriptorWriter& writeBuffer(const DescriptorSet& set, uint32_t binding,
+            const Buffer& buffer, size_t offset, size_t range, uint32_t arrayElement = 0) {
+            return writeBuffer(set.getSet(), set.getBinding(binding).descriptorType,
+                binding, buffer, offset, range, arrayElement);
+        };
+
+        DescriptorWriter& writeImage(vk::DescriptorSet set, vk::DescriptorType type, uint32_t binding,
+            const Image& image, const Sampler& sampler, uint32_t arrayElement = 0);
+
+        DescriptorWriter& writeImage(const DescriptorSetRef& set, uint32_t binding,
+            const Image& image, const Sampler& sampler, uint32_t arrayElement = 0) {
+            return writeImage(set.getSet(), set.getBinding(binding).descriptorType,
+                binding, image, sampler, arrayElement);
+        };
+
+        DescriptorWriter& writeImage(const DescriptorSet& set, uint32_t binding,
+            const Image& image, const Sampler& sampler, uint32_t arrayElement = 0) {
+            return writeImage(set.getSet(), set.getBinding(binding).descriptorType,
+                binding, image, sampler, arrayElement);
+        };
+
+        // submits everything queued since the last flush in one call
+        void flush(const Context& instance, const Device& device);
+
+        // drops queued writes without submitting them
+        void clear();
+
+        size_t size() const { return m_pending.size(); };
+        bool empty() const { return m_pending.empty(); };
+    };
+
+}
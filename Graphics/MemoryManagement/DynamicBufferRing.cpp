@@ -0,0 +1,79 @@
+#include "DynamicBufferRing.h"
+
+namespace Graphics {
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    DynamicBufferRing::DynamicBufferRing(const Context& instance, const Device& device, DescriptorType type,
+        size_t bytesPerFrame, uint32_t framesInFlight, size_t blockRange) :
+        m_type(type), m_framesInFlight(framesInFlight)
+    {
+        const auto& physicalDevice = device.getPhysicalDevice();
+
+        BufferUsage::Flags usage = BufferUsage::Bits::Uniform;
+        size_t offsetAlignment = 0;
+        size_t maxRange = 0;
+        if (type == DescriptorType::UniformBufferDynamic) {
+            offsetAlignment = physicalDevice.getProperty<DeviceProperty::MinUniformBufferOffsetAlignment>();
+            maxRange = physicalDevice.getProperty<DeviceProperty::MaxUniformBufferRange>();
+        }
+        else if (type == DescriptorType::StorageBufferDynamic) {
+            usage = BufferUsage::Bits::Storage;
+            offsetAlignment = physicalDevice.getProperty<DeviceProperty::MinStorageBufferOffsetAlignment>();
+            maxRange = physicalDevice.getProperty<DeviceProperty::MaxStorageBufferRange>();
+        }
+        else
+            throw std::runtime_error("DynamicBufferRing::DynamicBufferRing() - Type has to be a dynamic buffer descriptor");
+
+        if (blockRange == 0 || blockRange > maxRange)
+            throw std::runtime_error("DynamicBufferRing::DynamicBufferRing() - Block range has to be between 1 and the device limit");
+
+        m_alignment = std::max<size_t>(offsetAlignment, 1);
+        m_regionSize = alignUp(bytesPerFrame, m_alignment);
+
+        // slack past the last region, the descriptor reads blockRange bytes from the offset of any block
+        m_buffer = Buffer(instance, device, m_regionSize * framesInFlight + blockRange, usage);
+        const auto& memRequirements = m_buffer.getMemoryRequirements();
+
+        m_memory = MappedMemory(instance, device, memRequirements,
+            MemoryProperty::Bits::HostVisibleCoherent, memRequirements.size);
+        m_memory.bindBuffer(instance, device, m_buffer);
+
+        // mapped once, blocks are aligned to the descriptor offset alignment which can be finer than the memory one
+        m_mapping = m_memory.getMapping<uint8_t>(memRequirements.size);
+
+        m_blockRange = blockRange;
+        m_initialized = true;
+    }
+
+    void DynamicBufferRing::beginFrame(uint32_t frameIndex)
+    {
+        assert(m_initialized && "DynamicBufferRing::beginFrame() - DynamicBufferRing is not initialized");
+        assert(frameIndex < m_framesInFlight && "DynamicBufferRing::beginFrame() - Frame index out of range");
+
+        m_frameIndex = frameIndex;
+        m_head = frameIndex * m_regionSize;
+    }
+
+    DynamicBufferRing::Block DynamicBufferRing::allocate(size_t size)
+    {
+        assert(m_initialized && "DynamicBufferRing::allocate() - DynamicBufferRing is not initialized");
+
+        if (size == 0 || size > m_blockRange)
+            return Block();
+
+        size_t alignedSize = alignUp(size, m_alignment);
+        if (m_head + alignedSize > (m_frameIndex + 1) * m_regionSize)
+            return Block();
+
+        Block block;
+        block.dynamicOffset = static_cast<uint32_t>(m_head);
+        block.data = m_mapping.subspan(m_head, size);
+
+        m_head += alignedSize;
+        return block;
+    }
+
+}
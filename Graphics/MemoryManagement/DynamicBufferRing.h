@@ -0,0 +1,135 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Flags.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "Buffer.h"
+#include "MappedMemory.h"
+
+namespace Graphics {
+
+    // one persistently mapped uniform or storage buffer split into a region per frame in flight,
+    // per draw blocks are bump allocated out of the current frame's region and bound through
+    // bindDescriptorSets' dynamicOffsets, so every draw shares one descriptor set pointing at the buffer
+    // offsets are aligned to minUniformBufferOffsetAlignment (or the storage one), a region is reused
+    // once beginFrame is called for its index again, so only call it after the frame's wait
+    class DynamicBufferRing
+    {
+    public:
+        struct Block
+        {
+            uint32_t dynamicOffset = 0;
+            std::span<uint8_t> data;
+
+            bool isValid() const { return data.data() != nullptr; };
+        };
+
+    private:
+        Buffer m_buffer;
+        MappedMemory m_memory;
+        std::span<uint8_t> m_mapping;
+        DescriptorType m_type = DescriptorType::UniformBufferDynamic;
+
+        size_t m_alignment = 0;
+        size_t m_regionSize = 0;
+        size_t m_blockRange = 0;
+        uint32_t m_framesInFlight = 0;
+
+        uint32_t m_frameIndex = 0;
+        size_t m_head = 0;
+
+        bool m_initialized = false;
+    public:
+
+        DynamicBufferRing() {};
+
+        // type is UniformBufferDynamic or StorageBufferDynamic, blockRange is the descriptor range,
+        // the biggest block a single draw can read through the set
+        DynamicBufferRing(const Context& instance, const Device& device, DescriptorType type,
+            size_t bytesPerFrame, uint32_t framesInFlight, size_t blockRange);
+
+        DynamicBufferRing(DynamicBufferRing&& other) noexcept {
+            m_buffer = std::move(other.m_buffer);
+            m_memory = std::move(other.m_memory);
+            m_mapping = std::exchange(other.m_mapping, {});
+            m_type = std::exchange(other.m_type, DescriptorType::UniformBufferDynamic);
+            m_alignment = std::exchange(other.m_alignment, 0);
+            m_regionSize = std::exchange(other.m_regionSize, 0);
+            m_blockRange = std::exchange(other.m_blockRange, 0);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_frameIndex = std::exchange(other.m_frameIndex, 0);
+            m_head = std::exchange(other.m_head, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized ring is undefined behavior, destroy before moving
+        DynamicBufferRing& operator=(DynamicBufferRing&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "DynamicBufferRing::operator=() - DynamicBufferRing already initialized");
+
+            m_buffer = std::move(other.m_buffer);
+            m_memory = std::move(other.m_memory);
+            m_mapping = std::exchange(other.m_mapping, {});
+            m_type = std::exchange(other.m_type, DescriptorType::UniformBufferDynamic);
+            m_alignment = std::exchange(other.m_alignment, 0);
+            m_regionSize = std::exchange(other.m_regionSize, 0);
+            m_blockRange = std::exchange(other.m_blockRange, 0);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_frameIndex = std::exchange(other.m_frameIndex, 0);
+            m_head = std::exchange(other.m_head, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        DynamicBufferRing(const DynamicBufferRing&) noexcept = delete;
+        DynamicBufferRing& operator=(const DynamicBufferRing&) noexcept = delete;
+
+        ~DynamicBufferRing() { assert(!m_initialized && "DynamicBufferRing was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device) {
+            if (!m_initialized)
+                return;
+
+            m_buffer.destroy(instance, device);
+            m_memory.destroy(instance, device);
+#ifdef _DEBUG
+            std::cout << "Destroyed DynamicBufferRing" << std::endl;
+#endif
+            m_initialized = false;
+        }
+
+        // starts handing out blocks from the frame's region, everything allocated in it before is dropped
+        void beginFrame(uint32_t frameIndex);
+
+        // returns an invalid block when the frame's region is full or size exceeds the block range
+        Block allocate(size_t size);
+
+        // copies value into a fresh block and returns its dynamic offset
+        template<typename T>
+        std::optional<uint32_t> push(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "blocks are copied as raw bytes");
+
+            Block block = allocate(sizeof(T));
+            if (!block.isValid())
+                return std::nullopt;
+
+            std::memcpy(block.data.data(), &value, sizeof(T));
+            return block.dynamicOffset;
+        }
+
+        // write the dynamic descriptor once with this buffer, offset 0 and the block range
+        const Buffer& getBuffer() const { return m_buffer; };
+        size_t getBlockRange() const { return m_blockRange; };
+        DescriptorType getType() const { return m_type; };
+
+        size_t getAlignment() const { return m_alignment; };
+        size_t getRegionSize() const { return m_regionSize; };
+        size_t getUsed() const { return m_head - m_frameIndex * m_regionSize; };
+    };
+
+}
@@ -8,17 +8,45 @@ namespace Graphics {
     }
 
     void Image::load(const Context& instance, const Device& device, const std::string& filepath)
+    {
+        if (!decode(filepath)) {
+            throw std::runtime_error("failed to load texture image!");
+        }
+
+        create(instance, device);
+    }
+
+    bool Image::decode(const std::string& filepath)
     {
         int texWidth, texHeight, texChannels;
         m_pixels = stbi_load(filepath.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+
+        if (!m_pixels)
+            return false;
+
         m_width = static_cast<size_t>(texWidth);
         m_height = static_cast<size_t>(texHeight);
         m_bpp = static_cast<size_t>(texChannels);
         m_capacity = m_width * m_height * STBI_rgb_alpha;
 
-        if (!m_pixels) {
-            throw std::runtime_error("failed to load texture image!");
-        }
+        m_initialized = true;
+        return true;
+    }
+
+    void Image::create(const Context& instance, const Device& device, uint32_t mipLevels /*= 1*/)
+    {
+        assert(m_pixels && "Image::create() - Image has no decoded pixels");
+        create(instance, device, m_width, m_height, mipLevels);
+    }
+
+    void Image::create(const Context& instance, const Device& device,
+        size_t width, size_t height, uint32_t mipLevels /*= 1*/)
+    {
+        m_width = width;
+        m_height = height;
+        m_mipLevels = mipLevels;
+        if (!m_pixels)
+            m_capacity = m_width * m_height * STBI_rgb_alpha;
 
         vk::ImageCreateInfo imageInfo{};
         imageInfo.sType = vk::StructureType::eImageCreateInfo;
@@ -26,12 +54,14 @@ namespace Graphics {
         imageInfo.extent.width = m_width;
         imageInfo.extent.height = m_height;
         imageInfo.extent.depth = 1;
-        imageInfo.mipLevels = 1;
+        imageInfo.mipLevels = m_mipLevels;
         imageInfo.arrayLayers = 1;
         imageInfo.format = vk::Format::eR8G8B8A8Srgb;
         imageInfo.tiling = vk::ImageTiling::eOptimal;
         imageInfo.initialLayout = vk::ImageLayout::eUndefined;
         imageInfo.usage = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
+        if (m_mipLevels > 1) // lower mips are blitted from the level above
+            imageInfo.usage |= vk::ImageUsageFlagBits::eTransferSrc;
         imageInfo.sharingMode = vk::SharingMode::eExclusive;
         imageInfo.samples = vk::SampleCountFlagBits::e1;
         imageInfo.flags = vk::ImageCreateFlags(); // Optional
@@ -46,6 +76,7 @@ namespace Graphics {
         }
 
         m_imageMemoryRequirements = device.getDevice().getImageMemoryRequirements(m_image, instance.getDispatchLoader());
+        m_layout = vk::ImageLayout::eUndefined;
 
         m_initialized = true;
     }
@@ -63,7 +94,7 @@ namespace Graphics {
         createInfo.components.a = vk::ComponentSwizzle::eIdentity;
         createInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
         createInfo.subresourceRange.baseMipLevel = 0;
-        createInfo.subresourceRange.levelCount = 1;
+        createInfo.subresourceRange.levelCount = m_mipLevels;
         createInfo.subresourceRange.baseArrayLayer = 0;
         createInfo.subresourceRange.layerCount = 1;
 
@@ -3,6 +3,8 @@
 #include "../Rendering/Context.h"
 #include "../Rendering/Device.h"
 
+#include <bit>
+
 namespace Graphics {
 
     class CommandBuffer;
@@ -17,6 +19,7 @@ namespace Graphics {
         size_t m_height = 0;
         size_t m_bpp = 0;
         size_t m_capacity = 0; //image size in bytes
+        uint32_t m_mipLevels = 1;
 
         stbi_uc* m_pixels = nullptr;
 
@@ -37,6 +40,7 @@ namespace Graphics {
             m_height = std::exchange(other.m_height, 0);
             m_bpp = std::exchange(other.m_bpp, 0);
             m_capacity = std::exchange(other.m_capacity, 0);
+            m_mipLevels = std::exchange(other.m_mipLevels, 1);
             m_pixels = std::exchange(other.m_pixels, nullptr);
             m_image = std::exchange(other.m_image, vk::Image());
             m_view = std::exchange(other.m_view, vk::ImageView());
@@ -57,6 +61,7 @@ namespace Graphics {
             m_height = std::exchange(other.m_height, 0);
             m_bpp = std::exchange(other.m_bpp, 0);
             m_capacity = std::exchange(other.m_capacity, 0);
+            m_mipLevels = std::exchange(other.m_mipLevels, 1);
             m_pixels = std::exchange(other.m_pixels, nullptr);
             m_image = std::exchange(other.m_image, vk::Image());
             m_view = std::exchange(other.m_view, vk::ImageView());
@@ -75,11 +80,30 @@ namespace Graphics {
         void load(const Context& instance, const Device& device, const std::string& filepath);
         void createView(const Context& instance, const Device& device);
 
+        // cpu only half of load, safe to call from worker threads, returns false if the file couldn't be decoded
+        bool decode(const std::string& filepath);
+
+        // creates the vulkan image for decoded pixels, mip levels past the first are meant to be blitted
+        void create(const Context& instance, const Device& device, uint32_t mipLevels = 1);
+
+        // creates an image without pixel data, for things that are filled from somewhere else
+        void create(const Context& instance, const Device& device,
+            size_t width, size_t height, uint32_t mipLevels = 1);
+
+        // drops the cpu copy of the pixels once they are on the gpu
+        void freePixels() { stbi_image_free(m_pixels); m_pixels = nullptr; };
+
+        static uint32_t getFullMipLevels(size_t width, size_t height) {
+            return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+        }
+
         std::span<uint8_t> getPixelData() const { return  std::span<uint8_t>(m_pixels, m_capacity); };
         vk::Image getImage() const { return m_image; };
         size_t getCapacity() const { return m_capacity; };
         size_t getWidth() const { return m_width; };
         size_t getHeight() const { return m_height; };
+        uint32_t getMipLevels() const { return m_mipLevels; };
+        bool hasPixels() const { return m_pixels != nullptr; };
 
         void destroy(const Context& instance, const Device& device) {
             if (!m_initialized)
@@ -90,6 +114,7 @@ namespace Graphics {
             m_height = 0;
             m_bpp = 0;
             m_capacity = 0;
+            m_mipLevels = 1;
             m_pixels = nullptr;
 
             device.getDevice().destroyImageView(m_view, nullptr, instance.getDispatchLoader());
@@ -0,0 +1,58 @@
+#pragma once
+#include "../Common.h"
+
+#include <filesystem>
+#include <span>
+
+namespace Graphics {
+
+    // read only view of a whole file mapped into memory, pages are loaded by the os on first touch
+    // plain cpu resource, unmapped on destruction
+    class MappedFile
+    {
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+
+        // platform handles, kept opaque so the header doesn't pull in windows.h
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+
+    public:
+        MappedFile() {};
+        ~MappedFile() { close(); };
+
+        MappedFile(MappedFile&& other) noexcept {
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+        };
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            close();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_file = std::exchange(other.m_file, nullptr);
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+
+            return *this;
+        };
+
+        MappedFile(const MappedFile&) noexcept = delete;
+        MappedFile& operator=(const MappedFile&) noexcept = delete;
+
+        // returns false if the file doesn't exist, is empty or can't be mapped
+        bool open(const std::filesystem::path& path);
+        void close();
+
+        std::span<const uint8_t> getData() const { return { m_data, m_size }; };
+        size_t getSize() const { return m_size; };
+        bool isOpen() const { return m_data != nullptr; };
+    };
+
+}
@@ -0,0 +1,521 @@
+#include "MemoryAllocator.h"
+
+namespace Graphics {
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    MemoryBlock::MemoryBlock(const Context& instance, const Device& device,
+        size_t size, uint32_t memoryTypeIndex, bool hostVisible, bool dedicated) :
+        m_size(size), m_memoryTypeIndex(memoryTypeIndex), m_dedicated(dedicated)
+    {
+        m_freeHeads.fill(invalidNode);
+
+        m_memory = device.allocateMemory(instance, m_size, m_memoryTypeIndex);
+
+        if (hostVisible) {
+            try {
+                m_data = device.getDevice().mapMemory(
+                    m_memory, 0, m_size, vk::MemoryMapFlags(), instance.getDispatchLoader());
+            }
+            catch (const vk::SystemError& e) {
+                device.getDevice().freeMemory(m_memory, nullptr, instance.getDispatchLoader());
+                throw std::runtime_error("failed to map a memory block: " + std::string(e.what()));
+            }
+        }
+
+        // the whole block starts out as a single free range
+        uint32_t node = createNode();
+        m_nodes[node].offset = 0;
+        m_nodes[node].size = m_size;
+        insertFree(node);
+
+#ifdef _DEBUG
+        std::cout << "Allocated MemoryBlock (" << m_size << " bytes, type " << m_memoryTypeIndex << ")" << std::endl;
+#endif
+
+        m_initialized = true;
+    }
+
+    void MemoryBlock::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+#ifdef _DEBUG
+        if (m_allocationCount != 0)
+            std::cout << "MemoryBlock destroyed with " << m_allocationCount << " live allocations" << std::endl;
+#endif
+
+        if (m_data)
+            device.getDevice().unmapMemory(m_memory, instance.getDispatchLoader());
+        device.getDevice().freeMemory(m_memory, nullptr, instance.getDispatchLoader());
+
+        m_nodes.clear();
+        m_unusedNodes.clear();
+        m_data = nullptr;
+#ifdef _DEBUG
+        std::cout << "Freed MemoryBlock" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    void MemoryBlock::mapping(size_t size, uint32_t& firstLevel, uint32_t& secondLevel)
+    {
+        if (size < smallSize) {
+            firstLevel = 0;
+            secondLevel = static_cast<uint32_t>(size / (smallSize / secondLevelCount));
+            return;
+        }
+
+        uint32_t log2 = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        firstLevel = log2 - smallShift + 1;
+        secondLevel = static_cast<uint32_t>((size >> (log2 - secondLevelBits)) ^ secondLevelCount);
+    }
+
+    uint32_t MemoryBlock::findFree(size_t size) const
+    {
+        // round up to the next list so that any range found is guaranteed to fit
+        if (size < smallSize)
+            size += (smallSize / secondLevelCount) - 1;
+        else
+            size += (size_t(1) << (std::bit_width(size) - 1 - secondLevelBits)) - 1;
+
+        uint32_t firstLevel, secondLevel;
+        mapping(size, firstLevel, secondLevel);
+        if (firstLevel >= firstLevelCount)
+            return invalidNode;
+
+        uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0) {
+            uint64_t firstLevelMap = m_firstLevelBitmap & (~uint64_t(0) << (firstLevel + 1));
+            if (firstLevelMap == 0)
+                return invalidNode;
+
+            firstLevel = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+            secondLevelMap = m_secondLevelBitmaps[firstLevel];
+        }
+
+        secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+        return m_freeHeads[firstLevel * secondLevelCount + secondLevel];
+    }
+
+    void MemoryBlock::insertFree(uint32_t node)
+    {
+        uint32_t firstLevel, secondLevel;
+        mapping(m_nodes[node].size, firstLevel, secondLevel);
+        uint32_t& head = m_freeHeads[firstLevel * secondLevelCount + secondLevel];
+
+        m_nodes[node].free = true;
+        m_nodes[node].prevFree = invalidNode;
+        m_nodes[node].nextFree = head;
+        if (head != invalidNode)
+            m_nodes[head].prevFree = node;
+        head = node;
+
+        m_firstLevelBitmap |= uint64_t(1) << firstLevel;
+        m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+        m_freeRangeCount++;
+    }
+
+    void MemoryBlock::removeFree(uint32_t node)
+    {
+        uint32_t firstLevel, secondLevel;
+        mapping(m_nodes[node].size, firstLevel, secondLevel);
+        uint32_t& head = m_freeHeads[firstLevel * secondLevelCount + secondLevel];
+
+        Node& current = m_nodes[node];
+        if (current.prevFree != invalidNode)
+            m_nodes[current.prevFree].nextFree = current.nextFree;
+        if (current.nextFree != invalidNode)
+            m_nodes[current.nextFree].prevFree = current.prevFree;
+
+        if (head == node) {
+            head = current.nextFree;
+            if (head == invalidNode) {
+                m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+                if (m_secondLevelBitmaps[firstLevel] == 0)
+                    m_firstLevelBitmap &= ~(uint64_t(1) << firstLevel);
+            }
+        }
+
+        current.free = false;
+        current.prevFree = invalidNode;
+        current.nextFree = invalidNode;
+        m_freeRangeCount--;
+    }
+
+    uint32_t MemoryBlock::createNode()
+    {
+        if (!m_unusedNodes.empty()) {
+            uint32_t node = m_unusedNodes.back();
+            m_unusedNodes.pop_back();
+            m_nodes[node] = Node();
+            return node;
+        }
+
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+
+    void MemoryBlock::releaseNode(uint32_t node)
+    {
+        m_unusedNodes.push_back(node);
+    }
+
+    uint32_t MemoryBlock::allocate(size_t size, size_t alignment, size_t& offset)
+    {
+        assert(m_initialized && "MemoryBlock::allocate() - MemoryBlock is not initialized");
+        assert(std::has_single_bit(alignment) && "MemoryBlock::allocate() - Alignment must be a power of two");
+
+        auto fits = [&](uint32_t candidate) {
+            return alignUp(m_nodes[candidate].offset, alignment) - m_nodes[candidate].offset + size
+                <= m_nodes[candidate].size;
+            };
+
+        // try the good fit list first, most ranges are already aligned, then pay for the worst case
+        // padding, the exact list is only walked as a last resort (dedicated blocks end up there)
+        uint32_t node = findFree(size);
+        if (node == invalidNode || !fits(node))
+            node = findFree(size + alignment - 1);
+        if (node == invalidNode) {
+            uint32_t firstLevel, secondLevel;
+            mapping(size, firstLevel, secondLevel);
+            node = m_freeHeads[firstLevel * secondLevelCount + secondLevel];
+            while (node != invalidNode && !fits(node))
+                node = m_nodes[node].nextFree;
+        }
+        if (node == invalidNode)
+            return invalidNode;
+
+        removeFree(node);
+
+        // the front padding goes back to the previous range or becomes a free range of its own
+        size_t alignedOffset = alignUp(m_nodes[node].offset, alignment);
+        size_t padding = alignedOffset - m_nodes[node].offset;
+        if (padding > 0) {
+            uint32_t prev = m_nodes[node].prevPhysical;
+            if (prev != invalidNode && m_nodes[prev].free) {
+                removeFree(prev);
+                m_nodes[prev].size += padding;
+                insertFree(prev);
+            }
+            else {
+                uint32_t front = createNode();
+                m_nodes[front].offset = m_nodes[node].offset;
+                m_nodes[front].size = padding;
+                m_nodes[front].prevPhysical = prev;
+                m_nodes[front].nextPhysical = node;
+                if (prev != invalidNode)
+                    m_nodes[prev].nextPhysical = front;
+                m_nodes[node].prevPhysical = front;
+                insertFree(front);
+            }
+            m_nodes[node].offset = alignedOffset;
+            m_nodes[node].size -= padding;
+        }
+
+        size_t remainder = m_nodes[node].size - size;
+        if (remainder >= minimumRange) {
+            uint32_t back = createNode();
+            m_nodes[back].offset = m_nodes[node].offset + size;
+            m_nodes[back].size = remainder;
+            m_nodes[back].prevPhysical = node;
+            m_nodes[back].nextPhysical = m_nodes[node].nextPhysical;
+            if (m_nodes[node].nextPhysical != invalidNode)
+                m_nodes[m_nodes[node].nextPhysical].prevPhysical = back;
+            m_nodes[node].nextPhysical = back;
+            m_nodes[node].size = size;
+            insertFree(back);
+        }
+
+        m_usedBytes += m_nodes[node].size;
+        m_allocationCount++;
+
+        offset = m_nodes[node].offset;
+        return node;
+    }
+
+    void MemoryBlock::free(uint32_t node)
+    {
+        assert(m_initialized && "MemoryBlock::free() - MemoryBlock is not initialized");
+        assert(node < m_nodes.size() && !m_nodes[node].free && "MemoryBlock::free() - Range is not allocated");
+
+        m_usedBytes -= m_nodes[node].size;
+        m_allocationCount--;
+
+        uint32_t next = m_nodes[node].nextPhysical;
+        if (next != invalidNode && m_nodes[next].free) {
+            removeFree(next);
+            m_nodes[node].size += m_nodes[next].size;
+            m_nodes[node].nextPhysical = m_nodes[next].nextPhysical;
+            if (m_nodes[next].nextPhysical != invalidNode)
+                m_nodes[m_nodes[next].nextPhysical].prevPhysical = node;
+            releaseNode(next);
+        }
+
+        uint32_t prev = m_nodes[node].prevPhysical;
+        if (prev != invalidNode && m_nodes[prev].free) {
+            removeFree(prev);
+            m_nodes[prev].size += m_nodes[node].size;
+            m_nodes[prev].nextPhysical = m_nodes[node].nextPhysical;
+            if (m_nodes[node].nextPhysical != invalidNode)
+                m_nodes[m_nodes[node].nextPhysical].prevPhysical = prev;
+            releaseNode(node);
+            node = prev;
+        }
+
+        insertFree(node);
+    }
+
+    MemoryBlock::Statistics MemoryBlock::getStatistics() const
+    {
+        Statistics statistics;
+        statistics.allocationCount = m_allocationCount;
+        statistics.usedBytes = m_usedBytes;
+        statistics.freeBytes = m_size - m_usedBytes;
+        statistics.freeRangeCount = m_freeRangeCount;
+
+        // the largest range lives in the highest non empty list
+        if (m_firstLevelBitmap != 0) {
+            uint32_t firstLevel = 63 - static_cast<uint32_t>(std::countl_zero(m_firstLevelBitmap));
+            uint32_t secondLevel = 31 - static_cast<uint32_t>(std::countl_zero(m_secondLevelBitmaps[firstLevel]));
+            for (uint32_t node = m_freeHeads[firstLevel * secondLevelCount + secondLevel];
+                node != invalidNode; node = m_nodes[node].nextFree)
+                statistics.largestFreeRange = std::max(statistics.largestFreeRange, m_nodes[node].size);
+        }
+
+        return statistics;
+    }
+
+    MemoryAllocator::MemoryAllocator(const Context& instance, const Device& device, size_t blockSize) :
+        m_blockSize(blockSize)
+    {
+        m_memoryProperties = device.getPhysicalDevice().getHandle().getMemoryProperties(instance.getDispatchLoader());
+        m_bufferImageGranularity = static_cast<size_t>(
+            device.getPhysicalDevice().getProperty<DeviceProperty::BufferImageGranularity>());
+
+        // two pools per memory type, linear and optimal resources
+        m_pools.resize(m_memoryProperties.memoryTypeCount * 2);
+        for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+            // small heaps (like the 256MB device local host visible one) get smaller blocks
+            size_t heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[i].heapIndex].size;
+            size_t poolBlockSize = std::min(m_blockSize, std::bit_floor(std::max<size_t>(heapSize / 8, 1)));
+            m_pools[i * 2].blockSize = poolBlockSize;
+            m_pools[i * 2 + 1].blockSize = poolBlockSize;
+        }
+
+        m_initialized = true;
+    }
+
+    void MemoryAllocator::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& pool : m_pools) {
+            for (auto& block : pool.blocks)
+                block->destroy(instance, device);
+            pool.blocks.clear();
+        }
+        m_pools.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed MemoryAllocator" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    Allocation MemoryAllocator::allocate(const Context& instance, const Device& device,
+        const vk::MemoryRequirements& memRequirements, MemoryProperty::Flags memoryProperties,
+        ResourceType type /*= ResourceType::Linear*/)
+    {
+        assert(m_initialized && "MemoryAllocator::allocate() - MemoryAllocator is not initialized");
+
+        uint32_t memoryTypeIndex = device.findMemoryType(instance, memRequirements.memoryTypeBits, memoryProperties);
+        bool hostVisible = static_cast<bool>(m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags &
+            vk::MemoryPropertyFlagBits::eHostVisible);
+
+        // linear and optimal resources only need separate blocks if the device cares about it
+        uint32_t poolIndex = memoryTypeIndex * 2;
+        if (type == ResourceType::Optimal && m_bufferImageGranularity > 1)
+            poolIndex++;
+
+        size_t size = memRequirements.size;
+        size_t alignment = std::max<size_t>(memRequirements.alignment, 1);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Pool& pool = m_pools[poolIndex];
+
+        Allocation allocation;
+        allocation.m_poolIndex = poolIndex;
+
+        // resources bigger than half a block get a block of their own
+        if (size > pool.blockSize / 2) {
+            auto block = std::make_unique<MemoryBlock>(instance, device,
+                alignUp(size, alignment), memoryTypeIndex, hostVisible, true);
+            allocation.m_node = block->allocate(size, alignment, allocation.m_offset);
+            allocation.m_block = block.get();
+            pool.blocks.push_back(std::move(block));
+        }
+        else {
+            for (auto& block : pool.blocks) {
+                if (block->isDedicated())
+                    continue;
+
+                uint32_t node = block->allocate(size, alignment, allocation.m_offset);
+                if (node != MemoryBlock::invalidNode) {
+                    allocation.m_node = node;
+                    allocation.m_block = block.get();
+                    break;
+                }
+            }
+
+            if (allocation.m_block == nullptr) {
+                auto block = std::make_unique<MemoryBlock>(instance, device,
+                    pool.blockSize, memoryTypeIndex, hostVisible);
+                allocation.m_node = block->allocate(size, alignment, allocation.m_offset);
+                allocation.m_block = block.get();
+                pool.blocks.push_back(std::move(block));
+            }
+        }
+
+        assert(allocation.m_node != MemoryBlock::invalidNode && "MemoryAllocator::allocate() - Fresh block could not fit the allocation");
+
+        allocation.m_memory = allocation.m_block->getMemory();
+        allocation.m_size = allocation.m_block->getNodeSize(allocation.m_node);
+        if (allocation.m_block->getData())
+            allocation.m_data = static_cast<uint8_t*>(allocation.m_block->getData()) + allocation.m_offset;
+
+        return allocation;
+    }
+
+    Allocation MemoryAllocator::allocate(const Context& instance, const Device& device,
+        const Buffer& buffer, MemoryProperty::Flags memoryProperties)
+    {
+        Allocation allocation = allocate(instance, device,
+            buffer.getMemoryRequirements(), memoryProperties, ResourceType::Linear);
+        bindBuffer(instance, device, buffer, allocation);
+        return allocation;
+    }
+
+    Allocation MemoryAllocator::allocate(const Context& instance, const Device& device,
+        const Image& image, MemoryProperty::Flags memoryProperties)
+    {
+        Allocation allocation = allocate(instance, device,
+            image.getMemoryRequirements(), memoryProperties, ResourceType::Optimal);
+        bindImage(instance, device, image, allocation);
+        return allocation;
+    }
+
+    void MemoryAllocator::free(const Context& instance, const Device& device, Allocation& allocation)
+    {
+        if (!allocation.isValid())
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Pool& pool = m_pools[allocation.m_poolIndex];
+        MemoryBlock* block = allocation.m_block;
+        block->free(allocation.m_node);
+
+        // dedicated blocks go straight back to the driver, regular ones are kept
+        // unless there is already another empty block in the pool to avoid thrashing
+        if (block->isEmpty()) {
+            bool release = block->isDedicated();
+            if (!release) {
+                for (auto& other : pool.blocks) {
+                    if (other.get() != block && !other->isDedicated() && other->isEmpty()) {
+                        release = true;
+                        break;
+                    }
+                }
+            }
+
+            if (release) {
+                auto it = std::find_if(pool.blocks.begin(), pool.blocks.end(),
+                    [block](const auto& owned) { return owned.get() == block; });
+                (*it)->destroy(instance, device);
+                pool.blocks.erase(it);
+            }
+        }
+
+        allocation = Allocation();
+    }
+
+    bool MemoryAllocator::bindBuffer(const Context& instance, const Device& device,
+        const Buffer& buffer, const Allocation& allocation)
+    {
+        if (!m_initialized || !allocation.isValid())
+            return false;
+
+        try {
+            device.getDevice().bindBufferMemory(buffer.getBuffer(), allocation.m_memory,
+                allocation.m_offset, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to bind memory to a buffer: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error binding memory to a buffer: " + std::string(e.what()));
+        }
+        return true;
+    }
+
+    bool MemoryAllocator::bindImage(const Context& instance, const Device& device,
+        const Image& image, const Allocation& allocation)
+    {
+        if (!m_initialized || !allocation.isValid())
+            return false;
+
+        try {
+            device.getDevice().bindImageMemory(image.getImage(), allocation.m_memory,
+                allocation.m_offset, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to bind memory to an image: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error binding memory to an image: " + std::string(e.what()));
+        }
+        return true;
+    }
+
+    void MemoryAllocator::accumulateStatistics(const Pool& pool, Statistics& statistics) const
+    {
+        for (const auto& block : pool.blocks) {
+            MemoryBlock::Statistics blockStatistics = block->getStatistics();
+            statistics.blockCount++;
+            if (block->isDedicated())
+                statistics.dedicatedBlockCount++;
+            statistics.allocationCount += blockStatistics.allocationCount;
+            statistics.reservedBytes += block->getSize();
+            statistics.usedBytes += blockStatistics.usedBytes;
+            statistics.freeBytes += blockStatistics.freeBytes;
+            statistics.freeRangeCount += blockStatistics.freeRangeCount;
+            statistics.largestFreeRange = std::max(statistics.largestFreeRange, blockStatistics.largestFreeRange);
+        }
+    }
+
+    MemoryAllocator::Statistics MemoryAllocator::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Statistics statistics;
+        for (const auto& pool : m_pools)
+            accumulateStatistics(pool, statistics);
+        return statistics;
+    }
+
+    MemoryAllocator::Statistics MemoryAllocator::getStatistics(uint32_t memoryTypeIndex) const
+    {
+        assert(memoryTypeIndex < m_memoryProperties.memoryTypeCount && "MemoryAllocator::getStatistics() - Invalid memory type");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Statistics statistics;
+        accumulateStatistics(m_pools[memoryTypeIndex * 2], statistics);
+        accumulateStatistics(m_pools[memoryTypeIndex * 2 + 1], statistics);
+        return statistics;
+    }
+
+}
@@ -0,0 +1,263 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Flags.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/Context.h"
+#include "Buffer.h"
+#include "Image.h"
+
+#include <bit>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <limits>
+
+namespace Graphics {
+
+    // one vkAllocateMemory worth of device memory, ranges inside of it are handed out
+    // with a two level segregated fit (TLSF) free list, so both allocate and free are O(1)
+    class MemoryBlock
+    {
+    public:
+        static constexpr uint32_t invalidNode = std::numeric_limits<uint32_t>::max();
+
+        struct Statistics
+        {
+            size_t allocationCount = 0;
+            size_t usedBytes = 0;
+            size_t freeBytes = 0;
+            size_t freeRangeCount = 0;
+            size_t largestFreeRange = 0;
+        };
+
+    private:
+        // sizes below smallSize are split linearly, above that every power of two
+        // is split into secondLevelCount lists
+        static constexpr uint32_t secondLevelBits = 4;
+        static constexpr uint32_t secondLevelCount = 1u << secondLevelBits;
+        static constexpr uint32_t smallShift = 8;
+        static constexpr size_t smallSize = size_t(1) << smallShift;
+        static constexpr uint32_t firstLevelCount = 64 - smallShift + 1;
+
+        // leftovers smaller than this stay attached to the allocation instead of becoming a free range
+        static constexpr size_t minimumRange = 16;
+
+        struct Node
+        {
+            size_t offset = 0;
+            size_t size = 0;
+            uint32_t prevPhysical = invalidNode;
+            uint32_t nextPhysical = invalidNode;
+            uint32_t prevFree = invalidNode;
+            uint32_t nextFree = invalidNode;
+            bool free = false;
+        };
+
+        vk::DeviceMemory m_memory = nullptr;
+        size_t m_size = 0;
+        uint32_t m_memoryTypeIndex = 0;
+        void* m_data = nullptr;
+        bool m_dedicated = false;
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_unusedNodes;
+
+        uint64_t m_firstLevelBitmap = 0;
+        std::array<uint32_t, firstLevelCount> m_secondLevelBitmaps = {};
+        std::array<uint32_t, firstLevelCount * secondLevelCount> m_freeHeads;
+
+        size_t m_usedBytes = 0;
+        size_t m_allocationCount = 0;
+        size_t m_freeRangeCount = 0;
+
+        bool m_initialized = false;
+
+    public:
+        MemoryBlock() {};
+
+        // host visible blocks are mapped for their whole lifetime
+        MemoryBlock(const Context& instance, const Device& device,
+            size_t size, uint32_t memoryTypeIndex, bool hostVisible, bool dedicated = false);
+
+        MemoryBlock(MemoryBlock&&) noexcept = delete;
+        MemoryBlock& operator=(MemoryBlock&&) noexcept = delete;
+
+        MemoryBlock(const MemoryBlock&) noexcept = delete;
+        MemoryBlock& operator=(const MemoryBlock&) noexcept = delete;
+
+        ~MemoryBlock() { assert(!m_initialized && "MemoryBlock was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        // returns invalidNode if the block has no range that fits
+        uint32_t allocate(size_t size, size_t alignment, size_t& offset);
+        void free(uint32_t node);
+
+        Statistics getStatistics() const;
+
+        vk::DeviceMemory getMemory() const { return m_memory; };
+        size_t getSize() const { return m_size; };
+        size_t getNodeSize(uint32_t node) const { return m_nodes[node].size; };
+        uint32_t getMemoryTypeIndex() const { return m_memoryTypeIndex; };
+        void* getData() const { return m_data; };
+        bool isDedicated() const { return m_dedicated; };
+        bool isEmpty() const { return m_allocationCount == 0; };
+
+    private:
+        static void mapping(size_t size, uint32_t& firstLevel, uint32_t& secondLevel);
+        uint32_t findFree(size_t size) const;
+        void insertFree(uint32_t node);
+        void removeFree(uint32_t node);
+        uint32_t createNode();
+        void releaseNode(uint32_t node);
+    };
+
+    // a range inside of one of the allocator's blocks, cheap to copy around
+    // the allocator owns the memory, give the allocation back with MemoryAllocator::free
+    class Allocation
+    {
+    private:
+        vk::DeviceMemory m_memory = nullptr;
+        size_t m_offset = 0;
+        size_t m_size = 0;
+        void* m_data = nullptr;
+        MemoryBlock* m_block = nullptr;
+        uint32_t m_node = MemoryBlock::invalidNode;
+        uint32_t m_poolIndex = 0;
+
+    public:
+        Allocation() {};
+
+        vk::DeviceMemory getMemory() const { return m_memory; };
+        size_t getOffset() const { return m_offset; };
+        size_t getSize() const { return m_size; };
+        bool isMapped() const { return m_data != nullptr; };
+        bool isValid() const { return m_block != nullptr; };
+
+        // size in T objects, offset in bytes relative to the allocation
+        template<typename T = uint8_t>
+        std::span<T> getMapping(size_t size, size_t offset = 0) const
+        {
+            assert(m_data && "Allocation::getMapping() - Allocation is not host visible");
+            assert(offset + size * sizeof(T) <= m_size && "Allocation::getMapping() - Mapping exceeds allocation size");
+            void* offsettedData = static_cast<void*>(static_cast<uint8_t*>(m_data) + offset);
+            return std::span<T>(static_cast<T*>(offsettedData), size);
+        }
+
+        friend class MemoryAllocator;
+    };
+
+    // sub-allocates buffers and images out of large per memory type blocks
+    // instead of doing one vkAllocateMemory per resource, thread safe
+    class MemoryAllocator
+    {
+    public:
+        static constexpr size_t defaultBlockSize = 64ull * 1024 * 1024;
+
+        // buffers and linear images are Linear, optimal tiling images are Optimal,
+        // the two are kept in separate blocks when bufferImageGranularity requires it
+        enum class ResourceType
+        {
+            Linear,
+            Optimal,
+        };
+
+        struct Statistics
+        {
+            size_t blockCount = 0;
+            size_t dedicatedBlockCount = 0;
+            size_t allocationCount = 0;
+            size_t reservedBytes = 0;
+            size_t usedBytes = 0;
+            size_t freeBytes = 0;
+            size_t freeRangeCount = 0;
+            size_t largestFreeRange = 0;
+
+            // 0 when all free memory is one contiguous range, approaches 1 as it gets split up
+            float getFragmentation() const {
+                if (freeBytes == 0)
+                    return 0.0f;
+                return 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+            }
+        };
+
+    private:
+        struct Pool
+        {
+            std::vector<std::unique_ptr<MemoryBlock>> blocks;
+            size_t blockSize = 0;
+        };
+
+        vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+        std::vector<Pool> m_pools;
+        size_t m_blockSize = 0;
+        size_t m_bufferImageGranularity = 1;
+
+        mutable std::mutex m_mutex;
+
+        bool m_initialized = false;
+    public:
+
+        MemoryAllocator() {};
+
+        MemoryAllocator(const Context& instance, const Device& device, size_t blockSize = defaultBlockSize);
+
+        MemoryAllocator(MemoryAllocator&& other) noexcept {
+            m_memoryProperties = std::exchange(other.m_memoryProperties, vk::PhysicalDeviceMemoryProperties());
+            m_pools = std::exchange(other.m_pools, {});
+            m_blockSize = std::exchange(other.m_blockSize, 0);
+            m_bufferImageGranularity = std::exchange(other.m_bufferImageGranularity, 1);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized allocator is undefined behavior, destroy before moving
+        MemoryAllocator& operator=(MemoryAllocator&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "MemoryAllocator::operator=() - MemoryAllocator already initialized");
+
+            m_memoryProperties = std::exchange(other.m_memoryProperties, vk::PhysicalDeviceMemoryProperties());
+            m_pools = std::exchange(other.m_pools, {});
+            m_blockSize = std::exchange(other.m_blockSize, 0);
+            m_bufferImageGranularity = std::exchange(other.m_bufferImageGranularity, 1);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        MemoryAllocator(const MemoryAllocator&) noexcept = delete;
+        MemoryAllocator& operator=(const MemoryAllocator&) noexcept = delete;
+
+        ~MemoryAllocator() { assert(!m_initialized && "MemoryAllocator was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        Allocation allocate(const Context& instance, const Device& device,
+            const vk::MemoryRequirements& memRequirements, MemoryProperty::Flags memoryProperties,
+            ResourceType type = ResourceType::Linear);
+
+        // allocates a range that fits the resource and binds it
+        Allocation allocate(const Context& instance, const Device& device,
+            const Buffer& buffer, MemoryProperty::Flags memoryProperties);
+        Allocation allocate(const Context& instance, const Device& device,
+            const Image& image, MemoryProperty::Flags memoryProperties);
+
+        void free(const Context& instance, const Device& device, Allocation& allocation);
+
+        bool bindBuffer(const Context& instance, const Device& device,
+            const Buffer& buffer, const Allocation& allocation);
+        bool bindImage(const Context& instance, const Device& device,
+            const Image& image, const Allocation& allocation);
+
+        Statistics getStatistics() const;
+        Statistics getStatistics(uint32_t memoryTypeIndex) const;
+
+        size_t getBlockSize() const { return m_blockSize; };
+
+    private:
+        void accumulateStatistics(const Pool& pool, Statistics& statistics) const;
+    };
+
+}
@@ -0,0 +1,151 @@
+#include "MeshCache.h"
+
+namespace Graphics {
+
+    static size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // written so neither side can overflow, the offset and size come straight from the file
+    static bool fitsRange(uint64_t offset, uint64_t size, uint64_t limit)
+    {
+        return size <= limit && offset <= limit - size;
+    }
+
+    std::optional<uint64_t> MeshCache::hashSource(const std::filesystem::path& source)
+    {
+        MappedFile file;
+        if (!file.open(source))
+            return std::nullopt;
+
+        auto data = file.getData();
+        return hashBytes(data.data(), data.size());
+    }
+
+    uint64_t MeshCache::hashLayout(ArrayInterface<vk::VertexInputAttributeDescription> attributes)
+    {
+        // field by field, the struct may have padding
+        uint64_t hash = hashSeed;
+        for (size_t i = 0; i < attributes.size(); i++) {
+            const auto& attribute = attributes[i];
+            uint32_t format = static_cast<uint32_t>(attribute.format);
+            hash = hashBytes(&attribute.location, sizeof(attribute.location), hash);
+            hash = hashBytes(&format, sizeof(format), hash);
+            hash = hashBytes(&attribute.offset, sizeof(attribute.offset), hash);
+        }
+        return hash;
+    }
+
+    uint64_t MeshCache::hashOptions(const MeshOptimizer::Options& options)
+    {
+        uint8_t flags = (options.optimizeVertexCache ? 1 : 0) | (options.optimizeOverdraw ? 2 : 0) |
+            (options.optimizeVertexFetch ? 4 : 0);
+        uint64_t hash = hashBytes(&flags, sizeof(flags));
+        return hashBytes(&options.overdrawThreshold, sizeof(options.overdrawThreshold), hash);
+    }
+
+    std::filesystem::path MeshCache::getCachePath(const std::filesystem::path& directory, const Key& key)
+    {
+        uint64_t hash = hashBytes(&key.sourceHash, sizeof(key.sourceHash));
+        hash = hashBytes(&key.layoutHash, sizeof(key.layoutHash), hash);
+        hash = hashBytes(&key.optionsHash, sizeof(key.optionsHash), hash);
+        hash = hashBytes(&key.vertexStride, sizeof(key.vertexStride), hash);
+
+        char name[17];
+        std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+        return directory / (std::string(name) + fileExtension);
+    }
+
+    void MeshCache::write(const std::filesystem::path& path, const Key& key, const View& view)
+    {
+        FileHeader header;
+        header.sourceHash = key.sourceHash;
+        header.layoutHash = key.layoutHash;
+        header.optionsHash = key.optionsHash;
+        header.vertexStride = key.vertexStride;
+        header.meshCount = static_cast<uint32_t>(view.meshes.size());
+        header.vertexDataOffset = alignUp(sizeof(FileHeader) + view.meshes.size_bytes(), dataAlignment);
+        header.vertexDataSize = view.vertexData.size();
+        header.indexDataOffset = alignUp(header.vertexDataOffset + header.vertexDataSize, dataAlignment);
+        header.indexDataSize = view.indexData.size();
+
+        if (path.has_parent_path())
+            std::filesystem::create_directories(path.parent_path());
+
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                throw std::runtime_error("failed to open " + temporary.string() + " for writing");
+
+            const std::array<char, dataAlignment> padding = {};
+            auto pad = [&](uint64_t offset) {
+                file.write(padding.data(), offset - static_cast<uint64_t>(file.tellp()));
+            };
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            file.write(reinterpret_cast<const char*>(view.meshes.data()), view.meshes.size_bytes());
+            pad(header.vertexDataOffset);
+            file.write(reinterpret_cast<const char*>(view.vertexData.data()), view.vertexData.size());
+            pad(header.indexDataOffset);
+            file.write(reinterpret_cast<const char*>(view.indexData.data()), view.indexData.size());
+            file.flush();
+            if (!file)
+                throw std::runtime_error("failed to write " + temporary.string());
+        }
+
+        std::filesystem::rename(temporary, path);
+    }
+
+    MeshCache::View MeshCache::read(const MappedFile& file, const Key& key)
+    {
+        auto data = file.getData();
+        if (data.size() < sizeof(FileHeader))
+            return {};
+
+        const FileHeader* header = reinterpret_cast<const FileHeader*>(data.data());
+        if (header->magic != fileMagic || header->version != fileVersion ||
+            header->sourceHash != key.sourceHash || header->layoutHash != key.layoutHash ||
+            header->optionsHash != key.optionsHash || header->vertexStride != key.vertexStride)
+            return {};
+
+        size_t tableEnd = sizeof(FileHeader) + header->meshCount * sizeof(MeshEntry);
+        if (header->meshCount == 0 || tableEnd > data.size() ||
+            !fitsRange(header->vertexDataOffset, header->vertexDataSize, data.size()) ||
+            !fitsRange(header->indexDataOffset, header->indexDataSize, data.size())) {
+#ifdef _DEBUG
+            std::cout << "MeshCache file is truncated, reimporting" << std::endl;
+#endif
+            return {};
+        }
+
+        View view;
+        view.meshes = { reinterpret_cast<const MeshEntry*>(data.data() + sizeof(FileHeader)), header->meshCount };
+        view.vertexData = data.subspan(header->vertexDataOffset, header->vertexDataSize);
+        view.indexData = data.subspan(header->indexDataOffset, header->indexDataSize);
+
+        // the entries end up straight in draw calls, one bad range is enough to throw the whole file away
+        uint64_t vertexCount = header->vertexDataSize / key.vertexStride;
+        for (const MeshEntry& entry : view.meshes) {
+            uint64_t indexSize = 0;
+            if (entry.indexType == IndexType::Uint16)
+                indexSize = sizeof(uint16_t);
+            else if (entry.indexType == IndexType::Uint32)
+                indexSize = sizeof(uint32_t);
+
+            if (indexSize == 0 || entry.indexOffset % indexSize != 0 ||
+                !fitsRange(entry.firstVertex, entry.vertexCount, vertexCount) ||
+                !fitsRange(entry.indexOffset, entry.indexCount * indexSize, header->indexDataSize)) {
+#ifdef _DEBUG
+                std::cout << "MeshCache file has a mesh outside its data, reimporting" << std::endl;
+#endif
+                return {};
+            }
+        }
+
+        return view;
+    }
+
+}
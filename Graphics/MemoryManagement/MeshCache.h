@@ -0,0 +1,96 @@
+#pragma once
+#include "../Common.h"
+#include "../MeshOptimizer.h"
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <span>
+
+namespace Graphics {
+
+    // on disk format for imported meshes, laid out so a mapped file can be uploaded as is
+    // header, mesh table, then the vertex and index blobs each aligned to dataAlignment
+    // files are named after the hash of the key, the source file contents plus the vertex layout and optimizer options,
+    // so an edited source or changed settings get a new cache file, and a header that doesn't match the key is a miss
+    class MeshCache
+    {
+    public:
+        static constexpr uint32_t fileMagic = 0x434D5647; // "GVMC"
+        static constexpr uint32_t fileVersion = 2;
+        static constexpr size_t dataAlignment = 16;
+        static constexpr const char* fileExtension = ".meshcache";
+
+        struct FileHeader
+        {
+            uint32_t magic = fileMagic;
+            uint32_t version = fileVersion;
+            uint64_t sourceHash = 0;
+            uint64_t layoutHash = 0;
+            uint64_t optionsHash = 0;
+            uint32_t vertexStride = 0;
+            uint32_t meshCount = 0;
+            uint64_t vertexDataOffset = 0;
+            uint64_t vertexDataSize = 0;
+            uint64_t indexDataOffset = 0;
+            uint64_t indexDataSize = 0;
+        };
+
+        struct MeshEntry
+        {
+            uint32_t firstVertex = 0;
+            uint32_t vertexCount = 0;
+            uint64_t indexOffset = 0; // bytes into the index blob
+            uint32_t indexCount = 0;
+            IndexType indexType = IndexType::Uint32;
+            uint32_t materialIndex = 0;
+            uint32_t pad = 0;
+            float boundsMin[3] = {};
+            float boundsMax[3] = {};
+        };
+
+        // everything the imported data depends on
+        struct Key
+        {
+            uint64_t sourceHash = 0;
+            uint64_t layoutHash = 0;
+            uint64_t optionsHash = 0;
+            uint32_t vertexStride = 0;
+        };
+
+        // points either into a mapped file or into Data
+        struct View
+        {
+            std::span<const MeshEntry> meshes;
+            std::span<const uint8_t> vertexData;
+            std::span<const uint8_t> indexData;
+
+            bool isValid() const { return !meshes.empty(); };
+        };
+
+        struct Data
+        {
+            std::vector<MeshEntry> meshes;
+            std::vector<uint8_t> vertexData;
+            std::vector<uint8_t> indexData;
+
+            View getView() const { return { meshes, vertexData, indexData }; };
+        };
+
+        // nullopt if the source can't be read
+        static std::optional<uint64_t> hashSource(const std::filesystem::path& source);
+
+        // the attribute formats and offsets of a vertex definition, getAttributeDescriptions() of it
+        static uint64_t hashLayout(ArrayInterface<vk::VertexInputAttributeDescription> attributes);
+        static uint64_t hashOptions(const MeshOptimizer::Options& options);
+
+        static std::filesystem::path getCachePath(const std::filesystem::path& directory, const Key& key);
+
+        // writes to a temporary file and renames it over the old one like PipelineCache::save
+        static void write(const std::filesystem::path& path, const Key& key, const View& view);
+
+        // checks the header and every range against the file size and every mesh entry against the blobs,
+        // returns an invalid view on a miss
+        static View read(const MappedFile& file, const Key& key);
+    };
+
+}
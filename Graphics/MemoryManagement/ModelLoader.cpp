@@ -0,0 +1,312 @@
+#include "ModelLoader.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+namespace Graphics {
+
+    static size_t alignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    ModelLoader::ModelLoader(MT::ThreadPool& threadPool, MemoryAllocator& allocator,
+        UploadQueue& uploadQueue, StagingRing& stagingRing,
+        const std::filesystem::path& cacheDirectory, uint32_t capacity,
+        const MeshOptimizer::Options& optimizerOptions /*= MeshOptimizer::Options()*/,
+        size_t uploadBudget /*= defaultUploadBudget*/) :
+        m_threadPool(&threadPool), m_allocator(&allocator), m_uploadQueue(&uploadQueue),
+        m_stagingRing(&stagingRing), m_cacheDirectory(cacheDirectory), m_optimizerOptions(optimizerOptions),
+        m_capacity(capacity), m_uploadBudget(uploadBudget)
+    {
+        m_models.reserve(m_capacity);
+        m_initialized = true;
+    }
+
+    void ModelLoader::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+            m_pendingDone.wait(lock, [this]() { return m_pendingLoads == 0; });
+        }
+
+        for (auto id : m_uploading)
+            m_uploadQueue->wait(instance, device, m_models[id].ticket);
+        m_uploading.clear();
+        m_loaded.clear();
+        m_failed.clear();
+
+        for (auto& model : m_models) {
+            model.vertexBuffer.destroy(instance, device);
+            model.indexBuffer.destroy(instance, device);
+            if (model.vertexAllocation.isValid())
+                m_allocator->free(instance, device, model.vertexAllocation);
+            if (model.indexAllocation.isValid())
+                m_allocator->free(instance, device, model.indexAllocation);
+        }
+        m_models.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed ModelLoader" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    ModelLoader::ModelId ModelLoader::request(const std::filesystem::path& source)
+    {
+        assert(m_initialized && "ModelLoader::request() - ModelLoader is not initialized");
+
+        ModelId id;
+        {
+            std::lock_guard<std::mutex> lock(m_loadedMutex);
+            if (m_models.size() >= m_capacity)
+                throw std::runtime_error("ModelLoader::request() - Out of model slots");
+
+            id = static_cast<ModelId>(m_models.size());
+            m_models.emplace_back();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pendingLoads++;
+        }
+
+        auto task = [this, id, source]() {
+            Loaded loaded;
+            bool succeeded = true;
+            try {
+                loaded = load(source);
+            }
+            catch (const std::exception& e) {
+#ifdef _DEBUG
+                std::cout << "ModelLoader failed to load " << source << ": " << e.what() << std::endl;
+#endif
+                succeeded = false;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(m_loadedMutex);
+                if (succeeded)
+                    m_loaded.emplace_back(id, std::move(loaded));
+                else
+                    m_failed.push_back(id);
+            }
+
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            if (--m_pendingLoads == 0)
+                m_pendingDone.notify_all();
+            };
+
+        // pool is shutting down, load here instead of dropping the request
+        if (!m_threadPool->pushTask(task))
+            task();
+
+        return id;
+    }
+
+    ModelLoader::Loaded ModelLoader::load(const std::filesystem::path& source) const
+    {
+        Loaded loaded;
+
+        std::optional<uint64_t> sourceHash = m_cacheDirectory.empty() ? std::nullopt : MeshCache::hashSource(source);
+        MeshCache::Key key;
+        std::filesystem::path cachePath;
+        if (sourceHash) {
+            key.sourceHash = *sourceHash;
+            key.layoutHash = MeshCache::hashLayout(VertexDefinition::getAttributeDescriptions());
+            key.optionsHash = MeshCache::hashOptions(m_optimizerOptions);
+            key.vertexStride = sizeof(Vertex);
+
+            cachePath = MeshCache::getCachePath(m_cacheDirectory, key);
+            if (loaded.file.open(cachePath)) {
+                loaded.view = MeshCache::read(loaded.file, key);
+                if (loaded.view.isValid())
+                    return loaded;
+                loaded.file.close();
+            }
+        }
+
+        loaded.data = import(source, m_optimizerOptions);
+        loaded.view = loaded.data.getView();
+
+        // a failed write only costs a reimport next time
+        if (sourceHash) {
+            try {
+                MeshCache::write(cachePath, key, loaded.view);
+            }
+            catch (const std::exception& e) {
+#ifdef _DEBUG
+                std::cout << "Failed to write MeshCache " << cachePath << ": " << e.what() << std::endl;
+#endif
+            }
+        }
+
+        return loaded;
+    }
+
+    MeshCache::Data ModelLoader::import(const std::filesystem::path& source, const MeshOptimizer::Options& optimizerOptions)
+    {
+        // importers aren't thread safe, every load gets its own
+        Assimp::Importer importer;
+        importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+
+        const aiScene* scene = importer.ReadFile(source.string(),
+            aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals |
+            aiProcess_PreTransformVertices | aiProcess_SortByPType | aiProcess_FlipUVs);
+
+        if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || scene->mNumMeshes == 0)
+            throw std::runtime_error("failed to import " + source.string() + ": " + importer.GetErrorString());
+
+        MeshCache::Data data;
+        data.meshes.reserve(scene->mNumMeshes);
+
+        for (uint32_t m = 0; m < scene->mNumMeshes; m++) {
+            const aiMesh* mesh = scene->mMeshes[m];
+            if (mesh->mNumVertices == 0 || mesh->mNumFaces == 0)
+                continue;
+
+            std::vector<Vertex> vertices(mesh->mNumVertices);
+            glm::vec3 boundsMin(std::numeric_limits<float>::max());
+            glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+            for (uint32_t i = 0; i < mesh->mNumVertices; i++) {
+                const aiVector3D& position = mesh->mVertices[i];
+                vertices[i].position = PackedVec3(position.x, position.y, position.z);
+
+                if (mesh->HasTextureCoords(0))
+                    vertices[i].UV = PackedVec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+                else
+                    vertices[i].UV = PackedVec2(0.0f);
+
+                if (mesh->HasNormals())
+                    vertices[i].normal = PackedNormal::pack(
+                        glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z));
+
+                boundsMin = glm::min(boundsMin, glm::vec3(position.x, position.y, position.z));
+                boundsMax = glm::max(boundsMax, glm::vec3(position.x, position.y, position.z));
+            }
+
+            std::vector<uint32_t> indices;
+            indices.reserve(mesh->mNumFaces * 3);
+            for (uint32_t i = 0; i < mesh->mNumFaces; i++) {
+                const aiFace& face = mesh->mFaces[i];
+                if (face.mNumIndices != 3)
+                    continue;
+                indices.insert(indices.end(), face.mIndices, face.mIndices + 3);
+            }
+            if (indices.empty())
+                continue;
+
+            MeshOptimizer::IndexData indexData = MeshOptimizer::optimize(vertices, indices,
+                [](const Vertex& vertex) { return glm::vec3(vertex.position); }, optimizerOptions);
+
+            MeshCache::MeshEntry entry;
+            entry.firstVertex = static_cast<uint32_t>(data.vertexData.size() / sizeof(Vertex));
+            entry.vertexCount = static_cast<uint32_t>(vertices.size());
+            // 32 bit index ranges need 4 byte aligned offsets
+            entry.indexOffset = alignUp(data.indexData.size(), sizeof(uint32_t));
+            entry.indexCount = indexData.count;
+            entry.indexType = indexData.type;
+            entry.materialIndex = mesh->mMaterialIndex;
+            for (int k = 0; k < 3; k++) {
+                entry.boundsMin[k] = boundsMin[k];
+                entry.boundsMax[k] = boundsMax[k];
+            }
+
+            const uint8_t* vertexBytes = reinterpret_cast<const uint8_t*>(vertices.data());
+            data.vertexData.insert(data.vertexData.end(), vertexBytes, vertexBytes + vertices.size() * sizeof(Vertex));
+
+            data.indexData.resize(entry.indexOffset);
+            data.indexData.insert(data.indexData.end(), indexData.data.begin(), indexData.data.end());
+
+            data.meshes.push_back(entry);
+        }
+
+        if (data.meshes.empty())
+            throw std::runtime_error("failed to import " + source.string() + ": no triangle meshes");
+
+        return data;
+    }
+
+    void ModelLoader::update(const Context& instance, const Device& device)
+    {
+        assert(m_initialized && "ModelLoader::update() - ModelLoader is not initialized");
+
+        std::vector<std::pair<ModelId, Loaded>> loaded;
+        {
+            std::lock_guard<std::mutex> lock(m_loadedMutex);
+
+            for (auto id : m_failed)
+                m_models[id].state = State::Failed;
+            m_failed.clear();
+
+            // same budgeting as the texture streamer, at least one model goes through every update
+            size_t budget = 0;
+            size_t taken = 0;
+            while (taken < m_loaded.size()) {
+                const MeshCache::View& view = m_loaded[taken].second.view;
+                size_t size = view.vertexData.size() + view.indexData.size();
+                if (taken > 0 && budget + size > m_uploadBudget)
+                    break;
+                budget += size;
+                taken++;
+            }
+
+            loaded.reserve(taken);
+            for (size_t i = 0; i < taken; i++)
+                loaded.push_back(std::move(m_loaded[i]));
+            m_loaded.erase(m_loaded.begin(), m_loaded.begin() + taken);
+        }
+
+        for (auto& [id, model] : loaded) {
+            Model& target = m_models[id];
+            const MeshCache::View& view = model.view;
+
+            // MeshCache::read rejects a file with any entry outside the blobs, load() then reimports,
+            // so every range here is either checked or straight from import
+            target.meshes.reserve(view.meshes.size());
+            for (const auto& entry : view.meshes) {
+                Mesh mesh;
+                mesh.firstVertex = entry.firstVertex;
+                mesh.vertexCount = entry.vertexCount;
+                mesh.indexOffset = entry.indexOffset;
+                mesh.indexCount = entry.indexCount;
+                mesh.indexType = entry.indexType;
+                mesh.materialIndex = entry.materialIndex;
+                mesh.boundsMin = glm::vec3(entry.boundsMin[0], entry.boundsMin[1], entry.boundsMin[2]);
+                mesh.boundsMax = glm::vec3(entry.boundsMax[0], entry.boundsMax[1], entry.boundsMax[2]);
+                target.meshes.push_back(mesh);
+            }
+
+            target.vertexBuffer = Buffer(instance, device, view.vertexData.size(),
+                BufferUsage::Bits::Vertex | BufferUsage::Bits::TransferDst);
+            target.vertexAllocation = m_allocator->allocate(instance, device, target.vertexBuffer, MemoryProperty::Bits::DeviceLocal);
+            target.indexBuffer = Buffer(instance, device, view.indexData.size(),
+                BufferUsage::Bits::Index | BufferUsage::Bits::TransferDst);
+            target.indexAllocation = m_allocator->allocate(instance, device, target.indexBuffer, MemoryProperty::Bits::DeviceLocal);
+
+            // copied straight out of the mapping or the imported data into the ring,
+            // the cpu side copy is dropped at the end of this iteration
+            m_stagingRing->uploadBuffer(instance, device, *m_uploadQueue, target.vertexBuffer, view.vertexData);
+            target.ticket = m_stagingRing->uploadBuffer(instance, device, *m_uploadQueue, target.indexBuffer, view.indexData);
+            target.state = State::Uploading;
+            m_uploading.push_back(id);
+        }
+
+        if (!loaded.empty())
+            m_uploadQueue->flush(instance, device);
+
+        std::erase_if(m_uploading, [&](ModelId id) {
+            Model& model = m_models[id];
+            if (!m_uploadQueue->isComplete(instance, device, model.ticket))
+                return false;
+
+            model.state = State::Resident;
+            return true;
+            });
+    }
+
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include "../Common.h"
+#include "../BufferDataLayouts.h"
+#include "../MeshOptimizer.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/UploadQueue.h"
+#include "Buffer.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "MappedFile.h"
+#include "MeshCache.h"
+
+#include "MultiThreading/ThreadPool.h"
+
+#include <filesystem>
+#include <mutex>
+#include <condition_variable>
+
+namespace Graphics {
+
+    // loads models through assimp on the thread pool into VertexInterleaved meshes
+    // imported meshes are run through the MeshOptimizer and written to a MeshCache next to the other caches,
+    // later loads of the same source with the same vertex layout and optimizer options just map the cache file
+    // and copy it through the staging ring
+    // every mesh of a model shares one vertex and one index buffer, draw with Mesh::firstVertex as the vertex offset
+    // update() has to be called from the render thread, request() from anywhere
+    class ModelLoader
+    {
+    public:
+        using ModelId = uint32_t;
+        using Vertex = VertexInterleaved;
+        using VertexDefinition = VertexDefinitionInterleaved;
+
+        static constexpr size_t defaultUploadBudget = 32ull * 1024 * 1024;
+
+        enum class State
+        {
+            Loading,
+            Uploading,
+            Resident,
+            Failed,
+        };
+
+        struct Mesh
+        {
+            uint32_t firstVertex = 0;
+            uint32_t vertexCount = 0;
+            vk::DeviceSize indexOffset = 0;
+            uint32_t indexCount = 0;
+            IndexType indexType = IndexType::Uint32;
+            uint32_t materialIndex = 0;
+            glm::vec3 boundsMin = glm::vec3(0.0f);
+            glm::vec3 boundsMax = glm::vec3(0.0f);
+        };
+
+        struct Model
+        {
+            Buffer vertexBuffer;
+            Allocation vertexAllocation;
+            Buffer indexBuffer;
+            Allocation indexAllocation;
+            std::vector<Mesh> meshes;
+
+            UploadQueue::Ticket ticket = 0;
+            State state = State::Loading;
+        };
+
+    private:
+        // cpu side result of a load, the view points into whichever of the two is used
+        struct Loaded
+        {
+            MappedFile file;
+            MeshCache::Data data;
+            MeshCache::View view;
+        };
+
+        MT::ThreadPool* m_threadPool = nullptr;
+        MemoryAllocator* m_allocator = nullptr;
+        UploadQueue* m_uploadQueue = nullptr;
+        StagingRing* m_stagingRing = nullptr;
+
+        std::filesystem::path m_cacheDirectory;
+        MeshOptimizer::Options m_optimizerOptions;
+        uint32_t m_capacity = 0;
+        size_t m_uploadBudget = 0;
+
+        std::vector<Model> m_models;
+        std::vector<ModelId> m_uploading;
+
+        // filled by the workers, drained by update()
+        std::mutex m_loadedMutex;
+        std::vector<std::pair<ModelId, Loaded>> m_loaded;
+        std::vector<ModelId> m_failed;
+
+        std::mutex m_pendingMutex;
+        std::condition_variable m_pendingDone;
+        size_t m_pendingLoads = 0;
+
+        bool m_initialized = false;
+    public:
+
+        ModelLoader() {};
+
+        // an empty cache directory disables the cache and imports every time,
+        // model storage is reserved up front so request() can run while the render thread reads models
+        ModelLoader(MT::ThreadPool& threadPool, MemoryAllocator& allocator,
+            UploadQueue& uploadQueue, StagingRing& stagingRing,
+            const std::filesystem::path& cacheDirectory, uint32_t capacity,
+            const MeshOptimizer::Options& optimizerOptions = MeshOptimizer::Options(),
+            size_t uploadBudget = defaultUploadBudget);
+
+        // load tasks hold a pointer to the loader, so it stays where it was created
+        ModelLoader(ModelLoader&&) noexcept = delete;
+        ModelLoader& operator=(ModelLoader&&) noexcept = delete;
+
+        ModelLoader(const ModelLoader&) noexcept = delete;
+        ModelLoader& operator=(const ModelLoader&) noexcept = delete;
+
+        ~ModelLoader() { assert(!m_initialized && "ModelLoader was not destroyed!"); };
+
+        // waits for pending loads and uploads before releasing everything
+        void destroy(const Context& instance, const Device& device);
+
+        // ids are handed out right away, the model can be drawn once it is resident
+        ModelId request(const std::filesystem::path& source);
+
+        // creates buffers and uploads loaded models within the upload budget, marks finished ones resident
+        void update(const Context& instance, const Device& device);
+
+        const Model& getModel(ModelId id) const { return m_models[id]; };
+        State getState(ModelId id) const { return m_models[id].state; };
+        bool isResident(ModelId id) const { return m_models[id].state == State::Resident; };
+        size_t getModelCount() const { return m_models.size(); };
+        uint32_t getCapacity() const { return m_capacity; };
+
+        // parses the source with assimp and converts it, throws if the file can't be imported
+        static MeshCache::Data import(const std::filesystem::path& source, const MeshOptimizer::Options& optimizerOptions);
+
+    private:
+        Loaded load(const std::filesystem::path& source) const;
+    };
+
+}
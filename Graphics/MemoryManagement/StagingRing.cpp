@@ -0,0 +1,259 @@
+#include "StagingRing.h"
+
+#include <thread>
+
+namespace Graphics {
+
+    static size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    StagingRing::StagingRing(const Context& instance, const Device& device, size_t capacity, size_t maxChunkSize /*= 0*/)
+    {
+        m_buffer = Buffer(instance, device, capacity, BufferUsage::Bits::TransferSrc);
+        const auto& memRequirements = m_buffer.getMemoryRequirements();
+
+        m_memory = MappedMemory(instance, device, memRequirements,
+            MemoryProperty::Bits::HostVisibleCoherent, memRequirements.size);
+        m_memory.bindBuffer(instance, device, m_buffer);
+
+        m_capacity = alignUp(capacity, m_memory.getAlignment());
+        m_capacity = std::min<size_t>(m_capacity, memRequirements.size);
+
+        if (maxChunkSize == 0)
+            maxChunkSize = m_capacity / 4;
+        m_maxChunkSize = std::max(alignUp(maxChunkSize, copyAlignment), copyAlignment);
+        m_maxChunkSize = std::min(m_maxChunkSize, m_capacity);
+
+        m_initialized = true;
+    }
+
+    StagingRing::Range StagingRing::allocateLocked(size_t size, size_t alignment, uint64_t owner)
+    {
+        assert(m_initialized && "StagingRing::allocate() - StagingRing is not initialized");
+        assert((m_partitions.empty() || m_partitions.back().owner <= owner) && "StagingRing::allocate() - Owners have to be non decreasing");
+
+        // getMapping wants offsets and sizes in multiples of the memory alignment
+        alignment = std::max(alignment, m_memory.getAlignment());
+        size_t alignedSize = alignUp(size, m_memory.getAlignment());
+
+        // an empty range would get a partition that never holds anything
+        if (size == 0 || alignedSize > m_capacity)
+            return Range();
+
+        if (m_used == 0) {
+            m_head = 0;
+            m_tail = 0;
+        }
+
+        size_t offset = alignUp(m_head, alignment);
+        size_t consumed = 0;
+
+        if (m_used == 0 || m_head > m_tail) {
+            // free space is [head, capacity) and [0, tail)
+            if (offset + alignedSize <= m_capacity)
+                consumed = offset + alignedSize - m_head;
+            else if (alignedSize <= m_tail) {
+                consumed = (m_capacity - m_head) + alignedSize;
+                offset = 0;
+            }
+            else
+                return Range();
+        }
+        else {
+            // free space is [head, tail), empty when the ring is full
+            if (offset + alignedSize <= m_tail)
+                consumed = offset + alignedSize - m_head;
+            else
+                return Range();
+        }
+
+        m_head = offset + alignedSize;
+        m_used += consumed;
+
+        if (m_partitions.empty() || m_partitions.back().owner != owner)
+            m_partitions.push_back(Partition{ owner, m_head, consumed });
+        else {
+            m_partitions.back().end = m_head;
+            m_partitions.back().bytes += consumed;
+        }
+
+        Range range;
+        range.offset = offset;
+        range.data = m_memory.getMapping<uint8_t>(alignedSize, offset).subspan(0, size);
+        return range;
+    }
+
+    void StagingRing::releaseLocked(uint64_t completedOwner)
+    {
+        while (!m_partitions.empty() && m_partitions.front().recording == 0 && m_partitions.front().owner <= completedOwner) {
+            m_used -= m_partitions.front().bytes;
+            m_tail = m_partitions.front().end;
+            m_partitions.pop_front();
+        }
+    }
+
+    StagingRing::Range StagingRing::allocate(size_t size, size_t alignment, uint64_t owner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return allocateLocked(size, alignment, owner);
+    }
+
+    void StagingRing::release(uint64_t completedOwner)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        releaseLocked(completedOwner);
+    }
+
+    StagingRing::Reservation StagingRing::reserveLocked(size_t size, size_t alignment, uint64_t owner)
+    {
+        // the owner was read before taking the lock, another thread may have reserved with a newer one since
+        if (!m_partitions.empty())
+            owner = std::max(owner, m_partitions.back().owner);
+
+        Reservation reservation;
+        reservation.range = allocateLocked(size, alignment, owner);
+        if (!reservation.isValid())
+            return reservation;
+
+        reservation.partition = &m_partitions.back();
+        reservation.partition->recording++;
+        return reservation;
+    }
+
+    StagingRing::Reservation StagingRing::acquire(const Context& instance, const Device& device,
+        UploadQueue& queue, size_t size, size_t alignment)
+    {
+        assert(size != 0 && "StagingRing::acquire() - Nothing to acquire, it would wait forever");
+
+        while (true) {
+            uint64_t owner = queue.getRecordingTicket();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Reservation reservation = reserveLocked(size, alignment, owner);
+                if (reservation.isValid())
+                    return reservation;
+            }
+
+            // submit what is recorded so far so it can retire, then wait on the oldest partition
+            queue.flush(instance, device);
+            queue.collect(instance, device);
+            uint64_t completed = queue.getCompletedTicket();
+            owner = queue.getRecordingTicket();
+
+            uint64_t oldest = 0;
+            bool oldestRecording = false;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                releaseLocked(completed);
+
+                Reservation reservation = reserveLocked(size, alignment, owner);
+                if (reservation.isValid())
+                    return reservation;
+
+                if (m_partitions.empty())
+                    throw std::runtime_error("StagingRing::acquire() - Allocation can never fit the ring");
+
+                oldest = m_partitions.front().owner;
+                oldestRecording = m_partitions.front().recording != 0;
+            }
+
+            // another thread is between reserving and recording the oldest range, its batch may not be submitted yet
+            if (!oldestRecording && oldest <= queue.flush(instance, device))
+                queue.wait(instance, device, oldest);
+            else
+                std::this_thread::yield();
+
+            release(queue.getCompletedTicket());
+        }
+    }
+
+    void StagingRing::finishRecording(const Reservation& reservation, UploadQueue::Ticket ticket)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // someone else may have flushed between reserving and recording, keep the range alive until the batch
+        // it was actually recorded into completes, the partitions after it can't be released before it anyway
+        bool after = false;
+        for (auto& partition : m_partitions) {
+            after |= &partition == reservation.partition;
+            if (after)
+                partition.owner = std::max(partition.owner, ticket);
+        }
+        reservation.partition->recording--;
+    }
+
+    UploadQueue::Ticket StagingRing::uploadBuffer(const Context& instance, const Device& device, UploadQueue& queue,
+        const Buffer& dstBuffer, std::span<const uint8_t> data, size_t dstOffset /*= 0*/)
+    {
+        // nothing gets recorded for empty data, the recording ticket might never be flushed
+        UploadQueue::Ticket ticket = queue.getCompletedTicket();
+        for (size_t written = 0; written < data.size();) {
+            size_t chunkSize = std::min(m_maxChunkSize, data.size() - written);
+            Reservation reservation = acquire(instance, device, queue, chunkSize, copyAlignment);
+            const Range& range = reservation.range;
+            std::copy_n(data.begin() + written, chunkSize, range.data.begin());
+
+            ticket = queue.enqueueBufferCopy(instance, device, m_buffer, dstBuffer,
+                CopyRegion(range.offset, dstOffset + written, chunkSize));
+
+            finishRecording(reservation, ticket);
+            written += chunkSize;
+        }
+
+        return ticket;
+    }
+
+    UploadQueue::Ticket StagingRing::uploadImage(const Context& instance, const Device& device, UploadQueue& queue,
+        Image& dstImage, std::span<const uint8_t> pixels)
+    {
+        const uint32_t width = static_cast<uint32_t>(dstImage.getWidth());
+        const uint32_t height = static_cast<uint32_t>(dstImage.getHeight());
+        if (width == 0 || height == 0 || pixels.size() < height)
+            throw std::runtime_error("StagingRing::uploadImage() - Image has no pixels to upload");
+
+        const size_t rowPitch = pixels.size() / height;
+
+        if (rowPitch > m_maxChunkSize)
+            throw std::runtime_error("StagingRing::uploadImage() - A single image row does not fit a chunk");
+
+        const uint32_t rowsPerChunk = static_cast<uint32_t>(m_maxChunkSize / rowPitch);
+
+        UploadQueue::Ticket ticket = queue.getCompletedTicket();
+        for (uint32_t row = 0; row < height;) {
+            uint32_t rows = std::min(rowsPerChunk, height - row);
+            size_t chunkSize = rows * rowPitch;
+
+            Reservation reservation = acquire(instance, device, queue, chunkSize, copyAlignment);
+            const Range& range = reservation.range;
+            std::copy_n(pixels.begin() + row * rowPitch, chunkSize, range.data.begin());
+
+            bool first = row == 0;
+            bool last = row + rows == height;
+            ticket = queue.enqueue(instance, device, [&](const CommandBufferHandle& commandBuffer) {
+                if (first)
+                    commandBuffer->setPipelineBarrier(instance,
+                        vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                        dstImage, vk::ImageLayout::eTransferDstOptimal,
+                        vk::AccessFlags(), vk::AccessFlagBits::eTransferWrite);
+
+                commandBuffer->transferImageData(instance, m_buffer, dstImage, range.offset,
+                    vk::Offset3D{ 0, static_cast<int32_t>(row), 0 }, vk::Extent3D{ width, rows, 1 });
+
+                if (last && dstImage.getMipLevels() > 1)
+                    commandBuffer->generateMipmaps(instance, dstImage);
+                else if (last)
+                    commandBuffer->setPipelineBarrier(instance,
+                        vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+                        dstImage, vk::ImageLayout::eShaderReadOnlyOptimal,
+                        vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead);
+                });
+
+            finishRecording(reservation, ticket);
+            row += rows;
+        }
+
+        return ticket;
+    }
+
+}
@@ -0,0 +1,160 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Flags.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/UploadQueue.h"
+#include "Buffer.h"
+#include "MappedMemory.h"
+#include "Image.h"
+
+#include <deque>
+#include <mutex>
+
+namespace Graphics {
+
+    // ring allocator over one persistently mapped staging buffer
+    // ranges are tagged with an owner value (an upload ticket or a frame number) that only grows,
+    // everything up to an owner is reclaimed at once when that owner is known to be complete
+    class StagingRing
+    {
+    public:
+        // buffer to image copies need offsets aligned to the texel size and 4
+        static constexpr size_t copyAlignment = 16;
+
+        struct Range
+        {
+            size_t offset = 0;
+            std::span<uint8_t> data;
+
+            bool isValid() const { return data.data() != nullptr; };
+        };
+
+    private:
+        struct Partition
+        {
+            uint64_t owner = 0;
+            size_t end = 0;
+            size_t bytes = 0; // allocated bytes plus whatever was skipped when wrapping
+            uint32_t recording = 0; // ranges handed out by acquire() that aren't recorded yet, keeps it from being released
+        };
+
+        struct Reservation
+        {
+            Range range;
+            Partition* partition = nullptr;
+
+            bool isValid() const { return range.isValid(); };
+        };
+
+        Buffer m_buffer;
+        MappedMemory m_memory;
+        size_t m_capacity = 0;
+        size_t m_maxChunkSize = 0;
+
+        size_t m_head = 0;
+        size_t m_tail = 0;
+        size_t m_used = 0;
+        std::deque<Partition> m_partitions;
+
+        mutable std::mutex m_mutex;
+
+        bool m_initialized = false;
+    public:
+
+        StagingRing() {};
+
+        // capacity gets rounded up to the memory alignment, uploads bigger than maxChunkSize
+        // are split, defaults to a quarter of the ring so a few chunks can be in flight at once
+        StagingRing(const Context& instance, const Device& device, size_t capacity, size_t maxChunkSize = 0);
+
+        StagingRing(StagingRing&& other) noexcept {
+            m_buffer = std::move(other.m_buffer);
+            m_memory = std::move(other.m_memory);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_maxChunkSize = std::exchange(other.m_maxChunkSize, 0);
+            m_head = std::exchange(other.m_head, 0);
+            m_tail = std::exchange(other.m_tail, 0);
+            m_used = std::exchange(other.m_used, 0);
+            m_partitions = std::exchange(other.m_partitions, {});
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized ring is undefined behavior, destroy before moving
+        StagingRing& operator=(StagingRing&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "StagingRing::operator=() - StagingRing already initialized");
+
+            m_buffer = std::move(other.m_buffer);
+            m_memory = std::move(other.m_memory);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_maxChunkSize = std::exchange(other.m_maxChunkSize, 0);
+            m_head = std::exchange(other.m_head, 0);
+            m_tail = std::exchange(other.m_tail, 0);
+            m_used = std::exchange(other.m_used, 0);
+            m_partitions = std::exchange(other.m_partitions, {});
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        StagingRing(const StagingRing&) noexcept = delete;
+        StagingRing& operator=(const StagingRing&) noexcept = delete;
+
+        ~StagingRing() { assert(!m_initialized && "StagingRing was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device) {
+            if (!m_initialized)
+                return;
+
+            m_buffer.destroy(instance, device);
+            m_memory.destroy(instance, device);
+            m_partitions.clear();
+#ifdef _DEBUG
+            std::cout << "Destroyed StagingRing" << std::endl;
+#endif
+            m_initialized = false;
+        }
+
+        // never blocks, returns an invalid range if there is not enough contiguous space left or size is 0
+        // owners have to be passed in non decreasing order
+        Range allocate(size_t size, size_t alignment, uint64_t owner);
+
+        // frees every range whose owner is <= completedOwner
+        void release(uint64_t completedOwner);
+
+        // copies data through the ring into dstBuffer in chunks recorded on the upload queue,
+        // only waits when the ring is full of uploads that are still in flight
+        // the ring lock is only held to reserve space, never while calling into the queue
+        // empty data records nothing and returns a ticket that is already complete
+        UploadQueue::Ticket uploadBuffer(const Context& instance, const Device& device, UploadQueue& queue,
+            const Buffer& dstBuffer, std::span<const uint8_t> data, size_t dstOffset = 0);
+
+        // same but for the first mip of an image, split into row bands, the rest of the mip chain
+        // is blitted from it afterwards and the image ends up shader read only, throws for an empty image
+        UploadQueue::Ticket uploadImage(const Context& instance, const Device& device, UploadQueue& queue,
+            Image& dstImage, std::span<const uint8_t> pixels);
+
+        const Buffer& getBuffer() const { return m_buffer; };
+        size_t getCapacity() const { return m_capacity; };
+        size_t getMaxChunkSize() const { return m_maxChunkSize; };
+        size_t getUsed() const { std::lock_guard<std::mutex> lock(m_mutex); return m_used; };
+
+    private:
+        Range allocateLocked(size_t size, size_t alignment, uint64_t owner);
+        void releaseLocked(uint64_t completedOwner);
+
+        Reservation reserveLocked(size_t size, size_t alignment, uint64_t owner);
+
+        // blocks until a range fits, flushing the queue and waiting on the oldest partition
+        Reservation acquire(const Context& instance, const Device& device, UploadQueue& queue,
+            size_t size, size_t alignment);
+
+        // called once the range of the reservation is recorded into the batch with the given ticket
+        void finishRecording(const Reservation& reservation, UploadQueue::Ticket ticket);
+    };
+
+}
@@ -0,0 +1,204 @@
+#include "TextureStreamer.h"
+
+namespace Graphics {
+
+    TextureStreamer::TextureStreamer(const Context& instance, const Device& device,
+        MT::ThreadPool& threadPool, MemoryAllocator& allocator,
+        UploadQueue& uploadQueue, StagingRing& stagingRing, const Sampler& sampler,
+        DescriptorSetHandle set, uint32_t binding, uint32_t capacity, uint32_t framesInFlight,
+        size_t uploadBudget /*= defaultUploadBudget*/) :
+        m_threadPool(&threadPool), m_allocator(&allocator), m_uploadQueue(&uploadQueue),
+        m_stagingRing(&stagingRing), m_sampler(&sampler), m_set(set), m_binding(binding),
+        m_capacity(capacity), m_uploadBudget(uploadBudget)
+    {
+        if (m_capacity < 2)
+            throw std::runtime_error("TextureStreamer::TextureStreamer() - Capacity has to leave room for the placeholder slot");
+
+        // mips are blitted with linear filtering, not every format supports that
+        vk::FormatProperties formatProperties = device.getPhysicalDevice().getHandle().getFormatProperties(
+            vk::Format::eR8G8B8A8Srgb, instance.getDispatchLoader());
+        m_generateMips = static_cast<bool>(formatProperties.optimalTilingFeatures &
+            vk::FormatFeatureFlagBits::eSampledImageFilterLinear);
+
+        m_textures.reserve(m_capacity);
+
+        createPlaceholder(instance, device);
+        m_table = BindlessTable(instance, device, m_set->getSet(), m_binding, m_capacity, framesInFlight,
+            m_placeholder, *m_sampler);
+        m_placeholderSlot = m_table.allocate();
+
+        m_initialized = true;
+    }
+
+    void TextureStreamer::createPlaceholder(const Context& instance, const Device& device)
+    {
+        constexpr size_t size = 8;
+        std::array<uint8_t, size * size * 4> pixels;
+        for (size_t y = 0; y < size; y++) {
+            for (size_t x = 0; x < size; x++) {
+                bool odd = ((x / 2) + (y / 2)) % 2;
+                uint8_t* pixel = &pixels[(y * size + x) * 4];
+                pixel[0] = odd ? 255 : 0;
+                pixel[1] = 0;
+                pixel[2] = odd ? 255 : 0;
+                pixel[3] = 255;
+            }
+        }
+
+        m_placeholder.create(instance, device, size, size);
+        m_placeholderAllocation = m_allocator->allocate(instance, device, m_placeholder, MemoryProperty::Bits::DeviceLocal);
+        m_placeholder.createView(instance, device);
+
+        // only done once at startup, fine to wait on it
+        UploadQueue::Ticket ticket = m_stagingRing->uploadImage(instance, device, *m_uploadQueue, m_placeholder, pixels);
+        m_uploadQueue->flush(instance, device);
+        m_uploadQueue->wait(instance, device, ticket);
+    }
+
+    void TextureStreamer::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        {
+            std::unique_lock<std::mutex> lock(m_pendingMutex);
+            m_pendingDone.wait(lock, [this]() { return m_pendingDecodes == 0; });
+        }
+
+        for (auto id : m_uploading)
+            m_uploadQueue->wait(instance, device, m_textures[id].ticket);
+        m_uploading.clear();
+
+        for (auto& decoded : m_decoded)
+            decoded.second.destroy(instance, device);
+        m_decoded.clear();
+        m_failed.clear();
+
+        for (auto& texture : m_textures) {
+            texture.image.destroy(instance, device);
+            m_allocator->free(instance, device, texture.allocation);
+        }
+        m_textures.clear();
+
+        m_table.destroy(instance, device);
+        m_placeholder.destroy(instance, device);
+        m_allocator->free(instance, device, m_placeholderAllocation);
+        m_set.reset();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed TextureStreamer" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    TextureStreamer::TextureId TextureStreamer::request(const std::string& filepath)
+    {
+        assert(m_initialized && "TextureStreamer::request() - TextureStreamer is not initialized");
+
+        TextureId id;
+        {
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+            if (m_textures.size() + 1 >= m_capacity)
+                throw std::runtime_error("TextureStreamer::request() - Out of texture slots");
+
+            id = static_cast<TextureId>(m_textures.size());
+            m_textures.emplace_back();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            m_pendingDecodes++;
+        }
+
+        auto task = [this, id, filepath]() {
+            Image image;
+            bool decoded = image.decode(filepath);
+            {
+                std::lock_guard<std::mutex> lock(m_decodedMutex);
+                if (decoded)
+                    m_decoded.emplace_back(id, std::move(image));
+                else
+                    m_failed.push_back(id);
+            }
+
+            std::lock_guard<std::mutex> lock(m_pendingMutex);
+            if (--m_pendingDecodes == 0)
+                m_pendingDone.notify_all();
+            };
+
+        // pool is shutting down, decode here instead of dropping the request
+        if (!m_threadPool->pushTask(task))
+            task();
+
+        return id;
+    }
+
+    void TextureStreamer::update(const Context& instance, const Device& device)
+    {
+        assert(m_initialized && "TextureStreamer::update() - TextureStreamer is not initialized");
+
+        std::vector<std::pair<TextureId, Image>> decoded;
+        {
+            std::lock_guard<std::mutex> lock(m_decodedMutex);
+
+            for (auto id : m_failed) {
+                m_textures[id].state = State::Failed;
+#ifdef _DEBUG
+                std::cout << "TextureStreamer failed to decode texture " << id << std::endl;
+#endif
+            }
+            m_failed.clear();
+
+            // big textures stay queued for the next update instead of stalling this frame,
+            // at least one goes through every update so nothing starves
+            size_t budget = 0;
+            size_t taken = 0;
+            while (taken < m_decoded.size() && (taken == 0 || budget + m_decoded[taken].second.getCapacity() <= m_uploadBudget)) {
+                budget += m_decoded[taken].second.getCapacity();
+                taken++;
+            }
+
+            decoded.reserve(taken);
+            for (size_t i = 0; i < taken; i++)
+                decoded.push_back(std::move(m_decoded[i]));
+            m_decoded.erase(m_decoded.begin(), m_decoded.begin() + taken);
+        }
+
+        for (auto& [id, image] : decoded) {
+            Texture& texture = m_textures[id];
+            texture.image = std::move(image);
+
+            uint32_t mipLevels = m_generateMips ?
+                Image::getFullMipLevels(texture.image.getWidth(), texture.image.getHeight()) : 1;
+            texture.image.create(instance, device, mipLevels);
+            texture.allocation = m_allocator->allocate(instance, device, texture.image, MemoryProperty::Bits::DeviceLocal);
+            texture.image.createView(instance, device);
+
+            texture.ticket = m_stagingRing->uploadImage(instance, device, *m_uploadQueue,
+                texture.image, texture.image.getPixelData());
+            texture.state = State::Uploading;
+            m_uploading.push_back(id);
+        }
+
+        if (!decoded.empty())
+            m_uploadQueue->flush(instance, device);
+
+        // a finished texture gets a slot no frame has sampled yet instead of patching the one frames in flight may
+        // still read the placeholder from, the table writes it below before getSlot() hands it out
+        std::erase_if(m_uploading, [&](TextureId id) {
+            Texture& texture = m_textures[id];
+            if (!m_uploadQueue->isComplete(instance, device, texture.ticket))
+                return false;
+
+            texture.slot = m_table.allocate();
+            assert(texture.slot != BindlessTable::invalidSlot && "TextureStreamer::update() - Out of bindless slots");
+            m_table.set(texture.slot, texture.image, *m_sampler);
+            texture.image.freePixels();
+            texture.state = State::Resident;
+            return true;
+            });
+
+        m_table.update(instance, device);
+    }
+
+}
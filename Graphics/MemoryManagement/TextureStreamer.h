@@ -0,0 +1,130 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/Sampler.h"
+#include "../Rendering/UploadQueue.h"
+#include "Image.h"
+#include "DescriptorSet.h"
+#include "DescriptorPool.h"
+#include "MemoryAllocator.h"
+#include "StagingRing.h"
+#include "BindlessTable.h"
+
+#include "MultiThreading/ThreadPool.h"
+
+#include <mutex>
+#include <condition_variable>
+
+namespace Graphics {
+
+    // streams textures into a bindless array (see BindlessImageSamplerDefinition)
+    // files are decoded on the thread pool, uploaded through the staging ring and upload queue,
+    // get a full mip chain blitted on the gpu and get a slot of their own in the BindlessTable once resident,
+    // until then getSlot() returns a slot that always points at a placeholder checkerboard
+    // a slot is written before any frame can sample it and never changes after, so pending frames never see it switch
+    // update() has to be called once per frame from the render thread after the frame's wait, request() from anywhere
+    class TextureStreamer
+    {
+    public:
+        using TextureId = uint32_t;
+
+        static constexpr size_t defaultUploadBudget = 32ull * 1024 * 1024;
+
+        enum class State
+        {
+            Loading,
+            Uploading,
+            Resident,
+            Failed,
+        };
+
+    private:
+        struct Texture
+        {
+            Image image;
+            Allocation allocation;
+            UploadQueue::Ticket ticket = 0;
+            BindlessTable::Slot slot = BindlessTable::invalidSlot;
+            State state = State::Loading;
+        };
+
+        MT::ThreadPool* m_threadPool = nullptr;
+        MemoryAllocator* m_allocator = nullptr;
+        UploadQueue* m_uploadQueue = nullptr;
+        StagingRing* m_stagingRing = nullptr;
+        const Sampler* m_sampler = nullptr;
+
+        DescriptorSetHandle m_set;
+        uint32_t m_binding = 0;
+        uint32_t m_capacity = 0;
+        size_t m_uploadBudget = 0;
+        bool m_generateMips = false;
+
+        Image m_placeholder;
+        Allocation m_placeholderAllocation;
+
+        BindlessTable m_table;
+        // allocated and never set, so it keeps pointing at the placeholder
+        BindlessTable::Slot m_placeholderSlot = BindlessTable::invalidSlot;
+
+        std::vector<Texture> m_textures;
+        std::vector<TextureId> m_uploading;
+
+        // filled by the workers, drained by update()
+        std::mutex m_decodedMutex;
+        std::vector<std::pair<TextureId, Image>> m_decoded;
+        std::vector<TextureId> m_failed;
+
+        std::mutex m_pendingMutex;
+        std::condition_variable m_pendingDone;
+        size_t m_pendingDecodes = 0;
+
+        bool m_initialized = false;
+    public:
+
+        TextureStreamer() {};
+
+        // every slot in [0, capacity) of the binding is owned by the streamer and starts out as the placeholder,
+        // one of them is kept for the placeholder so capacity - 1 textures fit
+        TextureStreamer(const Context& instance, const Device& device,
+            MT::ThreadPool& threadPool, MemoryAllocator& allocator,
+            UploadQueue& uploadQueue, StagingRing& stagingRing, const Sampler& sampler,
+            DescriptorSetHandle set, uint32_t binding, uint32_t capacity, uint32_t framesInFlight,
+            size_t uploadBudget = defaultUploadBudget);
+
+        // decode tasks hold a pointer to the streamer, so it stays where it was created
+        TextureStreamer(TextureStreamer&&) noexcept = delete;
+        TextureStreamer& operator=(TextureStreamer&&) noexcept = delete;
+
+        TextureStreamer(const TextureStreamer&) noexcept = delete;
+        TextureStreamer& operator=(const TextureStreamer&) noexcept = delete;
+
+        ~TextureStreamer() { assert(!m_initialized && "TextureStreamer was not destroyed!"); };
+
+        // waits for pending decodes and uploads before releasing everything
+        void destroy(const Context& instance, const Device& device);
+
+        // returns the id of the texture, usable right away through getSlot()
+        TextureId request(const std::string& filepath);
+
+        // creates and uploads decoded textures within the upload budget, gives finished ones their slot
+        // and writes it through the BindlessTable
+        void update(const Context& instance, const Device& device);
+
+        // the slot to sample the texture from in frames recorded after the last update(), the placeholder's until it is resident
+        BindlessTable::Slot getSlot(TextureId id) const
+        {
+            return m_textures[id].state == State::Resident ? m_textures[id].slot : m_placeholderSlot;
+        };
+
+        State getState(TextureId id) const { return m_textures[id].state; };
+        bool isResident(TextureId id) const { return m_textures[id].state == State::Resident; };
+        size_t getTextureCount() const { return m_textures.size(); };
+        uint32_t getCapacity() const { return m_capacity; };
+
+    private:
+        void createPlaceholder(const Context& instance, const Device& device);
+    };
+
+}
@@ -0,0 +1,279 @@
+#include "MeshOptimizer.h"
+
+namespace Graphics {
+
+    // Forsyth's vertex score, vertices used by the last triangle get a flat score so the next triangle
+    // doesn't just reuse the same edge, few remaining triangles boost a vertex so it gets finished off
+    static float scoreVertex(int32_t cachePosition, uint32_t remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+            return -1.0f;
+
+        float score = 0.0f;
+        if (cachePosition >= 0) {
+            if (cachePosition < 3)
+                score = 0.75f;
+            else
+                score = std::pow(1.0f - (cachePosition - 3) / float(MeshOptimizer::cacheSize - 3), 1.5f);
+        }
+
+        return score + 2.0f * std::pow(float(remainingTriangles), -0.5f);
+    }
+
+    void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        // triangles of every vertex in one flat array
+        std::vector<uint32_t> remaining(vertexCount, 0);
+        for (auto index : indices)
+            remaining[index]++;
+
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < vertexCount; i++)
+            offsets[i + 1] = offsets[i] + remaining[i];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+        std::vector<int32_t> cachePositions(vertexCount, -1);
+        std::vector<float> vertexScores(vertexCount);
+        for (size_t i = 0; i < vertexCount; i++)
+            vertexScores[i] = scoreVertex(-1, remaining[i]);
+
+        std::vector<float> triangleScores(triangleCount);
+        std::vector<bool> emitted(triangleCount, false);
+        int64_t best = -1;
+        for (size_t i = 0; i < triangleCount; i++) {
+            triangleScores[i] = vertexScores[indices[i * 3]] +
+                vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+            if (best < 0 || triangleScores[i] > triangleScores[best])
+                best = i;
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> nextCache;
+        cache.reserve(cacheSize + 3);
+        nextCache.reserve(cacheSize + 3);
+        size_t cursor = 0;
+
+        while (result.size() < indices.size()) {
+            // nothing in the cache has triangles left, continue with the next untouched triangle
+            if (best < 0) {
+                while (emitted[cursor])
+                    cursor++;
+                best = cursor;
+            }
+
+            emitted[best] = true;
+            nextCache.clear();
+            for (size_t k = 0; k < 3; k++) {
+                uint32_t vertex = indices[best * 3 + k];
+                result.push_back(vertex);
+                remaining[vertex]--;
+                if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+                    nextCache.push_back(vertex);
+            }
+            for (auto vertex : cache)
+                if (std::find(nextCache.begin(), nextCache.end(), vertex) == nextCache.end())
+                    nextCache.push_back(vertex);
+
+            // evicted vertices are rescored too since they lose their cache bonus
+            for (size_t i = 0; i < nextCache.size(); i++)
+                cachePositions[nextCache[i]] = i < cacheSize ? static_cast<int32_t>(i) : -1;
+
+            for (auto vertex : nextCache) {
+                float score = scoreVertex(cachePositions[vertex], remaining[vertex]);
+                float delta = score - vertexScores[vertex];
+                vertexScores[vertex] = score;
+                for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+                    triangleScores[adjacency[i]] += delta;
+            }
+
+            if (nextCache.size() > cacheSize)
+                nextCache.resize(cacheSize);
+            std::swap(cache, nextCache);
+
+            // only triangles touching the cache are candidates, scanning the whole mesh would make this quadratic
+            best = -1;
+            for (auto vertex : cache) {
+                for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++) {
+                    uint32_t triangle = adjacency[i];
+                    if (!emitted[triangle] && (best < 0 || triangleScores[triangle] > triangleScores[best]))
+                        best = triangle;
+                }
+            }
+        }
+
+        indices = std::move(result);
+    }
+
+    void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices,
+        const std::vector<glm::vec3>& positions, float threshold /*= 1.05f*/)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+            return;
+
+        // fifo cache simulation with timestamps, a vertex is a hit if it was transformed less than simulatedCacheSize misses ago,
+        // bumping the time past the cache size flushes it
+        std::vector<uint32_t> timestamps(positions.size(), 0);
+        uint32_t time = simulatedCacheSize + 1;
+        auto countMisses = [&](size_t triangle) {
+            uint32_t count = 0;
+            for (size_t k = 0; k < 3; k++) {
+                uint32_t vertex = indices[triangle * 3 + k];
+                if (time - timestamps[vertex] > simulatedCacheSize) {
+                    timestamps[vertex] = time++;
+                    count++;
+                }
+            }
+            return count;
+        };
+
+        // hard boundaries where the vertex cache optimizer started over and every vertex missed
+        std::vector<size_t> hardClusters;
+        size_t totalMisses = 0;
+        for (size_t i = 0; i < triangleCount; i++) {
+            uint32_t misses = countMisses(i);
+            if (i == 0 || misses == 3)
+                hardClusters.push_back(i);
+            totalMisses += misses;
+        }
+        hardClusters.push_back(triangleCount);
+
+        // clusters between them are split further as long as each piece, drawn from a cold cache,
+        // keeps its acmr within threshold of the mesh's so the reordering doesn't undo the cache pass
+        float limit = float(totalMisses) / triangleCount * threshold;
+        std::vector<size_t> clusters;
+        for (size_t c = 0; c + 1 < hardClusters.size(); c++) {
+            size_t clusterStart = hardClusters[c];
+            size_t clusterMisses = 0;
+            clusters.push_back(clusterStart);
+            time += simulatedCacheSize + 1;
+
+            for (size_t i = hardClusters[c]; i < hardClusters[c + 1]; i++) {
+                clusterMisses += countMisses(i);
+                if (i + 1 < hardClusters[c + 1] &&
+                    float(clusterMisses) / (i + 1 - clusterStart) <= limit) {
+                    clusterStart = i + 1;
+                    clusterMisses = 0;
+                    clusters.push_back(clusterStart);
+                    time += simulatedCacheSize + 1;
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        // area weighted centroid and normal of every cluster
+        struct Cluster
+        {
+            size_t begin;
+            size_t end;
+            float sortKey;
+        };
+
+        size_t clusterCount = clusters.size() - 1;
+        std::vector<glm::vec3> centroids(clusterCount, glm::vec3(0.0f));
+        std::vector<glm::vec3> normals(clusterCount, glm::vec3(0.0f));
+        std::vector<float> areas(clusterCount, 0.0f);
+        glm::vec3 meshCentroid(0.0f);
+        float meshArea = 0.0f;
+
+        for (size_t c = 0; c < clusterCount; c++) {
+            for (size_t i = clusters[c]; i < clusters[c + 1]; i++) {
+                const glm::vec3& a = positions[indices[i * 3]];
+                const glm::vec3& b = positions[indices[i * 3 + 1]];
+                const glm::vec3& d = positions[indices[i * 3 + 2]];
+
+                glm::vec3 normal = glm::cross(b - a, d - a);
+                float area = glm::length(normal);
+
+                centroids[c] += (a + b + d) * (area / 3.0f);
+                normals[c] += normal;
+                areas[c] += area;
+            }
+
+            meshCentroid += centroids[c];
+            meshArea += areas[c];
+        }
+        meshCentroid = meshArea > 0.0f ? meshCentroid / meshArea : glm::vec3(0.0f);
+
+        // clusters facing away from the middle of the mesh are likely to occlude the rest, so they go first
+        std::vector<Cluster> sorted(clusterCount);
+        for (size_t c = 0; c < clusterCount; c++) {
+            glm::vec3 centroid = areas[c] > 0.0f ? centroids[c] / areas[c] : centroids[c];
+            float normalLength = glm::length(normals[c]);
+            glm::vec3 normal = normalLength > 0.0f ? normals[c] / normalLength : glm::vec3(0.0f);
+            sorted[c] = { clusters[c], clusters[c + 1], glm::dot(centroid - meshCentroid, normal) };
+        }
+
+        std::stable_sort(sorted.begin(), sorted.end(),
+            [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+        for (const auto& cluster : sorted)
+            result.insert(result.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+        indices = std::move(result);
+    }
+
+    std::vector<uint32_t> MeshOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        std::vector<uint32_t> remap(vertexCount, unusedVertex);
+        uint32_t next = 0;
+        for (auto& index : indices) {
+            if (remap[index] == unusedVertex)
+                remap[index] = next++;
+            index = remap[index];
+        }
+        return remap;
+    }
+
+    float MeshOptimizer::computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return 0.0f;
+
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = simulatedCacheSize + 1;
+        size_t misses = 0;
+        for (auto index : indices) {
+            if (time - timestamps[index] > simulatedCacheSize) {
+                timestamps[index] = time++;
+                misses++;
+            }
+        }
+        return float(misses) / triangleCount;
+    }
+
+    MeshOptimizer::IndexData MeshOptimizer::packIndices(const std::vector<uint32_t>& indices, size_t vertexCount)
+    {
+        IndexData indexData;
+        indexData.count = static_cast<uint32_t>(indices.size());
+
+        if (vertexCount <= maxUint16Vertices) {
+            indexData.type = IndexType::Uint16;
+            indexData.data.resize(indices.size() * sizeof(uint16_t));
+            uint16_t* data = reinterpret_cast<uint16_t*>(indexData.data.data());
+            for (size_t i = 0; i < indices.size(); i++)
+                data[i] = static_cast<uint16_t>(indices[i]);
+        }
+        else {
+            indexData.type = IndexType::Uint32;
+            indexData.data.resize(indices.size() * sizeof(uint32_t));
+            std::memcpy(indexData.data.data(), indices.data(), indexData.data.size());
+        }
+
+        return indexData;
+    }
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include "Common.h"
+
+namespace Graphics {
+
+    // offline style mesh preprocessing, run once per mesh before it is uploaded
+    // triangles are reordered for the post transform vertex cache (Forsyth's greedy scoring),
+    // optionally grouped into clusters sorted outside in to cut overdraw (Tipsify style),
+    // then vertices are renumbered in first use order so fetches walk the vertex buffer linearly
+    class MeshOptimizer
+    {
+    public:
+        // cache size the scoring is tuned for, larger than most hardware caches which hurts them less than a smaller one
+        static constexpr uint32_t cacheSize = 32;
+
+        // fifo size used to find cluster boundaries and to measure acmr
+        static constexpr uint32_t simulatedCacheSize = 16;
+
+        // 0xFFFF is left out so it never collides with a primitive restart index
+        static constexpr size_t maxUint16Vertices = 0xFFFF;
+
+        static constexpr uint32_t unusedVertex = std::numeric_limits<uint32_t>::max();
+
+        struct Options
+        {
+            bool optimizeVertexCache = true;
+            bool optimizeOverdraw = false;
+            bool optimizeVertexFetch = true;
+
+            // how much worse than the mesh average a cluster's acmr may get when it is split further for overdraw sorting
+            float overdrawThreshold = 1.05f;
+        };
+
+        // indices ready for upload, 16 bit when every vertex fits
+        struct IndexData
+        {
+            IndexType type = IndexType::Uint32;
+            uint32_t count = 0;
+            std::vector<uint8_t> data;
+        };
+
+        // reorders the triangles in place
+        static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+
+        // reorders the clusters of an already cache optimized index list in place,
+        // positions are indexed by the same vertex ids as the indices
+        static void optimizeOverdraw(std::vector<uint32_t>& indices,
+            const std::vector<glm::vec3>& positions, float threshold = 1.05f);
+
+        // renumbers the indices in first use order and returns the old to new remap,
+        // vertices no triangle references map to unusedVertex
+        static std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t vertexCount);
+
+        // average cache miss ratio, transformed vertices per triangle on a fifo of simulatedCacheSize
+        static float computeAcmr(const std::vector<uint32_t>& indices, size_t vertexCount);
+
+        static IndexData packIndices(const std::vector<uint32_t>& indices, size_t vertexCount);
+
+        template <typename Vertex>
+        static std::vector<Vertex> remapVertices(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& remap)
+        {
+            size_t count = 0;
+            for (auto index : remap)
+                if (index != unusedVertex)
+                    count++;
+
+            std::vector<Vertex> result(count);
+            for (size_t i = 0; i < vertices.size(); i++)
+                if (remap[i] != unusedVertex)
+                    result[remap[i]] = vertices[i];
+            return result;
+        }
+
+        // runs every enabled pass and returns the packed indices, the vertices are rewritten in place,
+        // positionOf(vertex) -> glm::vec3 is only used by the overdraw pass
+        template <typename Vertex, typename PositionFunc>
+        static IndexData optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+            PositionFunc&& positionOf, const Options& options = Options())
+        {
+            if (options.optimizeVertexCache)
+                optimizeVertexCache(indices, vertices.size());
+
+            if (options.optimizeOverdraw) {
+                std::vector<glm::vec3> positions(vertices.size());
+                for (size_t i = 0; i < vertices.size(); i++)
+                    positions[i] = positionOf(vertices[i]);
+                optimizeOverdraw(indices, positions, options.overdrawThreshold);
+            }
+
+            if (options.optimizeVertexFetch)
+                vertices = remapVertices(vertices, optimizeVertexFetch(indices, vertices.size()));
+
+            return packIndices(indices, vertices.size());
+        }
+
+        template <typename Vertex>
+        static IndexData optimize(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+            const Options& options = Options())
+        {
+            assert(!options.optimizeOverdraw && "MeshOptimizer::optimize() - overdraw pass needs a position accessor");
+            return optimize(vertices, indices, [](const Vertex&) { return glm::vec3(0.0f); }, options);
+        }
+    };
+
+}
@@ -81,6 +81,7 @@ void Window::static_framebufferResizeCallback(GLFWwindow* window, int width, int
     auto* self = static_cast<Window*>(glfwGetWindowUserPointer(window));
     self->m_frameBufferExtent.width = width;
     self->m_frameBufferExtent.height = height;
+    self->m_frameBufferResized = true;
     self->m_platformEvents.emit<WindowEvents::FrameBufferResized>(width, height);
 }
 
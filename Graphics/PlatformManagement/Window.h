@@ -83,6 +83,9 @@ private:
     Graphics::Extent m_frameBufferExtent; //extent in pixels, represents actual physical window size, use this for rendering
     std::string m_windowText;
 
+    // set by every framebuffer resize event, consumed once per frame
+    bool m_frameBufferResized = false;
+
     Attributes m_attributes;
     EventManager m_platformEvents;
 
@@ -105,6 +108,7 @@ public:
         m_windowExtent = std::exchange(other.m_windowExtent, Graphics::Extent{ 0, 0 });
         m_frameBufferExtent = std::exchange(other.m_frameBufferExtent, Graphics::Extent{ 0, 0 });
         m_windowText = std::exchange(other.m_windowText, "");
+        m_frameBufferResized = std::exchange(other.m_frameBufferResized, false);
 
         m_attributes = std::exchange(other.m_attributes, Attributes());
         m_platformEvents = std::exchange(other.m_platformEvents, EventManager());
@@ -124,6 +128,7 @@ public:
             m_windowExtent = std::exchange(other.m_windowExtent, Graphics::Extent{ 0, 0 });
             m_frameBufferExtent = std::exchange(other.m_frameBufferExtent, Graphics::Extent{ 0, 0 });
             m_windowText = std::exchange(other.m_windowText, "");
+            m_frameBufferResized = std::exchange(other.m_frameBufferResized, false);
 
             m_attributes = std::exchange(other.m_attributes, Attributes());
             m_platformEvents = std::exchange(other.m_platformEvents, EventManager());
@@ -148,6 +153,10 @@ public:
     GLFWwindow* getWindowHandle() const { return m_window; };
     void destroy();
 
+    // returns true once if the framebuffer was resized since the last call, a drag that fires
+    // dozens of resize events between two frames only causes one swapchain recreation
+    bool consumeFrameBufferResize() { return std::exchange(m_frameBufferResized, false); };
+
     bool shouldClose() const
     {
         return glfwWindowShouldClose(m_window) == GLFW_TRUE;
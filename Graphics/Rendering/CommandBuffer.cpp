@@ -19,9 +19,36 @@ namespace Graphics {
 		}
 	}
 
+	void CommandBuffer::record(const Context& instance, const RenderPass& renderPass,
+		const SwapChain& swapChain, uint32_t imageIndex, uint32_t subpass /*= 0*/,
+		CommandBufferUsage::Flags flags /*= CommandBufferUsage::Bits::RenderPassContinue*/)
+	{
+		vk::CommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = vk::StructureType::eCommandBufferInheritanceInfo;
+		inheritanceInfo.renderPass = renderPass.getRenderPass();
+		inheritanceInfo.subpass = subpass;
+		inheritanceInfo.framebuffer = swapChain.getFrameBuffers()[imageIndex];
+		inheritanceInfo.occlusionQueryEnable = VK_FALSE;
+
+		vk::CommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = vk::StructureType::eCommandBufferBeginInfo;
+		beginInfo.flags = flags;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+		try {
+			m_commandBuffer.begin(beginInfo, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to begin recording secondary command buffer: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error when beginning recording secondary command buffer: " + std::string(e.what()));
+		}
+	}
+
 	void CommandBuffer::beginRenderPass(const Context& instance,
 		const RenderPass& renderPass, const SwapChain& swapChain,
-		uint32_t imageIndex, Color clearColor)
+		uint32_t imageIndex, Color clearColor, vk::SubpassContents contents /*= vk::SubpassContents::eInline*/)
 	{
 		vk::RenderPassBeginInfo renderPassInfo{};
 		renderPassInfo.sType = vk::StructureType::eRenderPassBeginInfo;
@@ -35,7 +62,7 @@ namespace Graphics {
 		renderPassInfo.pClearValues = &clear;
 		try {
 			m_commandBuffer.beginRenderPass(
-				renderPassInfo, vk::SubpassContents::eInline, instance.getDispatchLoader());
+				renderPassInfo, contents, instance.getDispatchLoader());
 		}
 		catch (const vk::SystemError& e) {
 			throw std::runtime_error("failed to begin render pass: " + std::string(e.what()));
@@ -47,7 +74,7 @@ namespace Graphics {
 
 	void CommandBuffer::beginRenderPass(const Context& instance,
 		const RenderPass& renderPass, const SwapChain& swapChain,
-		uint32_t imageIndex, Color clearColor, float clearDepth)
+		uint32_t imageIndex, Color clearColor, float clearDepth, vk::SubpassContents contents /*= vk::SubpassContents::eInline*/)
 	{
 		vk::RenderPassBeginInfo renderPassInfo{};
 		renderPassInfo.sType = vk::StructureType::eRenderPassBeginInfo;
@@ -62,7 +89,7 @@ namespace Graphics {
 		renderPassInfo.pClearValues = clears;
 		try {
 			m_commandBuffer.beginRenderPass(
-				renderPassInfo, vk::SubpassContents::eInline, instance.getDispatchLoader());
+				renderPassInfo, contents, instance.getDispatchLoader());
 		}
 		catch (const vk::SystemError& e) {
 			throw std::runtime_error("failed to begin render pass: " + std::string(e.what()));
@@ -86,11 +113,26 @@ namespace Graphics {
 		}
 	}
 
+	void CommandBuffer::bindPipeline(const Context& instance, const ComputePipeline& pipeline)
+	{
+		try {
+			m_commandBuffer.bindPipeline(
+				vk::PipelineBindPoint::eCompute, pipeline.getPipeline(), instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to bind compute pipeline: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error when binding compute pipeline: " + std::string(e.what()));
+		}
+	}
+
 	void CommandBuffer::bindIndexBuffer(const Context& instance,
-		const Buffer& buffer, vk::DeviceSize offset)
+		const Buffer& buffer, vk::DeviceSize offset, IndexType type /*= IndexType::Uint32*/)
 	{
 		try {
-			m_commandBuffer.bindIndexBuffer(buffer.getBuffer(), offset, vk::IndexType::eUint32, instance.getDispatchLoader());
+			m_commandBuffer.bindIndexBuffer(buffer.getBuffer(), offset,
+				static_cast<vk::IndexType>(type), instance.getDispatchLoader());
 		}
 		catch (const vk::SystemError& e) {
 			throw std::runtime_error("failed to bind index buffer: " + std::string(e.what()));
@@ -112,6 +154,93 @@ namespace Graphics {
 			pipeline.getLayout(), 0, descriptorSetsRaw, dynamicOffsets, instance.getDispatchLoader());
 	}
 
+	void CommandBuffer::bindDescriptorSets(const Context& instance,
+		const ComputePipeline& pipeline, const std::vector<DescriptorSetHandle>& descriptorSets,
+		const std::vector<uint32_t>& dynamicOffsets /*= {}*/)
+	{
+		auto descriptorSetsRaw = convert<vk::DescriptorSet>
+			(descriptorSets, [](const DescriptorSetHandle& set)
+				{ return set->getSet(); });
+
+		m_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+			pipeline.getLayout(), 0, descriptorSetsRaw, dynamicOffsets, instance.getDispatchLoader());
+	}
+
+	void CommandBuffer::bindDescriptorSets(const Context& instance,
+		const Pipeline& pipeline, const std::vector<DescriptorSetRef>& descriptorSets,
+		const std::vector<uint32_t>& dynamicOffsets /*= {}*/)
+	{
+		auto descriptorSetsRaw = convert<vk::DescriptorSet>
+			(descriptorSets, [](const DescriptorSetRef& set)
+				{ return set.getSet(); });
+
+		m_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+			pipeline.getLayout(), 0, descriptorSetsRaw, dynamicOffsets, instance.getDispatchLoader());
+	}
+
+	void CommandBuffer::bindDescriptorSets(const Context& instance,
+		const ComputePipeline& pipeline, const std::vector<DescriptorSetRef>& descriptorSets,
+		const std::vector<uint32_t>& dynamicOffsets /*= {}*/)
+	{
+		auto descriptorSetsRaw = convert<vk::DescriptorSet>
+			(descriptorSets, [](const DescriptorSetRef& set)
+				{ return set.getSet(); });
+
+		m_commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eCompute,
+			pipeline.getLayout(), 0, descriptorSetsRaw, dynamicOffsets, instance.getDispatchLoader());
+	}
+
+	void CommandBuffer::pushConstants(const Context& instance, const vk::PipelineLayout& layout,
+		const vk::PushConstantRange& range, const void* data)
+	{
+		m_commandBuffer.pushConstants(layout, range.stageFlags, range.offset, range.size,
+			data, instance.getDispatchLoader());
+	}
+
+	void CommandBuffer::dispatch(const Context& instance,
+		uint32_t groupCountX, uint32_t groupCountY /*= 1*/, uint32_t groupCountZ /*= 1*/)
+	{
+		try {
+			m_commandBuffer.dispatch(groupCountX, groupCountY, groupCountZ, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to record dispatch command: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error recording dispatch command: " + std::string(e.what()));
+		}
+	}
+
+	void CommandBuffer::setMemoryBarrier(const Context& instance,
+		vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage,
+		vk::AccessFlags srcAccess, vk::AccessFlags dstAccess)
+	{
+		vk::MemoryBarrier barrier{};
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = dstAccess;
+
+		m_commandBuffer.pipelineBarrier(
+			srcStage,
+			dstStage,
+			{}, 1, &barrier, 0, nullptr, 0, nullptr, instance.getDispatchLoader());
+	}
+
+	void CommandBuffer::updateBuffer(const Context& instance, const Buffer& buffer,
+		size_t offset, std::span<const uint8_t> data)
+	{
+		assert(data.size() % 4 == 0 && data.size() <= 65536 && "CommandBuffer::updateBuffer() - Invalid data size");
+
+		try {
+			m_commandBuffer.updateBuffer(buffer.getBuffer(), offset, data.size(), data.data(), instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to update buffer: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error when updating buffer: " + std::string(e.what()));
+		}
+	}
+
 	void CommandBuffer::setPipelineBarrier(const Context& instance,
 		vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage,
 		Image& image, vk::ImageLayout newLayout,
@@ -125,7 +254,7 @@ namespace Graphics {
 		barrier.image = image.getImage();
 		barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
 		barrier.subresourceRange.baseMipLevel = 0;
-		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.levelCount = image.getMipLevels();
 		barrier.subresourceRange.baseArrayLayer = 0;
 		barrier.subresourceRange.layerCount = 1;
 		barrier.srcAccessMask = srcAccess;
@@ -139,6 +268,76 @@ namespace Graphics {
 		image.setLayout(newLayout);
 	}
 
+	void CommandBuffer::generateMipmaps(const Context& instance, Image& image)
+	{
+		assert(image.getLayout() == vk::ImageLayout::eTransferDstOptimal && "CommandBuffer::generateMipmaps() - Image has to be in transfer dst layout");
+
+		vk::ImageMemoryBarrier barrier{};
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image.getImage();
+		barrier.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		int32_t width = static_cast<int32_t>(image.getWidth());
+		int32_t height = static_cast<int32_t>(image.getHeight());
+
+		for (uint32_t level = 1; level < image.getMipLevels(); level++) {
+			// the previous level is done being written, read from it
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+			barrier.newLayout = vk::ImageLayout::eTransferSrcOptimal;
+			barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+			barrier.dstAccessMask = vk::AccessFlagBits::eTransferRead;
+			m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eTransfer,
+				{}, 0, nullptr, 0, nullptr, 1, &barrier, instance.getDispatchLoader());
+
+			int32_t nextWidth = std::max(width / 2, 1);
+			int32_t nextHeight = std::max(height / 2, 1);
+
+			vk::ImageBlit blit{};
+			blit.srcOffsets[0] = vk::Offset3D{ 0, 0, 0 };
+			blit.srcOffsets[1] = vk::Offset3D{ width, height, 1 };
+			blit.srcSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			blit.srcSubresource.mipLevel = level - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = 1;
+			blit.dstOffsets[0] = vk::Offset3D{ 0, 0, 0 };
+			blit.dstOffsets[1] = vk::Offset3D{ nextWidth, nextHeight, 1 };
+			blit.dstSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+			blit.dstSubresource.mipLevel = level;
+			blit.dstSubresource.baseArrayLayer = 0;
+			blit.dstSubresource.layerCount = 1;
+
+			m_commandBuffer.blitImage(image.getImage(), vk::ImageLayout::eTransferSrcOptimal,
+				image.getImage(), vk::ImageLayout::eTransferDstOptimal,
+				1, &blit, vk::Filter::eLinear, instance.getDispatchLoader());
+
+			barrier.oldLayout = vk::ImageLayout::eTransferSrcOptimal;
+			barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+			barrier.srcAccessMask = vk::AccessFlagBits::eTransferRead;
+			barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+			m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+				{}, 0, nullptr, 0, nullptr, 1, &barrier, instance.getDispatchLoader());
+
+			width = nextWidth;
+			height = nextHeight;
+		}
+
+		// the last level was only ever written to
+		barrier.subresourceRange.baseMipLevel = image.getMipLevels() - 1;
+		barrier.oldLayout = vk::ImageLayout::eTransferDstOptimal;
+		barrier.newLayout = vk::ImageLayout::eShaderReadOnlyOptimal;
+		barrier.srcAccessMask = vk::AccessFlagBits::eTransferWrite;
+		barrier.dstAccessMask = vk::AccessFlagBits::eShaderRead;
+		m_commandBuffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+			{}, 0, nullptr, 0, nullptr, 1, &barrier, instance.getDispatchLoader());
+
+		image.setLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
+	}
+
 	void CommandBuffer::transferBufferData(const Context& instance, const Buffer& srcBuffer,
 		const Buffer& dstBuffer, const CopyRegion& copyRegion)
 	{
@@ -181,6 +380,32 @@ namespace Graphics {
 		}
 	}
 
+	void CommandBuffer::transferImageData(const Context& instance, const Buffer& srcBuffer,
+		Image& dstImage, size_t offset, vk::Offset3D imageOffset, vk::Extent3D imageExtent, uint32_t mipLevel /*= 0*/)
+	{
+		vk::BufferImageCopy region{};
+		region.bufferOffset = offset;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = vk::ImageAspectFlagBits::eColor;
+		region.imageSubresource.mipLevel = mipLevel;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = imageOffset;
+		region.imageExtent = imageExtent;
+
+		try {
+			m_commandBuffer.copyBufferToImage(srcBuffer.getBuffer(), dstImage.getImage(),
+				dstImage.getLayout(), 1, &region, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to transfer buffer data: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error when transferring buffer data: " + std::string(e.what()));
+		}
+	}
+
 	void CommandBuffer::setRenderView(const Context& instance, const RenderRegion& canvas)
 	{
 
@@ -225,6 +450,57 @@ namespace Graphics {
 		}
 	}
 
+	void CommandBuffer::drawIndexedIndirect(const Context& instance,
+		const Buffer& buffer, size_t offset, uint32_t drawCount, uint32_t stride /*= sizeof(vk::DrawIndexedIndirectCommand)*/)
+	{
+		try {
+			m_commandBuffer.drawIndexedIndirect(
+				buffer.getBuffer(), offset, drawCount, stride, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to record draw indexed indirect command: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error recording draw indexed indirect command: " + std::string(e.what()));
+		}
+	}
+
+	void CommandBuffer::drawIndexedIndirectCount(const Context& instance,
+		const Buffer& buffer, size_t offset, const Buffer& countBuffer, size_t countOffset,
+		uint32_t maxDrawCount, uint32_t stride /*= sizeof(vk::DrawIndexedIndirectCommand)*/)
+	{
+		assert(instance.getDispatchLoader().vkCmdDrawIndexedIndirectCountKHR &&
+			"CommandBuffer::drawIndexedIndirectCount() - DeviceFeature::DrawIndirectCount is not enabled");
+
+		try {
+			m_commandBuffer.drawIndexedIndirectCountKHR(buffer.getBuffer(), offset,
+				countBuffer.getBuffer(), countOffset, maxDrawCount, stride, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to record draw indexed indirect count command: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error recording draw indexed indirect count command: " + std::string(e.what()));
+		}
+	}
+
+	void CommandBuffer::executeCommands(const Context& instance, const std::vector<CommandBufferHandle>& commandBuffers)
+	{
+		auto commandBuffersRaw = convert<vk::CommandBuffer>
+			(commandBuffers, [](const CommandBufferHandle& buffer)
+				{ return buffer->getCommandBuffer(); });
+
+		try {
+			m_commandBuffer.executeCommands(commandBuffersRaw, instance.getDispatchLoader());
+		}
+		catch (const vk::SystemError& e) {
+			throw std::runtime_error("failed to execute secondary command buffers: " + std::string(e.what()));
+		}
+		catch (const std::exception& e) {
+			throw std::runtime_error("Unexpected error executing secondary command buffers: " + std::string(e.what()));
+		}
+	}
+
 	void CommandBuffer::endRenderPass(const Context& instance)
 	{
 		try {
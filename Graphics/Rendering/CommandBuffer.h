@@ -5,15 +5,20 @@
 #include "RenderPass.h"
 #include "SwapChain.h"
 #include "Pipeline.h"
+#include "ComputePipeline.h"
 #include "RenderRegion.h"
 #include "../MemoryManagement/Buffer.h"
 #include "../MemoryManagement/Image.h"
 #include "../MemoryManagement/DescriptorSet.h"
 #include "../MemoryManagement/DescriptorPool.h"
+#include "../MemoryManagement/DescriptorAllocator.h"
 
 namespace Graphics {
 
     class CommandPool;
+    class CommandBuffer;
+
+    using CommandBufferHandle = std::shared_ptr<CommandBuffer>;
 
     class CommandBuffer
     {
@@ -55,13 +60,25 @@ namespace Graphics {
         ~CommandBuffer() { assert(!m_isValid && "CommandBuffer was not deallocated!"); };
 
         void record(const Context& instance, CommandBufferUsage::Flags flags = 0);
+
+        // for secondary buffers, inherits the render pass, subpass and framebuffer it will be executed in
+        void record(const Context& instance, const RenderPass& renderPass,
+            const SwapChain& swapChain, uint32_t imageIndex, uint32_t subpass = 0,
+            CommandBufferUsage::Flags flags = CommandBufferUsage::Bits::RenderPassContinue);
+
+        // pass eSecondaryCommandBuffers as contents when the pass is filled through executeCommands
         void beginRenderPass(const Context& instance, const RenderPass& renderPass,
-            const SwapChain& swapChain, uint32_t imageIndex, Color clearColor);
+            const SwapChain& swapChain, uint32_t imageIndex, Color clearColor,
+            vk::SubpassContents contents = vk::SubpassContents::eInline);
 
         void beginRenderPass(const Context& instance, const RenderPass& renderPass,
-            const SwapChain& swapChain, uint32_t imageIndex, Color clearColor, float clearDepth);
+            const SwapChain& swapChain, uint32_t imageIndex, Color clearColor, float clearDepth,
+            vk::SubpassContents contents = vk::SubpassContents::eInline);
+
+        void executeCommands(const Context& instance, const std::vector<CommandBufferHandle>& commandBuffers);
 
         void bindPipeline(const Context& instance, const Pipeline& pipeline);
+        void bindPipeline(const Context& instance, const ComputePipeline& pipeline);
 
         template<size_t bufferAmount>
         void bindVertexBuffers(const Context& instance,
@@ -78,29 +95,92 @@ namespace Graphics {
         }
 
         void bindIndexBuffer(const Context& instance,
-            const Buffer& buffer, vk::DeviceSize offset);
+            const Buffer& buffer, vk::DeviceSize offset, IndexType type = IndexType::Uint32);
 
         void bindDescriptorSets(const Context& instance,
             const Pipeline& pipeline, const std::vector<DescriptorSetHandle>& descriptorSets,
             const std::vector<uint32_t>& dynamicOffsets = {});
 
+        void bindDescriptorSets(const Context& instance,
+            const ComputePipeline& pipeline, const std::vector<DescriptorSetHandle>& descriptorSets,
+            const std::vector<uint32_t>& dynamicOffsets = {});
+
+        void bindDescriptorSets(const Context& instance,
+            const Pipeline& pipeline, const std::vector<DescriptorSetRef>& descriptorSets,
+            const std::vector<uint32_t>& dynamicOffsets = {});
+
+        void bindDescriptorSets(const Context& instance,
+            const ComputePipeline& pipeline, const std::vector<DescriptorSetRef>& descriptorSets,
+            const std::vector<uint32_t>& dynamicOffsets = {});
+
+        // pushes a block declared with a PushConstantDefinition, the pipeline has to be created with it
+        template <PushConstantDefinition Def>
+        void pushConstants(const Context& instance, const Pipeline& pipeline, const typename Def::Type& value) {
+            pushConstants(instance, pipeline.getLayout(), Def::getPushConstantRange(), &value);
+        };
+
+        template <PushConstantDefinition Def>
+        void pushConstants(const Context& instance, const ComputePipeline& pipeline, const typename Def::Type& value) {
+            pushConstants(instance, pipeline.getLayout(), Def::getPushConstantRange(), &value);
+        };
+
+        // untyped version for layouts that don't go through definitions
+        template <typename T>
+        void pushConstants(const Context& instance, const vk::PipelineLayout& layout,
+            vk::ShaderStageFlags stages, const T& value, uint32_t offset = 0) {
+            static_assert(std::is_trivially_copyable_v<T>, "push constants are copied as raw bytes");
+            pushConstants(instance, layout, vk::PushConstantRange(stages, offset, sizeof(T)), &value);
+        };
+
+        void pushConstants(const Context& instance, const vk::PipelineLayout& layout,
+            const vk::PushConstantRange& range, const void* data);
+
+        void dispatch(const Context& instance, uint32_t groupCountX, uint32_t groupCountY = 1, uint32_t groupCountZ = 1);
+
+        // global memory barrier, for buffers written and read by different stages of the same queue
+        void setMemoryBarrier(const Context& instance,
+            vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage,
+            vk::AccessFlags srcAccess, vk::AccessFlags dstAccess);
+
+        // writes small data inline from the command buffer, size has to be a multiple of 4 and at most 64KiB,
+        // must be recorded outside of a render pass
+        void updateBuffer(const Context& instance, const Buffer& buffer, size_t offset, std::span<const uint8_t> data);
+
         void setPipelineBarrier(const Context& instance,
             vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage,
             Image& image, vk::ImageLayout newLayout,
             vk::AccessFlags srcAccess, vk::AccessFlags dstAccess);
 
+        // expects mip 0 filled and the whole image in transfer dst, blits every level from the one above
+        // and leaves the image shader read only
+        void generateMipmaps(const Context& instance, Image& image);
+
         void transferBufferData(const Context& instance, const Buffer& srcBuffer,
             const Buffer& dstBuffer, const CopyRegion& copyRegion);
 
         void transferImageData(const Context& instance, const Buffer& srcBuffer,
             Image& dstImage, size_t offset = 0, vk::Offset3D imageOffset = { 0, 0, 0 });
 
+        // copies tightly packed texels into a sub region of one mip level
+        void transferImageData(const Context& instance, const Buffer& srcBuffer,
+            Image& dstImage, size_t offset, vk::Offset3D imageOffset, vk::Extent3D imageExtent, uint32_t mipLevel = 0);
+
         void setRenderView(const Context& instance, const RenderRegion& canvas);
         void draw(const Context& instance,
             size_t vertexCount, size_t instanceCount, size_t firstVertex, size_t firstInstance);
         void drawIndexed(const Context& instance,
             size_t indexCount, size_t instanceCount, size_t firstIndex, size_t indexIncrement, size_t firstInstance);
 
+        // reads drawCount VkDrawIndexedIndirectCommand records from buffer, drawCount > 1 needs MultiDrawIndirect
+        void drawIndexedIndirect(const Context& instance,
+            const Buffer& buffer, size_t offset, uint32_t drawCount,
+            uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand));
+
+        // same but the draw count is read from countBuffer on the gpu, needs DeviceFeature::DrawIndirectCount
+        void drawIndexedIndirectCount(const Context& instance,
+            const Buffer& buffer, size_t offset, const Buffer& countBuffer, size_t countOffset,
+            uint32_t maxDrawCount, uint32_t stride = sizeof(vk::DrawIndexedIndirectCommand));
+
         void endRenderPass(const Context& instance);
         void stopRecord(const Context& instance);
         void reset(const Context& instance);
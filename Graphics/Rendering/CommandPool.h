@@ -8,7 +8,6 @@
 
 namespace Graphics {
 
-    using CommandBufferHandle = std::shared_ptr<CommandBuffer>;
     class Queue;
 
     class CommandPool
@@ -106,6 +105,12 @@ namespace Graphics {
             m_allocatedBuffers.clear();
         }
 
+        // resets every buffer of the pool back to the initial state in one call,
+        // unlike reset() the buffers stay allocated and can be recorded again
+        void recycle(const Context& instance, const Device& device) {
+            device.getDevice().resetCommandPool(m_pool, vk::CommandPoolResetFlags(), instance.getDispatchLoader());
+        }
+
         void makeOneTimeSubmit(const Context& instance, const Device& device,
             const Queue& queue, std::function<void(const CommandBufferHandle&)>&& func);
 
@@ -0,0 +1,60 @@
+#include "ComputePipeline.h"
+
+namespace Graphics {
+
+    ComputePipeline::ComputePipeline(const Context& instance, const Device& device, const Shader& shader,
+        const std::vector<const DescriptorSetLayout*>& layouts,
+        const std::vector<vk::PushConstantRange>& pushConstantRanges, const PipelineCache* cache /*= nullptr*/)
+    {
+        if (shader.getType() != Shader::Type::Compute)
+            throw std::runtime_error("ComputePipeline::ComputePipeline() - Shader is not a compute shader");
+
+        auto layoutsRaw = convert<vk::DescriptorSetLayout>
+            (layouts, [](const DescriptorSetLayout* layout)
+                {
+                    return layout->getLayout();
+                });
+
+        vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
+        pipelineLayoutInfo.sType = vk::StructureType::ePipelineLayoutCreateInfo;
+        pipelineLayoutInfo.setLayoutCount = layoutsRaw.size();
+        pipelineLayoutInfo.pSetLayouts = layoutsRaw.data();
+        pipelineLayoutInfo.pushConstantRangeCount = pushConstantRanges.size();
+        pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
+
+        try {
+            m_pipelineLayout = device.getDevice()
+                .createPipelineLayout(pipelineLayoutInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to create compute pipeline layout: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when creating a compute pipeline layout: " + std::string(e.what()));
+        }
+
+        vk::PipelineShaderStageCreateInfo stageInfo{};
+        stageInfo.sType = vk::StructureType::ePipelineShaderStageCreateInfo;
+        stageInfo.stage = vk::ShaderStageFlagBits::eCompute;
+        stageInfo.module = shader.getModule();
+        stageInfo.pName = "main";
+
+        vk::ComputePipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = vk::StructureType::eComputePipelineCreateInfo;
+        pipelineInfo.stage = stageInfo;
+        pipelineInfo.layout = m_pipelineLayout;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        pipelineInfo.basePipelineIndex = -1;
+
+        auto result = device.getDevice().createComputePipeline(
+            cache ? cache->getCache() : vk::PipelineCache(), pipelineInfo, nullptr, instance.getDispatchLoader());
+        if (result.result != vk::Result::eSuccess) {
+            device.getDevice().destroyPipelineLayout(m_pipelineLayout, nullptr, instance.getDispatchLoader());
+            throw std::runtime_error("Failed to create compute pipeline!");
+        }
+
+        m_pipeline = result.value;
+        m_initialized = true;
+    }
+
+}
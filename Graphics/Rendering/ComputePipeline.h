@@ -0,0 +1,77 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "Shader.h"
+#include "DescriptorSetLayout.h"
+#include "PipelineCache.h"
+
+namespace Graphics {
+
+    class ComputePipeline
+    {
+    private:
+        vk::Pipeline m_pipeline = nullptr;
+        vk::PipelineLayout m_pipelineLayout = nullptr;
+        bool m_initialized = false;
+
+    public:
+        ComputePipeline() {};
+
+        ComputePipeline(const Context& instance, const Device& device, const Shader& shader,
+            const std::vector<const DescriptorSetLayout*>& layouts, const PipelineCache* cache = nullptr) :
+            ComputePipeline(instance, device, shader, layouts, std::vector<vk::PushConstantRange>(), cache) {};
+
+        template <PushConstantDefinition... PushConstantDefs>
+        ComputePipeline(const Context& instance, const Device& device, const Shader& shader,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const PushConstantDefinitions<PushConstantDefs...>& pushConstants, const PipelineCache* cache = nullptr) :
+            ComputePipeline(instance, device, shader, layouts, pushConstants.enumerateRanges(), cache) {};
+
+        ComputePipeline(const Context& instance, const Device& device, const Shader& shader,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const std::vector<vk::PushConstantRange>& pushConstantRanges, const PipelineCache* cache = nullptr);
+
+        ComputePipeline(ComputePipeline&& other) noexcept {
+            m_pipeline = std::exchange(other.m_pipeline, nullptr);
+            m_pipelineLayout = std::exchange(other.m_pipelineLayout, nullptr);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized pipeline is undefined behavior, destroy before moving
+        ComputePipeline& operator=(ComputePipeline&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "ComputePipeline::operator=() - ComputePipeline already initialized");
+
+            m_pipeline = std::exchange(other.m_pipeline, nullptr);
+            m_pipelineLayout = std::exchange(other.m_pipelineLayout, nullptr);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        ComputePipeline(const ComputePipeline& other) noexcept = delete;
+        ComputePipeline& operator=(const ComputePipeline& other) noexcept = delete;
+
+        ~ComputePipeline() { assert(!m_initialized && "ComputePipeline was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device) {
+            if (!m_initialized)
+                return;
+
+            device.getDevice().destroyPipelineLayout(m_pipelineLayout, nullptr, instance.getDispatchLoader());
+            device.getDevice().destroyPipeline(m_pipeline, nullptr, instance.getDispatchLoader());
+#ifdef _DEBUG
+            std::cout << "Destroyed ComputePipeline" << std::endl;
+#endif
+            m_initialized = false;
+        }
+
+        const vk::Pipeline& getPipeline() const { return m_pipeline; };
+        const vk::PipelineLayout& getLayout() const { return m_pipelineLayout; };
+    };
+
+}
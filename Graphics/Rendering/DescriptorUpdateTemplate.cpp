@@ -0,0 +1,83 @@
+#include "DescriptorUpdateTemplate.h"
+
+namespace Graphics {
+
+    DescriptorUpdateTemplate::Data& DescriptorUpdateTemplate::Data::setBuffer(uint32_t binding, const Buffer& buffer,
+        size_t offset, size_t range, uint32_t arrayElement /*= 0*/)
+    {
+        Slot& slot = getSlot(binding, arrayElement);
+        slot.buffer.buffer = buffer.getBuffer();
+        slot.buffer.offset = offset;
+        slot.buffer.range = range;
+        return *this;
+    }
+
+    DescriptorUpdateTemplate::Data& DescriptorUpdateTemplate::Data::setImage(uint32_t binding, const Image& image,
+        const Sampler& sampler, uint32_t arrayElement /*= 0*/)
+    {
+        Slot& slot = getSlot(binding, arrayElement);
+        slot.image.sampler = sampler.getSampler();
+        slot.image.imageView = image.getView();
+        slot.image.imageLayout = static_cast<VkImageLayout>(image.getLayout());
+        return *this;
+    }
+
+    DescriptorUpdateTemplate::Slot& DescriptorUpdateTemplate::Data::getSlot(uint32_t binding, uint32_t arrayElement)
+    {
+        for (const auto& bindingSlots : m_bindings) {
+            if (bindingSlots.binding != binding)
+                continue;
+            if (arrayElement >= bindingSlots.count)
+                throw std::runtime_error("array element out of range");
+            return m_slots[bindingSlots.firstSlot + arrayElement];
+        }
+
+        throw std::runtime_error("invalid binding");
+    }
+
+    void DescriptorUpdateTemplate::create(const Context& instance, const Device& device,
+        const DescriptorSetLayout& layout, const std::vector<vk::DescriptorUpdateTemplateEntry>& entries)
+    {
+        if (entries.empty())
+            throw std::runtime_error("DescriptorUpdateTemplate::create() - Every binding is partially bound, there is nothing to template");
+
+        vk::DescriptorUpdateTemplateCreateInfo createInfo{};
+        createInfo.sType = vk::StructureType::eDescriptorUpdateTemplateCreateInfo;
+        createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+        createInfo.pDescriptorUpdateEntries = entries.data();
+        createInfo.templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+        createInfo.descriptorSetLayout = layout.getLayout();
+
+        try {
+            m_template = device.getDevice().createDescriptorUpdateTemplate(createInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("Failed to create descriptor update template: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when creating a descriptor update template: " + std::string(e.what()));
+        }
+
+        m_initialized = true;
+    }
+
+    void DescriptorUpdateTemplate::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        device.getDevice().destroyDescriptorUpdateTemplate(m_template, nullptr, instance.getDispatchLoader());
+
+#ifdef _DEBUG
+        std::cout << "Destroyed DescriptorUpdateTemplate" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    void DescriptorUpdateTemplate::update(const Context& instance, const Device& device,
+        vk::DescriptorSet set, const Data& data) const
+    {
+        device.getDevice().updateDescriptorSetWithTemplate(set, m_template, data.data(), instance.getDispatchLoader());
+    }
+
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "DescriptorSetLayout.h"
+#include "Sampler.h"
+#include "../BufferDataLayouts.h"
+#include "../MemoryManagement/Buffer.h"
+#include "../MemoryManagement/Image.h"
+#include "../MemoryManagement/DescriptorSet.h"
+#include "../MemoryManagement/DescriptorAllocator.h"
+
+namespace Graphics {
+
+    // vk::DescriptorUpdateTemplate built from the same DescriptorDefinitions as the layout,
+    // every descriptor of the set gets a fixed slot in a packed array so a whole set is updated
+    // from one block of memory in one call
+    // partially bound bindings (bindless arrays) are left out, those are written element by element,
+    // a set made of nothing but those has no template and throws
+    class DescriptorUpdateTemplate
+    {
+    public:
+        // one descriptor worth of data, the template reads whichever member matches the binding type
+        union Slot
+        {
+            VkDescriptorBufferInfo buffer;
+            VkDescriptorImageInfo image;
+            VkBufferView texelBuffer;
+        };
+
+        struct BindingSlots
+        {
+            uint32_t binding;
+            uint32_t firstSlot;
+            uint32_t count;
+            vk::DescriptorType type;
+        };
+
+        // cpu side copy of a set's descriptors, fill it once and update as many sets from it as needed
+        // keeps its own copy of the slot layout, so it stays valid when the template is moved
+        class Data
+        {
+        private:
+            std::vector<BindingSlots> m_bindings;
+            std::vector<Slot> m_slots;
+
+        public:
+            Data() {};
+            Data(const DescriptorUpdateTemplate& updateTemplate) :
+                m_bindings(updateTemplate.getBindings()), m_slots(updateTemplate.getSlotCount(), Slot{}) {};
+
+            Data& setBuffer(uint32_t binding, const Buffer& buffer,
+                size_t offset, size_t range, uint32_t arrayElement = 0);
+
+            Data& setImage(uint32_t binding, const Image& image,
+                const Sampler& sampler, uint32_t arrayElement = 0);
+
+            const void* data() const { return m_slots.data(); };
+            size_t size() const { return m_slots.size() * sizeof(Slot); };
+
+        private:
+            Slot& getSlot(uint32_t binding, uint32_t arrayElement);
+        };
+
+    private:
+        vk::DescriptorUpdateTemplate m_template = nullptr;
+        std::vector<BindingSlots> m_bindings;
+        uint32_t m_slotCount = 0;
+
+        bool m_initialized = false;
+
+    public:
+
+        DescriptorUpdateTemplate() {};
+
+        template <DescriptorDefinition... DescriptorDefs>
+        DescriptorUpdateTemplate(const Context& instance, const Device& device,
+            const DescriptorSetLayout& layout, const DescriptorDefinitions<DescriptorDefs...>& descriptors) {
+
+            auto bindings = descriptors.enumerateDescriptors();
+            auto bindingFlags = descriptors.enumerateBindingFlags();
+
+            std::vector<vk::DescriptorUpdateTemplateEntry> entries;
+            entries.reserve(bindings.size());
+            for (size_t i = 0; i < bindings.size(); i++) {
+                if (bindingFlags[i] & vk::DescriptorBindingFlagBits::ePartiallyBound)
+                    continue;
+
+                vk::DescriptorUpdateTemplateEntry entry{};
+                entry.dstBinding = bindings[i].binding;
+                entry.dstArrayElement = 0;
+                entry.descriptorCount = bindings[i].descriptorCount;
+                entry.descriptorType = bindings[i].descriptorType;
+                entry.offset = m_slotCount * sizeof(Slot);
+                entry.stride = sizeof(Slot);
+                entries.push_back(entry);
+
+                m_bindings.push_back({ bindings[i].binding, m_slotCount,
+                    bindings[i].descriptorCount, bindings[i].descriptorType });
+                m_slotCount += bindings[i].descriptorCount;
+            }
+
+            create(instance, device, layout, entries);
+        };
+
+        DescriptorUpdateTemplate(DescriptorUpdateTemplate&& other) noexcept {
+            m_template = std::exchange(other.m_template, nullptr);
+            m_bindings = std::exchange(other.m_bindings, {});
+            m_slotCount = std::exchange(other.m_slotCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized template is undefined behavior, destroy before moving
+        DescriptorUpdateTemplate& operator=(DescriptorUpdateTemplate&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized &&
+                "DescriptorUpdateTemplate::operator=() - DescriptorUpdateTemplate already initialized");
+
+            m_template = std::exchange(other.m_template, nullptr);
+            m_bindings = std::exchange(other.m_bindings, {});
+            m_slotCount = std::exchange(other.m_slotCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        DescriptorUpdateTemplate(const DescriptorUpdateTemplate&) noexcept = delete;
+        DescriptorUpdateTemplate& operator=(const DescriptorUpdateTemplate&) noexcept = delete;
+
+        ~DescriptorUpdateTemplate() { assert(!m_initialized && "DescriptorUpdateTemplate was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        Data createData() const { return Data(*this); };
+
+        void update(const Context& instance, const Device& device, vk::DescriptorSet set, const Data& data) const;
+
+        void update(const Context& instance, const Device& device, const DescriptorSetRef& set, const Data& data) const {
+            update(instance, device, set.getSet(), data);
+        };
+
+        void update(const Context& instance, const Device& device, const DescriptorSet& set, const Data& data) const {
+            update(instance, device, set.getSet(), data);
+        };
+
+        const vk::DescriptorUpdateTemplate& getTemplate() const { return m_template; };
+        const std::vector<BindingSlots>& getBindings() const { return m_bindings; };
+        uint32_t getSlotCount() const { return m_slotCount; };
+
+    private:
+        void create(const Context& instance, const Device& device, const DescriptorSetLayout& layout,
+            const std::vector<vk::DescriptorUpdateTemplateEntry>& entries);
+    };
+
+}
@@ -15,6 +15,8 @@ namespace Graphics {
 	private:
 		const PhysicalDevice* m_physicalDevice = nullptr;
 		vk::Device m_device = nullptr;
+		std::array<bool, static_cast<size_t>(DeviceFeature::FeaturesNum)> m_enabledFeatures = {};
+		std::set<std::string> m_enabledExtensions;
 
 		bool m_initialized = false;
 
@@ -126,12 +128,20 @@ namespace Graphics {
 			//vertexInputDynamicFeatures.pNext = &zeroInitializeFeatures;
 			zeroInitializeFeatures.pNext = nullptr;  // End of chain
 
-			for (const auto& feature : requirements.features)
+			for (const auto& feature : requirements.features) {
 				featureSetTaskTable[static_cast<size_t>(feature.first)](features2, feature.second);
+				m_enabledFeatures[static_cast<size_t>(feature.first)] = feature.second.type() != typeid(bool) ||
+					std::any_cast<bool>(feature.second);
+			}
+			m_enabledExtensions = requirements.extensions;
+
+			// no feature struct to set, the commands come with the extension
+			if (isFeatureEnabled(DeviceFeature::DrawIndirectCount))
+				m_enabledExtensions.insert(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
 
 			std::vector<const char*> extensionsCStr;
-			extensionsCStr.reserve(requirements.extensions.size());
-			for (const auto& extension : requirements.extensions) {
+			extensionsCStr.reserve(m_enabledExtensions.size());
+			for (const auto& extension : m_enabledExtensions) {
 				extensionsCStr.push_back(extension.c_str());
 			}
 
@@ -141,7 +151,7 @@ namespace Graphics {
 			createInfo.pQueueCreateInfos = queueCreateInfos.data();
 			createInfo.pEnabledFeatures = &features2.features;
 
-			createInfo.enabledExtensionCount = static_cast<uint32_t>(requirements.extensions.size());
+			createInfo.enabledExtensionCount = static_cast<uint32_t>(m_enabledExtensions.size());
 			createInfo.ppEnabledExtensionNames = extensionsCStr.data();
 
 			createInfo.pNext = features2.pNext;
@@ -168,6 +178,8 @@ namespace Graphics {
 
 			m_physicalDevice = std::exchange(other.m_physicalDevice, nullptr);
 			m_device = std::exchange(other.m_device, nullptr);
+			m_enabledFeatures = std::exchange(other.m_enabledFeatures, {});
+			m_enabledExtensions = std::exchange(other.m_enabledExtensions, {});
 			m_initialized = std::exchange(other.m_initialized, false);
 
 		};
@@ -182,6 +194,8 @@ namespace Graphics {
 
 			m_physicalDevice = std::exchange(other.m_physicalDevice, nullptr);
 			m_device = std::exchange(other.m_device, nullptr);
+			m_enabledFeatures = std::exchange(other.m_enabledFeatures, {});
+			m_enabledExtensions = std::exchange(other.m_enabledExtensions, {});
 			m_initialized = std::exchange(other.m_initialized, false);
 
 			return *this;
@@ -208,6 +222,10 @@ namespace Graphics {
 		const vk::Device& getDevice() const { return m_device; }
 		const PhysicalDevice& getPhysicalDevice() const { return *m_physicalDevice; }
 
+		// whether a feature was requested when the device was created, not just supported
+		bool isFeatureEnabled(DeviceFeature feature) const { return m_enabledFeatures[static_cast<size_t>(feature)]; }
+		bool isExtensionEnabled(const std::string& extension) const { return m_enabledExtensions.contains(extension); }
+
 		void waitIdle(const Context& instance) const {
 			m_device.waitIdle(instance.getDispatchLoader());
 		};
@@ -33,4 +33,14 @@ namespace Graphics {
 	{
 		device.getDevice().resetFences(m_fence, instance.getDispatchLoader());
 	}
+
+	bool Fence::isSignaled(const Context& instance, const Device& device) const
+	{
+		vk::Result result = device.getDevice().getFenceStatus(m_fence, instance.getDispatchLoader());
+		if (result == vk::Result::eSuccess)
+			return true;
+		if (result == vk::Result::eNotReady)
+			return false;
+		throw std::runtime_error("Error querying fence status: " + vk::to_string(result));
+	}
 }
\ No newline at end of file
@@ -58,6 +58,9 @@ namespace Graphics {
         void wait(const Context& instance, const Device& device);
         void reset(const Context& instance, const Device& device);
 
+        // non blocking status query
+        bool isSignaled(const Context& instance, const Device& device) const;
+
         vk::Fence getFence() const { return m_fence; };
 
     };
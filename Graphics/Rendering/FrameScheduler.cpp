@@ -0,0 +1,161 @@
+#include "FrameScheduler.h"
+
+namespace Graphics {
+
+    FrameScheduler::FrameScheduler(const Context& instance, const Device& device,
+        const std::vector<std::reference_wrapper<const Queue>>& queues, uint32_t framesInFlight)
+    {
+        if (framesInFlight == 0)
+            throw std::runtime_error("FrameScheduler::FrameScheduler() - framesInFlight has to be at least 1");
+
+        if (!device.isFeatureEnabled(DeviceFeature::TimelineSemaphore))
+            throw std::runtime_error("FrameScheduler::FrameScheduler() - DeviceFeature::TimelineSemaphore is not enabled");
+
+        for (const auto& queue : queues) {
+            bool known = std::any_of(m_timelines.begin(), m_timelines.end(), [&](const Timeline& timeline) {
+                return timeline.family == queue.get().getFamily() && timeline.index == queue.get().getIndex();
+                });
+            if (known)
+                continue;
+
+            Timeline& timeline = m_timelines.emplace_back();
+            timeline.family = queue.get().getFamily();
+            timeline.index = queue.get().getIndex();
+            timeline.semaphore = TimelineSemaphore(instance, device);
+        }
+
+        m_frames.resize(framesInFlight);
+        for (auto& frame : m_frames) {
+            frame.imageAvailable = Semaphore(instance, device);
+            frame.renderFinished = Semaphore(instance, device);
+            frame.values.resize(m_timelines.size(), 0);
+        }
+
+        // first beginFrame wraps around to slot 0
+        m_frameIndex = framesInFlight - 1;
+        m_initialized = true;
+    }
+
+    void FrameScheduler::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        waitIdle(instance, device);
+
+        for (auto& frame : m_frames) {
+            frame.imageAvailable.destroy(instance, device);
+            frame.renderFinished.destroy(instance, device);
+        }
+        m_frames.clear();
+
+        for (auto& timeline : m_timelines)
+            timeline.semaphore.destroy(instance, device);
+        m_timelines.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed FrameScheduler" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    uint32_t FrameScheduler::beginFrame(const Context& instance, const Device& device)
+    {
+        assert(m_initialized && "FrameScheduler::beginFrame() - FrameScheduler is not initialized");
+
+        m_frameIndex = (m_frameIndex + 1) % m_frames.size();
+        m_frameNumber++;
+
+        waitTimelines(instance, device, m_frames[m_frameIndex].values, UINT64_MAX);
+        return m_frameIndex;
+    }
+
+    FrameScheduler::Value FrameScheduler::submit(const Context& instance, const Queue& queue,
+        const std::vector<vk::PipelineStageFlags>& waitStages,
+        const std::vector<std::reference_wrapper<const Semaphore>>& waitSemaphores,
+        const std::vector<std::reference_wrapper<const CommandBufferHandle>>& commandBuffers,
+        const std::vector<std::reference_wrapper<const Semaphore>>& signalSemaphores,
+        const std::vector<Dependency>& dependencies /*= {}*/)
+    {
+        assert(m_initialized && "FrameScheduler::submit() - FrameScheduler is not initialized");
+
+        size_t timelineIndex = findTimeline(queue);
+
+        std::vector<TimelineWait> timelineWaits;
+        timelineWaits.reserve(dependencies.size());
+        for (const auto& dependency : dependencies) {
+            size_t dependencyIndex = findTimeline(dependency.queue.get());
+            timelineWaits.push_back({ m_timelines[dependencyIndex].semaphore, dependency.value, dependency.stage });
+        }
+
+        Value value = m_counter + 1;
+        queue.submit(instance, waitStages, waitSemaphores, commandBuffers, signalSemaphores,
+            timelineWaits, m_timelines[timelineIndex].semaphore, value);
+
+        // only advance once the submit went through, a failed one must not leave a value nobody signals
+        m_counter = value;
+        m_timelines[timelineIndex].lastSignaled = value;
+        m_frames[m_frameIndex].values[timelineIndex] = value;
+        return value;
+    }
+
+    bool FrameScheduler::isComplete(const Context& instance, const Device& device,
+        const Queue& queue, Value value) const
+    {
+        return m_timelines[findTimeline(queue)].semaphore.getValue(instance, device) >= value;
+    }
+
+    bool FrameScheduler::wait(const Context& instance, const Device& device, const Queue& queue,
+        Value value, uint64_t timeout /*= UINT64_MAX*/) const
+    {
+        return m_timelines[findTimeline(queue)].semaphore.wait(instance, device, value, timeout);
+    }
+
+    void FrameScheduler::waitIdle(const Context& instance, const Device& device) const
+    {
+        auto values = convert<Value>(m_timelines, [](const Timeline& timeline) { return timeline.lastSignaled; });
+        waitTimelines(instance, device, values, UINT64_MAX);
+    }
+
+    size_t FrameScheduler::findTimeline(const Queue& queue) const
+    {
+        for (size_t i = 0; i < m_timelines.size(); i++)
+            if (m_timelines[i].family == queue.getFamily() && m_timelines[i].index == queue.getIndex())
+                return i;
+
+        throw std::runtime_error("FrameScheduler - Queue was not registered with the scheduler");
+    }
+
+    bool FrameScheduler::waitTimelines(const Context& instance, const Device& device,
+        const std::vector<Value>& values, uint64_t timeout) const
+    {
+        std::vector<vk::Semaphore> semaphores;
+        std::vector<Value> waitValues;
+        semaphores.reserve(values.size());
+        waitValues.reserve(values.size());
+
+        for (size_t i = 0; i < values.size(); i++) {
+            if (values[i] == 0)
+                continue;
+            semaphores.push_back(m_timelines[i].semaphore.getSemaphore());
+            waitValues.push_back(values[i]);
+        }
+
+        if (semaphores.empty())
+            return true;
+
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = vk::StructureType::eSemaphoreWaitInfo;
+        waitInfo.semaphoreCount = static_cast<uint32_t>(semaphores.size());
+        waitInfo.pSemaphores = semaphores.data();
+        waitInfo.pValues = waitValues.data();
+
+        vk::Result result = device.getDevice().waitSemaphores(waitInfo, timeout, instance.getDispatchLoader());
+        if (result == vk::Result::eSuccess)
+            return true;
+        if (result == vk::Result::eTimeout)
+            return false;
+        throw std::runtime_error("Error waiting for frame timelines: " + vk::to_string(result));
+    }
+
+}
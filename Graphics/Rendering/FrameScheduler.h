@@ -0,0 +1,145 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "Queue.h"
+#include "Semaphore.h"
+#include "TimelineSemaphore.h"
+
+namespace Graphics {
+
+    // frame pacing on timeline semaphores instead of a fence per frame
+    // every submission through the scheduler gets the next value of one counter shared by all queues,
+    // each queue signals its own timeline semaphore since a single semaphore can't be signaled out of order,
+    // a value is finished once the timeline of the queue it was submitted to reaches it
+    // beginFrame only waits for the frame that used the same slot framesInFlight frames ago,
+    // so the cpu can prepare the next frames while the gpu is still busy with the previous ones
+    // submissions are expected to come from one thread, same as the queues themselves
+    class FrameScheduler
+    {
+    public:
+        using Value = uint64_t;
+
+        // makes a submission wait for an earlier one, possibly from another queue
+        struct Dependency
+        {
+            std::reference_wrapper<const Queue> queue;
+            Value value;
+            vk::PipelineStageFlags stage;
+        };
+
+    private:
+        struct Timeline
+        {
+            uint32_t family = 0;
+            uint32_t index = 0;
+            TimelineSemaphore semaphore;
+            Value lastSignaled = 0;
+        };
+
+        struct Frame
+        {
+            // swapchain acquire and present only take binary semaphores
+            Semaphore imageAvailable;
+            Semaphore renderFinished;
+
+            // last value each timeline signaled while this frame was being prepared
+            std::vector<Value> values;
+        };
+
+        std::vector<Timeline> m_timelines;
+        std::vector<Frame> m_frames;
+
+        Value m_counter = 0;
+        uint64_t m_frameNumber = 0;
+        uint32_t m_frameIndex = 0;
+
+        bool m_initialized = false;
+    public:
+
+        FrameScheduler() {};
+
+        // every queue that will be submitted to through the scheduler has to be passed here,
+        // queues pointing at the same family and index share a timeline
+        FrameScheduler(const Context& instance, const Device& device,
+            const std::vector<std::reference_wrapper<const Queue>>& queues, uint32_t framesInFlight);
+
+        FrameScheduler(FrameScheduler&& other) noexcept {
+            m_timelines = std::exchange(other.m_timelines, {});
+            m_frames = std::exchange(other.m_frames, {});
+            m_counter = std::exchange(other.m_counter, 0);
+            m_frameNumber = std::exchange(other.m_frameNumber, 0);
+            m_frameIndex = std::exchange(other.m_frameIndex, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized scheduler is undefined behavior, destroy before moving
+        FrameScheduler& operator=(FrameScheduler&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "FrameScheduler::operator=() - FrameScheduler already initialized");
+
+            m_timelines = std::exchange(other.m_timelines, {});
+            m_frames = std::exchange(other.m_frames, {});
+            m_counter = std::exchange(other.m_counter, 0);
+            m_frameNumber = std::exchange(other.m_frameNumber, 0);
+            m_frameIndex = std::exchange(other.m_frameIndex, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        FrameScheduler(const FrameScheduler&) noexcept = delete;
+        FrameScheduler& operator=(const FrameScheduler&) noexcept = delete;
+
+        ~FrameScheduler() { assert(!m_initialized && "FrameScheduler was not destroyed!"); };
+
+        // waits for everything submitted through the scheduler before destroying the semaphores
+        void destroy(const Context& instance, const Device& device);
+
+        // moves to the next frame slot and waits until the gpu is done with the work previously submitted from it,
+        // returns the slot index for per frame resources
+        uint32_t beginFrame(const Context& instance, const Device& device);
+
+        // submits with the next counter value and records it for the current frame, returns the value
+        Value submit(const Context& instance, const Queue& queue,
+            const std::vector<vk::PipelineStageFlags>& waitStages,
+            const std::vector<std::reference_wrapper<const Semaphore>>& waitSemaphores,
+            const std::vector<std::reference_wrapper<const CommandBufferHandle>>& commandBuffers,
+            const std::vector<std::reference_wrapper<const Semaphore>>& signalSemaphores,
+            const std::vector<Dependency>& dependencies = {});
+
+        bool isComplete(const Context& instance, const Device& device, const Queue& queue, Value value) const;
+
+        // returns false if the timeout ran out first
+        bool wait(const Context& instance, const Device& device, const Queue& queue,
+            Value value, uint64_t timeout = UINT64_MAX) const;
+
+        // waits for every submission on every queue, a cheaper replacement for a device wait idle
+        void waitIdle(const Context& instance, const Device& device) const;
+
+        const Semaphore& getImageAvailable() const { return m_frames[m_frameIndex].imageAvailable; };
+        const Semaphore& getRenderFinished() const { return m_frames[m_frameIndex].renderFinished; };
+        const TimelineSemaphore& getTimeline(const Queue& queue) const { return m_timelines[findTimeline(queue)].semaphore; };
+
+        uint32_t getFrameIndex() const { return m_frameIndex; };
+        uint64_t getFrameNumber() const { return m_frameNumber; };
+        uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_frames.size()); };
+
+        // after beginFrame every frame up to this one is finished on the gpu, 0 if none is yet
+        uint64_t getCompletedFrameNumber() const {
+            return m_frameNumber > m_frames.size() ? m_frameNumber - m_frames.size() : 0;
+        };
+
+        // the value given to the latest submission
+        Value getLastValue() const { return m_counter; };
+
+    private:
+        size_t findTimeline(const Queue& queue) const;
+        bool waitTimelines(const Context& instance, const Device& device,
+            const std::vector<Value>& values, uint64_t timeout) const;
+    };
+
+}
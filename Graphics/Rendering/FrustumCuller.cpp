@@ -0,0 +1,220 @@
+#include "FrustumCuller.h"
+
+namespace Graphics {
+
+    FrustumCuller::FrustumCuller(const Context& instance, const Device& device, MemoryAllocator& allocator,
+        const Shader& cullShader, uint32_t maxInstances, uint32_t maxDraws, uint32_t framesInFlight) :
+        m_allocator(&allocator), m_maxInstances(maxInstances)
+    {
+        m_multiDraw = device.isFeatureEnabled(DeviceFeature::MultiDrawIndirect);
+
+        m_layout = DescriptorSetLayout(instance, device, CullDescriptorDefinitions());
+        m_pool = DescriptorPool(instance, device, {
+            DescriptorPool::Size(framesInFlight, DescriptorType::UniformBuffer),
+            DescriptorPool::Size(4 * static_cast<size_t>(framesInFlight), DescriptorType::StorageBuffer) },
+            framesInFlight, DescriptorPoolCreateFlags::Bits::None);
+        m_sets = m_pool.allocateSets(instance, device, std::vector<const DescriptorSetLayout*>(framesInFlight, &m_layout));
+        m_pipeline = ComputePipeline(instance, device, cullShader, { &m_layout });
+
+        size_t instanceCapacity = m_maxInstances;
+        size_t offsetAlignment = std::max<size_t>(
+            device.getPhysicalDevice().getProperty<DeviceProperty::MinStorageBufferOffsetAlignment>(), 1);
+        m_instanceRegionSize = (instanceCapacity * sizeof(CullInstance) + offsetAlignment - 1) / offsetAlignment * offsetAlignment;
+
+        m_parameters = Buffer(instance, device, sizeof(CullParameters),
+            BufferUsage::Bits::Uniform | BufferUsage::Bits::TransferDst);
+        m_instances = Buffer(instance, device, m_instanceRegionSize * framesInFlight,
+            BufferUsage::Bits::Storage | BufferUsage::Bits::TransferDst);
+        m_culledDraws = Buffer(instance, device, static_cast<size_t>(maxDraws) * IndirectDrawBuilder::commandStride,
+            BufferUsage::Bits::Indirect | BufferUsage::Bits::Storage | BufferUsage::Bits::TransferDst);
+        m_transforms = Buffer(instance, device, instanceCapacity * VertexDefinitionModelTransform::DATA_SIZE,
+            BufferUsage::Bits::Vertex | BufferUsage::Bits::Storage);
+        m_textureIds = Buffer(instance, device, instanceCapacity * VertexDefinitionId::DATA_SIZE,
+            BufferUsage::Bits::Vertex | BufferUsage::Bits::Storage);
+
+        m_allocations[0] = m_allocator->allocate(instance, device, m_parameters, MemoryProperty::Bits::DeviceLocal);
+        m_allocations[1] = m_allocator->allocate(instance, device, m_instances, MemoryProperty::Bits::DeviceLocal);
+        m_allocations[2] = m_allocator->allocate(instance, device, m_culledDraws, MemoryProperty::Bits::DeviceLocal);
+        m_allocations[3] = m_allocator->allocate(instance, device, m_transforms, MemoryProperty::Bits::DeviceLocal);
+        m_allocations[4] = m_allocator->allocate(instance, device, m_textureIds, MemoryProperty::Bits::DeviceLocal);
+
+        m_draws = IndirectDrawBuilder(instance, device, allocator, maxDraws, framesInFlight);
+
+        for (uint32_t frame = 0; frame < framesInFlight; frame++) {
+            auto& set = m_sets[frame];
+            set->write(instance, device, m_parameters, 0, 0, sizeof(CullParameters));
+            set->write(instance, device, m_instances, 1, frame * m_instanceRegionSize, instanceCapacity * sizeof(CullInstance));
+            set->write(instance, device, m_culledDraws, 2, 0, static_cast<size_t>(maxDraws) * IndirectDrawBuilder::commandStride);
+            set->write(instance, device, m_transforms, 3, 0, instanceCapacity * VertexDefinitionModelTransform::DATA_SIZE);
+            set->write(instance, device, m_textureIds, 4, 0, instanceCapacity * VertexDefinitionId::DATA_SIZE);
+        }
+
+        m_drawEntries.reserve(maxDraws);
+        m_instanceData.reserve(m_maxInstances);
+        m_initialized = true;
+    }
+
+    void FrustumCuller::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        m_draws.destroy(instance, device);
+
+        m_parameters.destroy(instance, device);
+        m_instances.destroy(instance, device);
+        m_culledDraws.destroy(instance, device);
+        m_transforms.destroy(instance, device);
+        m_textureIds.destroy(instance, device);
+        for (auto& allocation : m_allocations)
+            m_allocator->free(instance, device, allocation);
+
+        m_pipeline.destroy(instance, device);
+        m_pool.destroy(instance, device);
+        m_sets.clear();
+        m_layout.destroy(instance, device);
+
+        m_drawEntries.clear();
+        m_instanceData.clear();
+#ifdef _DEBUG
+        std::cout << "Destroyed FrustumCuller" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    uint32_t FrustumCuller::addDraw(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
+    {
+        if (m_drawEntries.size() >= m_draws.getCapacity())
+            throw std::runtime_error("FrustumCuller::addDraw() - Out of draw slots");
+
+        m_drawEntries.push_back({ indexCount, firstIndex, vertexOffset, 0 });
+        return static_cast<uint32_t>(m_drawEntries.size() - 1);
+    }
+
+    void FrustumCuller::addInstance(uint32_t drawId, const glm::mat4& transform, const glm::vec4& bounds, uint32_t textureId)
+    {
+        if (m_instanceData.size() >= m_maxInstances)
+            throw std::runtime_error("FrustumCuller::addInstance() - Out of instance slots");
+        if (drawId >= m_drawEntries.size())
+            throw std::runtime_error("FrustumCuller::addInstance() - Invalid draw id");
+
+        CullInstance cullInstance{};
+        cullInstance.transform = transform;
+        cullInstance.bounds = bounds;
+        cullInstance.textureId = textureId;
+        cullInstance.drawId = drawId;
+        m_instanceData.push_back(cullInstance);
+
+        m_drawEntries[drawId].instanceCount++;
+    }
+
+    void FrustumCuller::clear()
+    {
+        m_drawEntries.clear();
+        m_instanceData.clear();
+    }
+
+    UploadQueue::Ticket FrustumCuller::upload(const Context& instance, const Device& device,
+        StagingRing& stagingRing, UploadQueue& uploadQueue, uint32_t frameIndex)
+    {
+        assert(m_initialized && "FrustumCuller::upload() - FrustumCuller is not initialized");
+
+        // every draw gets a range of the output as big as its instance count,
+        // the cull pass counts the visible ones up from zero
+        m_draws.clear();
+        uint32_t firstInstance = 0;
+        for (const auto& entry : m_drawEntries) {
+            m_draws.add(entry.indexCount, 0, entry.firstIndex, entry.vertexOffset, firstInstance);
+            firstInstance += entry.instanceCount;
+        }
+
+        m_uploadedInstances = static_cast<uint32_t>(m_instanceData.size());
+        m_uploadedFrame = frameIndex;
+        UploadQueue::Ticket ticket = m_draws.upload(instance, device, stagingRing, uploadQueue, frameIndex);
+
+        if (m_instanceData.empty())
+            return ticket;
+
+        auto bytes = std::as_bytes(std::span(m_instanceData));
+        return std::max(ticket, stagingRing.uploadBuffer(instance, device, uploadQueue, m_instances,
+            std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()),
+            frameIndex * m_instanceRegionSize));
+    }
+
+    void FrustumCuller::record(const Context& instance, CommandBuffer& commandBuffer, const CameraBase& camera)
+    {
+        if (m_uploadedInstances == 0 || m_draws.getDrawCount() == 0)
+            return;
+
+        CullParameters parameters{};
+        auto planes = extractFrustumPlanes(camera.getProjection() * camera.getView());
+        std::copy(planes.begin(), planes.end(), parameters.planes);
+        parameters.instanceCount = m_uploadedInstances;
+
+        // the previous frame might still be drawing from the outputs
+        commandBuffer.setMemoryBarrier(instance,
+            vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput |
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eTransfer,
+            {}, vk::AccessFlagBits::eTransferWrite);
+
+        commandBuffer.updateBuffer(instance, m_parameters, 0,
+            std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&parameters), sizeof(CullParameters)));
+        commandBuffer.transferBufferData(instance, m_draws.getBuffer(), m_culledDraws,
+            CopyRegion(m_draws.getOffset(), 0, static_cast<size_t>(m_draws.getDrawCount()) * IndirectDrawBuilder::commandStride));
+
+        commandBuffer.setMemoryBarrier(instance,
+            vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eComputeShader,
+            vk::AccessFlagBits::eTransferWrite,
+            vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead | vk::AccessFlagBits::eShaderWrite);
+
+        commandBuffer.bindPipeline(instance, m_pipeline);
+        commandBuffer.bindDescriptorSets(instance, m_pipeline, { m_sets[m_uploadedFrame] });
+        commandBuffer.dispatch(instance, (m_uploadedInstances + workgroupSize - 1) / workgroupSize);
+
+        commandBuffer.setMemoryBarrier(instance,
+            vk::PipelineStageFlagBits::eComputeShader,
+            vk::PipelineStageFlagBits::eDrawIndirect | vk::PipelineStageFlagBits::eVertexInput,
+            vk::AccessFlagBits::eShaderWrite,
+            vk::AccessFlagBits::eIndirectCommandRead | vk::AccessFlagBits::eVertexAttributeRead);
+    }
+
+    void FrustumCuller::draw(const Context& instance, CommandBuffer& commandBuffer) const
+    {
+        uint32_t drawCount = m_draws.getDrawCount();
+        if (m_uploadedInstances == 0 || drawCount == 0)
+            return;
+
+        if (m_multiDraw) {
+            commandBuffer.drawIndexedIndirect(instance, m_culledDraws, 0, drawCount, IndirectDrawBuilder::commandStride);
+            return;
+        }
+
+        for (uint32_t i = 0; i < drawCount; i++)
+            commandBuffer.drawIndexedIndirect(instance, m_culledDraws,
+                static_cast<size_t>(i) * IndirectDrawBuilder::commandStride, 1, IndirectDrawBuilder::commandStride);
+    }
+
+    std::array<glm::vec4, 6> FrustumCuller::extractFrustumPlanes(const glm::mat4& viewProjection)
+    {
+        // glm is column major, row i is (m[0][i], m[1][i], m[2][i], m[3][i])
+        auto row = [&](int i) {
+            return glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+            };
+
+        std::array<glm::vec4, 6> planes = {
+            row(3) + row(0),    // left
+            row(3) - row(0),    // right
+            row(3) + row(1),    // bottom
+            row(3) - row(1),    // top
+            row(2),             // near, depth is zero to one
+            row(3) - row(2),    // far
+        };
+
+        for (auto& plane : planes)
+            plane /= glm::length(glm::vec3(plane));
+
+        return planes;
+    }
+
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include "../Common.h"
+#include "../Camera.h"
+#include "../BufferDataLayouts.h"
+#include "Context.h"
+#include "Device.h"
+#include "Shader.h"
+#include "ComputePipeline.h"
+#include "DescriptorSetLayout.h"
+#include "CommandBuffer.h"
+#include "UploadQueue.h"
+#include "IndirectDrawBuilder.h"
+#include "../MemoryManagement/Buffer.h"
+#include "../MemoryManagement/DescriptorPool.h"
+#include "../MemoryManagement/MemoryAllocator.h"
+#include "../MemoryManagement/StagingRing.h"
+
+namespace Graphics {
+
+    // layout shared with Shaders/cull.comp
+    struct CullInstance
+    {
+        glm::mat4 transform;
+        glm::vec4 bounds; // local bounding sphere, center in xyz and radius in w
+        uint32_t textureId;
+        uint32_t drawId;
+        uint32_t pad[2];
+    };
+
+    struct CullParameters
+    {
+        glm::vec4 planes[6];
+        uint32_t instanceCount;
+        uint32_t pad[3];
+    };
+
+    using CullDescriptorDefinitions = DescriptorDefinitions<
+        UniformBufferDefinition<0, vk::ShaderStageFlagBits::eCompute>,
+        StorageBufferDefinition<1, vk::ShaderStageFlagBits::eCompute>,
+        StorageBufferDefinition<2, vk::ShaderStageFlagBits::eCompute>,
+        StorageBufferDefinition<3, vk::ShaderStageFlagBits::eCompute>,
+        StorageBufferDefinition<4, vk::ShaderStageFlagBits::eCompute>>;
+
+    // gpu frustum culling for instanced meshes
+    // instances are tested against the camera frustum in a compute pass recorded before the render pass,
+    // the visible ones get their transform and texture id compacted into buffers laid out like
+    // VertexDefinitionModelTransform and VertexDefinitionId, and the instance counts of the indirect
+    // draws are filled in on the gpu, so the cpu never touches per instance data after upload
+    class FrustumCuller
+    {
+    public:
+        static constexpr uint32_t workgroupSize = 64;
+
+    private:
+        struct DrawEntry
+        {
+            uint32_t indexCount = 0;
+            uint32_t firstIndex = 0;
+            int32_t vertexOffset = 0;
+            uint32_t instanceCount = 0;
+        };
+
+        MemoryAllocator* m_allocator = nullptr;
+
+        DescriptorSetLayout m_layout;
+        DescriptorPool m_pool;
+        // one per frame in flight, they only differ in the instance region binding 1 points at
+        std::vector<DescriptorSetHandle> m_sets;
+        ComputePipeline m_pipeline;
+
+        Buffer m_parameters;
+        // a region per frame in flight, the cull dispatch of an earlier frame may still read its own
+        Buffer m_instances;
+        Buffer m_culledDraws;
+        Buffer m_transforms;
+        Buffer m_textureIds;
+        std::array<Allocation, 5> m_allocations;
+
+        // uploaded with zero instance counts into the frame's region, copied over m_culledDraws before every cull
+        IndirectDrawBuilder m_draws;
+
+        std::vector<DrawEntry> m_drawEntries;
+        std::vector<CullInstance> m_instanceData;
+
+        uint32_t m_maxInstances = 0;
+        uint32_t m_uploadedInstances = 0;
+        size_t m_instanceRegionSize = 0;
+        uint32_t m_uploadedFrame = 0;
+        bool m_multiDraw = false;
+
+        bool m_initialized = false;
+    public:
+
+        FrustumCuller() {};
+
+        // cullShader is the compiled Shaders/cull.comp, it can be destroyed once the culler is created
+        FrustumCuller(const Context& instance, const Device& device, MemoryAllocator& allocator,
+            const Shader& cullShader, uint32_t maxInstances, uint32_t maxDraws, uint32_t framesInFlight);
+
+        FrustumCuller(FrustumCuller&& other) noexcept {
+            m_allocator = std::exchange(other.m_allocator, nullptr);
+            m_layout = std::move(other.m_layout);
+            m_pool = std::move(other.m_pool);
+            m_sets = std::exchange(other.m_sets, {});
+            m_pipeline = std::move(other.m_pipeline);
+            m_parameters = std::move(other.m_parameters);
+            m_instances = std::move(other.m_instances);
+            m_culledDraws = std::move(other.m_culledDraws);
+            m_transforms = std::move(other.m_transforms);
+            m_textureIds = std::move(other.m_textureIds);
+            m_allocations = std::exchange(other.m_allocations, {});
+            m_draws = std::move(other.m_draws);
+            m_drawEntries = std::exchange(other.m_drawEntries, {});
+            m_instanceData = std::exchange(other.m_instanceData, {});
+            m_maxInstances = std::exchange(other.m_maxInstances, 0);
+            m_uploadedInstances = std::exchange(other.m_uploadedInstances, 0);
+            m_instanceRegionSize = std::exchange(other.m_instanceRegionSize, 0);
+            m_uploadedFrame = std::exchange(other.m_uploadedFrame, 0);
+            m_multiDraw = std::exchange(other.m_multiDraw, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized culler is undefined behavior, destroy before moving
+        FrustumCuller& operator=(FrustumCuller&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "FrustumCuller::operator=() - FrustumCuller already initialized");
+
+            m_allocator = std::exchange(other.m_allocator, nullptr);
+            m_layout = std::move(other.m_layout);
+            m_pool = std::move(other.m_pool);
+            m_sets = std::exchange(other.m_sets, {});
+            m_pipeline = std::move(other.m_pipeline);
+            m_parameters = std::move(other.m_parameters);
+            m_instances = std::move(other.m_instances);
+            m_culledDraws = std::move(other.m_culledDraws);
+            m_transforms = std::move(other.m_transforms);
+            m_textureIds = std::move(other.m_textureIds);
+            m_allocations = std::exchange(other.m_allocations, {});
+            m_draws = std::move(other.m_draws);
+            m_drawEntries = std::exchange(other.m_drawEntries, {});
+            m_instanceData = std::exchange(other.m_instanceData, {});
+            m_maxInstances = std::exchange(other.m_maxInstances, 0);
+            m_uploadedInstances = std::exchange(other.m_uploadedInstances, 0);
+            m_instanceRegionSize = std::exchange(other.m_instanceRegionSize, 0);
+            m_uploadedFrame = std::exchange(other.m_uploadedFrame, 0);
+            m_multiDraw = std::exchange(other.m_multiDraw, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        FrustumCuller(const FrustumCuller&) noexcept = delete;
+        FrustumCuller& operator=(const FrustumCuller&) noexcept = delete;
+
+        ~FrustumCuller() { assert(!m_initialized && "FrustumCuller was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        // a mesh sharing the bound vertex and index buffers, returns its draw id
+        uint32_t addDraw(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset);
+
+        // bounds is the bounding sphere of the mesh in its local space
+        void addInstance(uint32_t drawId, const glm::mat4& transform, const glm::vec4& bounds, uint32_t textureId);
+
+        void clear();
+
+        // uploads the instances and draw templates, culling must not be submitted before the ticket completes,
+        // both go to the frame's region so only call it after the frame's wait
+        UploadQueue::Ticket upload(const Context& instance, const Device& device,
+            StagingRing& stagingRing, UploadQueue& uploadQueue, uint32_t frameIndex);
+
+        // records the culling dispatch, has to be outside of a render pass
+        void record(const Context& instance, CommandBuffer& commandBuffer, const CameraBase& camera);
+
+        // draws the surviving instances, getTransformBuffer() and getTextureIdBuffer() have to be bound
+        // at the VertexDefinitionModelTransform and VertexDefinitionId bindings
+        void draw(const Context& instance, CommandBuffer& commandBuffer) const;
+
+        // planes point inwards and are normalized, xyz is the normal and w the distance
+        static std::array<glm::vec4, 6> extractFrustumPlanes(const glm::mat4& viewProjection);
+
+        const Buffer& getTransformBuffer() const { return m_transforms; };
+        const Buffer& getTextureIdBuffer() const { return m_textureIds; };
+        const Buffer& getIndirectBuffer() const { return m_culledDraws; };
+        uint32_t getInstanceCount() const { return m_uploadedInstances; };
+        uint32_t getDrawCount() const { return m_draws.getDrawCount(); };
+        uint32_t getMaxInstances() const { return m_maxInstances; };
+    };
+
+}
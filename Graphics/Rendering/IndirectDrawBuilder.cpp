@@ -0,0 +1,81 @@
+#include "IndirectDrawBuilder.h"
+
+namespace Graphics {
+
+    IndirectDrawBuilder::IndirectDrawBuilder(const Context& instance, const Device& device,
+        MemoryAllocator& allocator, uint32_t capacity, uint32_t framesInFlight) :
+        m_allocator(&allocator), m_capacity(capacity), m_framesInFlight(framesInFlight)
+    {
+        assert(m_framesInFlight > 0 && "IndirectDrawBuilder::IndirectDrawBuilder() - Needs at least one frame in flight");
+        m_multiDraw = device.isFeatureEnabled(DeviceFeature::MultiDrawIndirect);
+        m_drawCount = device.isFeatureEnabled(DeviceFeature::DrawIndirectCount);
+
+        m_buffer = Buffer(instance, device, static_cast<size_t>(m_capacity) * m_framesInFlight * commandStride,
+            BufferUsage::Bits::Indirect | BufferUsage::Bits::TransferSrc | BufferUsage::Bits::TransferDst | BufferUsage::Bits::Storage);
+        m_allocation = m_allocator->allocate(instance, device, m_buffer, MemoryProperty::Bits::DeviceLocal);
+
+        m_commands.reserve(m_capacity);
+        m_initialized = true;
+    }
+
+    uint32_t IndirectDrawBuilder::add(uint32_t indexCount, uint32_t instanceCount,
+        uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+    {
+        if (m_commands.size() >= m_capacity)
+            throw std::runtime_error("IndirectDrawBuilder::add() - Out of indirect command slots");
+
+        vk::DrawIndexedIndirectCommand command{};
+        command.indexCount = indexCount;
+        command.instanceCount = instanceCount;
+        command.firstIndex = firstIndex;
+        command.vertexOffset = vertexOffset;
+        command.firstInstance = firstInstance;
+        m_commands.push_back(command);
+
+        return static_cast<uint32_t>(m_commands.size() - 1);
+    }
+
+    UploadQueue::Ticket IndirectDrawBuilder::upload(const Context& instance, const Device& device,
+        StagingRing& stagingRing, UploadQueue& uploadQueue, uint32_t frameIndex)
+    {
+        assert(m_initialized && "IndirectDrawBuilder::upload() - IndirectDrawBuilder is not initialized");
+        assert(frameIndex < m_framesInFlight && "IndirectDrawBuilder::upload() - Frame index out of range");
+
+        m_uploadedCount = static_cast<uint32_t>(m_commands.size());
+        m_uploadedFrame = frameIndex;
+        auto bytes = std::as_bytes(std::span(m_commands));
+        return stagingRing.uploadBuffer(instance, device, uploadQueue, m_buffer,
+            std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()), getOffset());
+    }
+
+    void IndirectDrawBuilder::record(const Context& instance, CommandBuffer& commandBuffer) const
+    {
+        if (m_uploadedCount == 0)
+            return;
+
+        if (m_multiDraw) {
+            commandBuffer.drawIndexedIndirect(instance, m_buffer, getOffset(), m_uploadedCount, commandStride);
+            return;
+        }
+
+        // without multi draw every indirect call can only read a single record
+        for (uint32_t i = 0; i < m_uploadedCount; i++)
+            commandBuffer.drawIndexedIndirect(instance, m_buffer, getOffset() + static_cast<size_t>(i) * commandStride, 1, commandStride);
+    }
+
+    void IndirectDrawBuilder::record(const Context& instance, CommandBuffer& commandBuffer,
+        const Buffer& countBuffer, size_t countOffset) const
+    {
+        if (m_uploadedCount == 0)
+            return;
+
+        if (!m_drawCount) {
+            record(instance, commandBuffer);
+            return;
+        }
+
+        commandBuffer.drawIndexedIndirectCount(instance, m_buffer, getOffset(),
+            countBuffer, countOffset, m_uploadedCount, commandStride);
+    }
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "CommandBuffer.h"
+#include "UploadQueue.h"
+#include "../MemoryManagement/Buffer.h"
+#include "../MemoryManagement/MemoryAllocator.h"
+#include "../MemoryManagement/StagingRing.h"
+
+namespace Graphics {
+
+    // packs one VkDrawIndexedIndirectCommand per mesh into a device local buffer so a whole scene
+    // of meshes sharing vertex/index buffers draws with a single call
+    // falls back to one indirect draw per record when MultiDrawIndirect wasn't enabled on the device
+    // the buffer has a region per frame in flight like DynamicBufferRing, so an upload never rewrites
+    // records a frame still on the gpu reads, a region is reused once upload is called for its index again
+    class IndirectDrawBuilder
+    {
+    public:
+        static constexpr uint32_t commandStride = sizeof(vk::DrawIndexedIndirectCommand);
+
+    private:
+        std::vector<vk::DrawIndexedIndirectCommand> m_commands;
+
+        Buffer m_buffer;
+        Allocation m_allocation;
+        MemoryAllocator* m_allocator = nullptr;
+        uint32_t m_capacity = 0;
+        uint32_t m_framesInFlight = 0;
+        uint32_t m_uploadedCount = 0;
+        uint32_t m_uploadedFrame = 0;
+        bool m_multiDraw = false;
+        bool m_drawCount = false;
+
+        bool m_initialized = false;
+    public:
+
+        IndirectDrawBuilder() {};
+
+        // the buffer is also usable as a storage buffer and copy source so compute passes can rewrite the records,
+        // capacity is per frame in flight
+        IndirectDrawBuilder(const Context& instance, const Device& device,
+            MemoryAllocator& allocator, uint32_t capacity, uint32_t framesInFlight);
+
+        IndirectDrawBuilder(IndirectDrawBuilder&& other) noexcept {
+            m_commands = std::exchange(other.m_commands, {});
+            m_buffer = std::move(other.m_buffer);
+            m_allocation = std::exchange(other.m_allocation, {});
+            m_allocator = std::exchange(other.m_allocator, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_uploadedCount = std::exchange(other.m_uploadedCount, 0);
+            m_uploadedFrame = std::exchange(other.m_uploadedFrame, 0);
+            m_multiDraw = std::exchange(other.m_multiDraw, false);
+            m_drawCount = std::exchange(other.m_drawCount, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized builder is undefined behavior, destroy before moving
+        IndirectDrawBuilder& operator=(IndirectDrawBuilder&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "IndirectDrawBuilder::operator=() - IndirectDrawBuilder already initialized");
+
+            m_commands = std::exchange(other.m_commands, {});
+            m_buffer = std::move(other.m_buffer);
+            m_allocation = std::exchange(other.m_allocation, {});
+            m_allocator = std::exchange(other.m_allocator, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_framesInFlight = std::exchange(other.m_framesInFlight, 0);
+            m_uploadedCount = std::exchange(other.m_uploadedCount, 0);
+            m_uploadedFrame = std::exchange(other.m_uploadedFrame, 0);
+            m_multiDraw = std::exchange(other.m_multiDraw, false);
+            m_drawCount = std::exchange(other.m_drawCount, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        IndirectDrawBuilder(const IndirectDrawBuilder&) noexcept = delete;
+        IndirectDrawBuilder& operator=(const IndirectDrawBuilder&) noexcept = delete;
+
+        ~IndirectDrawBuilder() { assert(!m_initialized && "IndirectDrawBuilder was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device) {
+            if (!m_initialized)
+                return;
+
+            m_buffer.destroy(instance, device);
+            m_allocator->free(instance, device, m_allocation);
+            m_commands.clear();
+#ifdef _DEBUG
+            std::cout << "Destroyed IndirectDrawBuilder" << std::endl;
+#endif
+            m_initialized = false;
+        }
+
+        // returns the index of the record, which is also gl_DrawID when multi draw is used
+        uint32_t add(uint32_t indexCount, uint32_t instanceCount,
+            uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance);
+
+        void clear() { m_commands.clear(); };
+
+        // packs the records into the frame's region, the draw must not be submitted before the ticket completes,
+        // only call it after the wait of the frame that used the region last
+        UploadQueue::Ticket upload(const Context& instance, const Device& device,
+            StagingRing& stagingRing, UploadQueue& uploadQueue, uint32_t frameIndex);
+
+        // draws everything that was uploaded last
+        void record(const Context& instance, CommandBuffer& commandBuffer) const;
+
+        // draws as many of the records as the uint32_t at countOffset says, read on the gpu,
+        // without DrawIndirectCount it draws every uploaded record, so the ones past the count must draw no instances
+        void record(const Context& instance, CommandBuffer& commandBuffer, const Buffer& countBuffer, size_t countOffset) const;
+
+        const Buffer& getBuffer() const { return m_buffer; };
+        // byte offset of the region that was uploaded last
+        size_t getOffset() const { return static_cast<size_t>(m_uploadedFrame) * m_capacity * commandStride; };
+        uint32_t getDrawCount() const { return m_uploadedCount; };
+        uint32_t getCapacity() const { return m_capacity; };
+        uint32_t getFramesInFlight() const { return m_framesInFlight; };
+        bool usesMultiDraw() const { return m_multiDraw; };
+        bool usesDrawCount() const { return m_drawCount; };
+        std::span<const vk::DrawIndexedIndirectCommand> getCommands() const { return m_commands; };
+    };
+
+}
@@ -0,0 +1,107 @@
+#include "ParallelRecorder.h"
+
+namespace Graphics {
+
+    ParallelRecorder::ParallelRecorder(const Context& instance, const Device& device, MT::ThreadPool& threadPool,
+        uint32_t queueFamilyIndex, uint32_t framesInFlight, uint32_t slotCount /*= 0*/) :
+        m_threadPool(&threadPool)
+    {
+        m_slotCount = slotCount != 0 ? slotCount : std::max(1u, m_threadPool->getWorkerAmount());
+
+        m_frames.resize(framesInFlight);
+        for (auto& slots : m_frames) {
+            slots.resize(m_slotCount);
+            for (auto& slot : slots) {
+                slot.pool = CommandPool(instance, device, queueFamilyIndex);
+                slot.commandBuffer = slot.pool.allocateBuffer(instance, device, vk::CommandBufferLevel::eSecondary);
+            }
+        }
+
+        m_initialized = true;
+    }
+
+    void ParallelRecorder::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        for (auto& slots : m_frames) {
+            for (auto& slot : slots) {
+                slot.pool.freeBuffer(instance, device, slot.commandBuffer);
+                slot.pool.destroy(instance, device);
+            }
+        }
+        m_frames.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed ParallelRecorder" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    void ParallelRecorder::record(const Context& instance, const Device& device, CommandBuffer& primary,
+        uint32_t frameIndex, const RenderPass& renderPass, const SwapChain& swapChain, uint32_t imageIndex,
+        size_t jobCount, const RecordFunc& func, uint32_t subpass /*= 0*/)
+    {
+        assert(m_initialized && "ParallelRecorder::record() - ParallelRecorder is not initialized");
+
+        if (jobCount == 0)
+            return;
+
+        auto& slots = m_frames[frameIndex];
+        size_t jobsPerSlot = (jobCount + m_slotCount - 1) / m_slotCount;
+        size_t usedSlots = (jobCount + jobsPerSlot - 1) / jobsPerSlot;
+
+        std::mutex mutex;
+        std::condition_variable done;
+        size_t pending = usedSlots;
+        std::exception_ptr error;
+
+        for (size_t i = 0; i < usedSlots; i++) {
+            // one reset per pool is cheaper than resetting every buffer on its own
+            slots[i].pool.recycle(instance, device);
+
+            size_t begin = i * jobsPerSlot;
+            size_t end = std::min(begin + jobsPerSlot, jobCount);
+
+            auto task = [&, i, begin, end]() {
+                try {
+                    CommandBuffer& commandBuffer = *slots[i].commandBuffer;
+                    commandBuffer.record(instance, renderPass, swapChain, imageIndex, subpass,
+                        CommandBufferUsage::Bits::OneTimeSubmit | CommandBufferUsage::Bits::RenderPassContinue);
+                    func(commandBuffer, begin, end);
+                    commandBuffer.stopRecord(instance);
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error)
+                        error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0)
+                    done.notify_all();
+                };
+
+            // pool is shutting down, record here instead
+            if (!m_threadPool->pushTask(task))
+                task();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [&]() { return pending == 0; });
+        }
+
+        if (error)
+            std::rethrow_exception(error);
+
+        std::vector<CommandBufferHandle> commandBuffers;
+        commandBuffers.reserve(usedSlots);
+        for (size_t i = 0; i < usedSlots; i++)
+            commandBuffers.push_back(slots[i].commandBuffer);
+
+        primary.executeCommands(instance, commandBuffers);
+    }
+
+}
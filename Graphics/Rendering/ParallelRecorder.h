@@ -0,0 +1,89 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "RenderPass.h"
+#include "SwapChain.h"
+#include "CommandPool.h"
+#include "CommandBuffer.h"
+
+#include "MultiThreading/ThreadPool.h"
+
+#include <mutex>
+#include <condition_variable>
+
+namespace Graphics {
+
+    // splits the recording of a render pass across the thread pool
+    // every slot owns a command pool per frame in flight and one secondary buffer from it, a slot is only
+    // ever touched by the one task recording it so the pools need no locking whichever worker runs it,
+    // the secondaries are executed from the primary in job order
+    class ParallelRecorder
+    {
+    public:
+        // records jobs [begin, end) into a secondary buffer, runs on a worker thread
+        using RecordFunc = std::function<void(CommandBuffer& commandBuffer, size_t begin, size_t end)>;
+
+    private:
+        struct Slot
+        {
+            CommandPool pool;
+            CommandBufferHandle commandBuffer;
+        };
+
+        MT::ThreadPool* m_threadPool = nullptr;
+        std::vector<std::vector<Slot>> m_frames;
+        uint32_t m_slotCount = 0;
+
+        bool m_initialized = false;
+    public:
+
+        ParallelRecorder() {};
+
+        // slotCount defaults to the worker count of the pool
+        ParallelRecorder(const Context& instance, const Device& device, MT::ThreadPool& threadPool,
+            uint32_t queueFamilyIndex, uint32_t framesInFlight, uint32_t slotCount = 0);
+
+        ParallelRecorder(ParallelRecorder&& other) noexcept {
+            m_threadPool = std::exchange(other.m_threadPool, nullptr);
+            m_frames = std::exchange(other.m_frames, {});
+            m_slotCount = std::exchange(other.m_slotCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized recorder is undefined behavior, destroy before moving
+        ParallelRecorder& operator=(ParallelRecorder&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "ParallelRecorder::operator=() - ParallelRecorder already initialized");
+
+            m_threadPool = std::exchange(other.m_threadPool, nullptr);
+            m_frames = std::exchange(other.m_frames, {});
+            m_slotCount = std::exchange(other.m_slotCount, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        ParallelRecorder(const ParallelRecorder&) noexcept = delete;
+        ParallelRecorder& operator=(const ParallelRecorder&) noexcept = delete;
+
+        ~ParallelRecorder() { assert(!m_initialized && "ParallelRecorder was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device);
+
+        // records jobCount jobs into secondary buffers on the pool and executes them from primary,
+        // primary has to be inside renderPass begun with eSecondaryCommandBuffers contents
+        // and the previous submission of frameIndex has to be finished
+        // blocks until every slot is recorded, exceptions from the jobs are rethrown here
+        void record(const Context& instance, const Device& device, CommandBuffer& primary,
+            uint32_t frameIndex, const RenderPass& renderPass, const SwapChain& swapChain, uint32_t imageIndex,
+            size_t jobCount, const RecordFunc& func, uint32_t subpass = 0);
+
+        uint32_t getSlotCount() const { return m_slotCount; };
+        uint32_t getFramesInFlight() const { return static_cast<uint32_t>(m_frames.size()); };
+    };
+
+}
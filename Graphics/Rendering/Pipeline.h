@@ -8,6 +8,7 @@
 #include "RenderPass.h"
 #include "../BufferDataLayouts.h"
 #include "DescriptorSetLayout.h"
+#include "PipelineCache.h"
 
 namespace Graphics {
 
@@ -111,7 +112,18 @@ namespace Graphics {
         Pipeline(const Context& instance, const Device& device, const RenderPass& renderPass,
             ShaderBundle shaders, const RenderRegion& canvas, const SwapChainFormat& format,
             const VertexDefinitions<VertexDefs...>& vertices,
-            const std::vector<const DescriptorSetLayout*>& layouts)
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const PipelineCache* cache = nullptr) :
+            Pipeline(instance, device, renderPass, shaders, canvas, format,
+                vertices, layouts, PushConstantDefinitions<>(), cache) {};
+
+        template <VertexDefinition... VertexDefs, PushConstantDefinition... PushConstantDefs>
+        Pipeline(const Context& instance, const Device& device, const RenderPass& renderPass,
+            ShaderBundle shaders, const RenderRegion& canvas, const SwapChainFormat& format,
+            const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const PushConstantDefinitions<PushConstantDefs...>& pushConstants,
+            const PipelineCache* cache = nullptr)
         {
             m_shaders = shaders;
             auto shaderState = createShaderStages();
@@ -200,12 +212,14 @@ namespace Graphics {
                         return layout->getLayout();
                     });
 
+            auto pushConstantRanges = pushConstants.enumerateRanges();
+
             vk::PipelineLayoutCreateInfo pipelineLayoutInfo{};
             pipelineLayoutInfo.sType = vk::StructureType::ePipelineLayoutCreateInfo;
             pipelineLayoutInfo.setLayoutCount = layoutsRaw.size();  // number of descriptor set layouts
             pipelineLayoutInfo.pSetLayouts = layoutsRaw.data();  // array of descriptor set layouts
-            pipelineLayoutInfo.pushConstantRangeCount = 0;
-            pipelineLayoutInfo.pPushConstantRanges = nullptr;
+            pipelineLayoutInfo.pushConstantRangeCount = pushConstantRanges.size();
+            pipelineLayoutInfo.pPushConstantRanges = pushConstantRanges.data();
 
             try {
                 m_pipelineLayout = device.getDevice()
@@ -253,7 +267,8 @@ namespace Graphics {
             pipelineInfo.basePipelineHandle = VK_NULL_HANDLE; // Optional
             pipelineInfo.basePipelineIndex = -1; // Optional
 
-            auto result = device.getDevice().createGraphicsPipeline(nullptr, pipelineInfo, nullptr, instance.getDispatchLoader());
+            auto result = device.getDevice().createGraphicsPipeline(
+                cache ? cache->getCache() : vk::PipelineCache(), pipelineInfo, nullptr, instance.getDispatchLoader());
             if (result.result != vk::Result::eSuccess) {
                 throw std::runtime_error("Failed to create graphics pipeline!");
             }
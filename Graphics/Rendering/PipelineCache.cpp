@@ -0,0 +1,145 @@
+#include "PipelineCache.h"
+
+namespace Graphics {
+
+    PipelineCache::PipelineCache(const Context& instance, const Device& device,
+        const std::filesystem::path& path /*= {}*/) : m_path(path)
+    {
+        const auto& physicalDevice = device.getPhysicalDevice();
+        m_header.vendorId = physicalDevice.getProperty<DeviceProperty::VendorId>();
+        m_header.deviceId = physicalDevice.getProperty<DeviceProperty::PhysicalDeviceId>();
+        m_header.driverVersion = physicalDevice.getProperty<DeviceProperty::DriverVersion>();
+        m_header.uuid = physicalDevice.getProperty<DeviceProperty::PipelineCacheUuid>();
+
+        std::vector<uint8_t> data = load();
+        m_loaded = !data.empty();
+
+        vk::PipelineCacheCreateInfo createInfo{};
+        createInfo.sType = vk::StructureType::ePipelineCacheCreateInfo;
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+        try {
+            m_cache = device.getDevice().createPipelineCache(createInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to create pipeline cache: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when creating a pipeline cache: " + std::string(e.what()));
+        }
+
+        m_initialized = true;
+    }
+
+    void PipelineCache::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        try {
+            save(instance, device);
+        }
+        catch (const std::exception& e) {
+#ifdef _DEBUG
+            std::cout << "Failed to save PipelineCache: " << e.what() << std::endl;
+#endif
+        }
+
+        device.getDevice().destroyPipelineCache(m_cache, nullptr, instance.getDispatchLoader());
+#ifdef _DEBUG
+        std::cout << "Destroyed PipelineCache" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    std::vector<uint8_t> PipelineCache::load() const
+    {
+        if (m_path.empty())
+            return {};
+
+        std::ifstream file(m_path, std::ios::binary);
+        if (!file.is_open())
+            return {};
+
+        FileHeader header;
+        file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader));
+
+        // the data has to be exactly the rest of the file, never allocate what a broken header claims
+        std::streamoff dataStart = file.tellg();
+        file.seekg(0, std::ios::end);
+        std::streamoff remaining = file.tellg() - dataStart;
+        file.seekg(dataStart);
+
+        if (!file || remaining < 0 || static_cast<uint64_t>(remaining) != header.dataSize ||
+            header.magic != fileMagic || header.version != fileVersion ||
+            header.vendorId != m_header.vendorId || header.deviceId != m_header.deviceId ||
+            header.driverVersion != m_header.driverVersion || header.uuid != m_header.uuid) {
+#ifdef _DEBUG
+            std::cout << "PipelineCache at " << m_path << " is stale, starting empty" << std::endl;
+#endif
+            return {};
+        }
+
+        std::vector<uint8_t> data(header.dataSize);
+        file.read(reinterpret_cast<char*>(data.data()), data.size());
+        if (!file || hashBytes(data.data(), data.size()) != header.dataHash) {
+#ifdef _DEBUG
+            std::cout << "PipelineCache at " << m_path << " is corrupted, starting empty" << std::endl;
+#endif
+            return {};
+        }
+
+        return data;
+    }
+
+    void PipelineCache::save(const Context& instance, const Device& device) const
+    {
+        if (m_path.empty())
+            return;
+
+        std::vector<uint8_t> data = device.getDevice().getPipelineCacheData(m_cache, instance.getDispatchLoader());
+
+        FileHeader header = m_header;
+        header.dataSize = data.size();
+        header.dataHash = hashBytes(data.data(), data.size());
+
+        if (m_path.has_parent_path())
+            std::filesystem::create_directories(m_path.parent_path());
+
+        std::filesystem::path temporary = m_path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+                throw std::runtime_error("failed to open " + temporary.string() + " for writing");
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader));
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            file.flush();
+            if (!file)
+                throw std::runtime_error("failed to write " + temporary.string());
+        }
+
+        std::filesystem::rename(temporary, m_path);
+    }
+
+    void PipelineCache::merge(const Context& instance, const Device& device,
+        const std::vector<const PipelineCache*>& sources)
+    {
+        auto sourcesRaw = convert<vk::PipelineCache>
+            (sources, [](const PipelineCache* cache)
+                { return cache->getCache(); });
+
+        try {
+            device.getDevice().mergePipelineCaches(m_cache, sourcesRaw, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to merge pipeline caches: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when merging pipeline caches: " + std::string(e.what()));
+        }
+    }
+
+}
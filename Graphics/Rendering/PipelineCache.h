@@ -0,0 +1,96 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+
+#include <filesystem>
+
+namespace Graphics {
+
+    // vk::PipelineCache persisted between runs
+    // the blob is stored behind a small header with the device ids, pipeline cache uuid and driver version,
+    // a blob from another gpu or driver is thrown away and the cache starts out empty
+    class PipelineCache
+    {
+    public:
+        static constexpr uint32_t fileMagic = 0x43505647; // "GVPC"
+        static constexpr uint32_t fileVersion = 1;
+
+        struct FileHeader
+        {
+            uint32_t magic = fileMagic;
+            uint32_t version = fileVersion;
+            uint32_t vendorId = 0;
+            uint32_t deviceId = 0;
+            uint32_t driverVersion = 0;
+            uint32_t pad = 0;
+            std::array<uint8_t, VK_UUID_SIZE> uuid = {};
+            uint64_t dataSize = 0;
+            uint64_t dataHash = 0;
+        };
+
+    private:
+        vk::PipelineCache m_cache = nullptr;
+        std::filesystem::path m_path;
+        FileHeader m_header;
+        bool m_loaded = false;
+
+        bool m_initialized = false;
+    public:
+
+        PipelineCache() {};
+
+        // an empty path gives a cache that only lives in memory
+        PipelineCache(const Context& instance, const Device& device, const std::filesystem::path& path = {});
+
+        PipelineCache(PipelineCache&& other) noexcept {
+            m_cache = std::exchange(other.m_cache, nullptr);
+            m_path = std::exchange(other.m_path, {});
+            m_header = std::exchange(other.m_header, {});
+            m_loaded = std::exchange(other.m_loaded, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized cache is undefined behavior, destroy before moving
+        PipelineCache& operator=(PipelineCache&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "PipelineCache::operator=() - PipelineCache already initialized");
+
+            m_cache = std::exchange(other.m_cache, nullptr);
+            m_path = std::exchange(other.m_path, {});
+            m_header = std::exchange(other.m_header, {});
+            m_loaded = std::exchange(other.m_loaded, false);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        PipelineCache(const PipelineCache&) noexcept = delete;
+        PipelineCache& operator=(const PipelineCache&) noexcept = delete;
+
+        ~PipelineCache() { assert(!m_initialized && "PipelineCache was not destroyed!"); };
+
+        // writes the cache back to its path before destroying it, a failed write only loses the cache
+        void destroy(const Context& instance, const Device& device);
+
+        // writes to a temporary file next to the path and renames it over the old one,
+        // so a crash mid write never leaves a truncated cache behind
+        void save(const Context& instance, const Device& device) const;
+
+        // folds other caches, like ones filled by worker threads, into this one
+        void merge(const Context& instance, const Device& device, const std::vector<const PipelineCache*>& sources);
+
+        const vk::PipelineCache& getCache() const { return m_cache; };
+        const std::filesystem::path& getPath() const { return m_path; };
+
+        // true if a valid blob was found on disk
+        bool isLoaded() const { return m_loaded; };
+
+    private:
+        std::vector<uint8_t> load() const;
+    };
+
+}
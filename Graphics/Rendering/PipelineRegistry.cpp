@@ -0,0 +1,112 @@
+#include "PipelineRegistry.h"
+
+namespace Graphics {
+
+    void PipelineRegistry::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_created.wait(lock, [this]() { return m_pending == 0; });
+
+        for (auto& [key, entry] : m_entries)
+            if (entry.pipeline)
+                entry.pipeline->destroy(instance, device);
+        m_entries.clear();
+
+#ifdef _DEBUG
+        std::cout << "Destroyed PipelineRegistry" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    bool PipelineRegistry::reserve(State&& state, Key& key)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // probe past keys taken by a different state, the same state always walks the same keys
+        for (key = hashState(state);; key++) {
+            auto [it, inserted] = m_entries.try_emplace(key);
+            if (inserted) {
+                it->second.state = std::move(state);
+                m_misses++;
+                m_pending++;
+                return true;
+            }
+
+            if (it->second.state == state) {
+                m_hits++;
+                return false;
+            }
+        }
+    }
+
+    void PipelineRegistry::create(Key key, const std::function<std::unique_ptr<Pipeline>()>& factory)
+    {
+        std::unique_ptr<Pipeline> pipeline;
+        std::exception_ptr error;
+        try {
+            pipeline = factory();
+        }
+        catch (...) {
+            error = std::current_exception();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Entry& entry = m_entries[key];
+            entry.pipeline = std::move(pipeline);
+            entry.error = error;
+            entry.ready = true;
+            m_pending--;
+        }
+        m_created.notify_all();
+    }
+
+    const Pipeline* PipelineRegistry::find(Key key) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end() || !it->second.ready)
+            return nullptr;
+        return it->second.pipeline.get();
+    }
+
+    const Pipeline& PipelineRegistry::wait(Key key)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            throw std::runtime_error("PipelineRegistry::wait() - Unknown pipeline key");
+
+        // other threads may insert and rehash while this one sleeps, so look the entry up by key every time
+        m_created.wait(lock, [&]() { return m_entries.at(key).ready; });
+
+        const Entry& entry = m_entries.at(key);
+        if (entry.error)
+            std::rethrow_exception(entry.error);
+        return *entry.pipeline;
+    }
+
+    bool PipelineRegistry::contains(Key key) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.find(key) != m_entries.end();
+    }
+
+    PipelineRegistry::Statistics PipelineRegistry::getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Statistics statistics;
+        statistics.hits = m_hits;
+        statistics.misses = m_misses;
+        statistics.pending = m_pending;
+        for (const auto& [key, entry] : m_entries)
+            if (entry.pipeline)
+                statistics.pipelines++;
+        return statistics;
+    }
+
+}
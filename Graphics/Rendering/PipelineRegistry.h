@@ -0,0 +1,211 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "Pipeline.h"
+#include "PipelineCache.h"
+
+#include "MultiThreading/ThreadPool.h"
+
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+
+namespace Graphics {
+
+    // deduplicates graphics pipelines by everything the Pipeline constructor reads,
+    // materials that end up with the same state share one pipeline instead of compiling their own
+    // the state is serialized and kept next to its entry, a hash hit only counts if the state matches,
+    // a collision moves on to the next key
+    // pipelines can be requested ahead of time and compiled on the thread pool
+    // everything passed in has to outlive the registry or at least any pending creation
+    class PipelineRegistry
+    {
+    public:
+        using Key = uint64_t;
+        using State = std::vector<uint8_t>;
+
+        struct Statistics
+        {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t pending = 0;
+            size_t pipelines = 0;
+        };
+
+    private:
+        struct Entry
+        {
+            State state;
+            std::unique_ptr<Pipeline> pipeline;
+            std::exception_ptr error;
+            bool ready = false;
+        };
+
+        MT::ThreadPool* m_threadPool = nullptr;
+        const PipelineCache* m_cache = nullptr;
+
+        std::unordered_map<Key, Entry> m_entries;
+        size_t m_hits = 0;
+        size_t m_misses = 0;
+        size_t m_pending = 0;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_created;
+
+        bool m_initialized = false;
+    public:
+
+        PipelineRegistry() {};
+
+        PipelineRegistry(MT::ThreadPool& threadPool, const PipelineCache* cache = nullptr) :
+            m_threadPool(&threadPool), m_cache(cache), m_initialized(true) {};
+
+        // creation tasks hold a pointer to the registry, so it stays where it was created
+        PipelineRegistry(PipelineRegistry&&) noexcept = delete;
+        PipelineRegistry& operator=(PipelineRegistry&&) noexcept = delete;
+
+        PipelineRegistry(const PipelineRegistry&) noexcept = delete;
+        PipelineRegistry& operator=(const PipelineRegistry&) noexcept = delete;
+
+        ~PipelineRegistry() { assert(!m_initialized && "PipelineRegistry was not destroyed!"); };
+
+        // waits for pending creations and destroys every pipeline
+        void destroy(const Context& instance, const Device& device);
+
+        template <VertexDefinition... VertexDefs>
+        static State serializeState(const RenderPass& renderPass, const Pipeline::ShaderBundle& shaders,
+            const SwapChainFormat& format, const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const std::vector<vk::PushConstantRange>& pushConstantRanges)
+        {
+            State state;
+            auto appendValue = [&state](const auto& value) {
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+                state.insert(state.end(), bytes, bytes + sizeof(value));
+            };
+
+            auto hashShader = [&]<Shader::Type Type>() {
+                VkShaderModule module = shaders.hasShader<Type>() ?
+                    static_cast<VkShaderModule>(shaders.getShader<Type>().getModule()) : VK_NULL_HANDLE;
+                appendValue(module);
+            };
+            hashShader.template operator()<Shader::Type::Vertex>();
+            hashShader.template operator()<Shader::Type::Fragment>();
+            hashShader.template operator()<Shader::Type::Geometry>();
+            hashShader.template operator()<Shader::Type::TessellationControl>();
+            hashShader.template operator()<Shader::Type::TessellationEvaluation>();
+
+            // field by field so padding never ends up in the state
+            for (const auto& binding : vertices.enumerateBindings()) {
+                appendValue(binding.binding);
+                appendValue(binding.stride);
+                appendValue(binding.inputRate);
+            }
+            for (const auto& attribute : vertices.enumerateAttributes()) {
+                appendValue(attribute.location);
+                appendValue(attribute.binding);
+                appendValue(attribute.format);
+                appendValue(attribute.offset);
+            }
+
+            appendValue(layouts.size());
+            for (const auto* layout : layouts)
+                appendValue(static_cast<VkDescriptorSetLayout>(layout->getLayout()));
+
+            appendValue(pushConstantRanges.size());
+            for (const auto& range : pushConstantRanges) {
+                appendValue(range.stageFlags);
+                appendValue(range.offset);
+                appendValue(range.size);
+            }
+
+            appendValue(static_cast<VkRenderPass>(renderPass.getRenderPass()));
+            appendValue(format.getDepthFormat());
+
+            return state;
+        }
+
+        static Key hashState(const State& state) { return hashBytes(state.data(), state.size()); };
+
+        // returns the pipeline for the state, creating it on this thread if it doesn't exist yet
+        // or waiting for it if it is being created in the background
+        template <VertexDefinition... VertexDefs>
+        const Pipeline& get(const Context& instance, const Device& device, const RenderPass& renderPass,
+            const Pipeline::ShaderBundle& shaders, const RenderRegion& canvas, const SwapChainFormat& format,
+            const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts)
+        {
+            return get(instance, device, renderPass, shaders, canvas, format, vertices, layouts, PushConstantDefinitions<>());
+        }
+
+        template <VertexDefinition... VertexDefs, PushConstantDefinition... PushConstantDefs>
+        const Pipeline& get(const Context& instance, const Device& device, const RenderPass& renderPass,
+            const Pipeline::ShaderBundle& shaders, const RenderRegion& canvas, const SwapChainFormat& format,
+            const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const PushConstantDefinitions<PushConstantDefs...>& pushConstants)
+        {
+            Key key = 0;
+            if (!reserve(serializeState(renderPass, shaders, format, vertices, layouts, pushConstants.enumerateRanges()), key))
+                return wait(key);
+
+            create(key, [&]() {
+                return std::make_unique<Pipeline>(instance, device, renderPass,
+                    shaders, canvas, format, vertices, layouts, pushConstants, m_cache);
+                });
+            return wait(key);
+        }
+
+        // queues creation of the pipeline on the thread pool unless it already exists,
+        // the key can be polled with find() or waited on
+        template <VertexDefinition... VertexDefs>
+        Key request(const Context& instance, const Device& device, const RenderPass& renderPass,
+            const Pipeline::ShaderBundle& shaders, const RenderRegion& canvas, const SwapChainFormat& format,
+            const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts)
+        {
+            return request(instance, device, renderPass, shaders, canvas, format, vertices, layouts, PushConstantDefinitions<>());
+        }
+
+        template <VertexDefinition... VertexDefs, PushConstantDefinition... PushConstantDefs>
+        Key request(const Context& instance, const Device& device, const RenderPass& renderPass,
+            const Pipeline::ShaderBundle& shaders, const RenderRegion& canvas, const SwapChainFormat& format,
+            const VertexDefinitions<VertexDefs...>& vertices,
+            const std::vector<const DescriptorSetLayout*>& layouts,
+            const PushConstantDefinitions<PushConstantDefs...>& pushConstants)
+        {
+            Key key = 0;
+            if (!reserve(serializeState(renderPass, shaders, format, vertices, layouts, pushConstants.enumerateRanges()), key))
+                return key;
+
+            auto task = [this, key, &instance, &device, &renderPass, shaders, &canvas, &format, vertices, layouts, pushConstants]() {
+                create(key, [&]() {
+                    return std::make_unique<Pipeline>(instance, device, renderPass,
+                        shaders, canvas, format, vertices, layouts, pushConstants, m_cache);
+                    });
+                };
+
+            // pool is shutting down, create it here instead
+            if (!m_threadPool->pushTask(task))
+                task();
+
+            return key;
+        }
+
+        // nullptr while the pipeline is still being created or if the key is unknown
+        const Pipeline* find(Key key) const;
+
+        // blocks until the pipeline exists, rethrows if its creation failed
+        const Pipeline& wait(Key key);
+
+        bool contains(Key key) const;
+        Statistics getStatistics() const;
+
+    private:
+        // finds the key of the state and counts a hit or miss, returns true if the caller has to create the pipeline
+        bool reserve(State&& state, Key& key);
+        void create(Key key, const std::function<std::unique_ptr<Pipeline>()>& factory);
+    };
+
+}
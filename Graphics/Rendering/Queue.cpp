@@ -104,6 +104,85 @@ namespace Graphics {
         }
     }
 
+    void Queue::submit(const Context& instance,
+        const std::vector<vk::PipelineStageFlags>& waitStages,
+        const std::vector<std::reference_wrapper<const Semaphore>>& waitSenaphores,
+        const std::vector<std::reference_wrapper<const CommandBufferHandle>>& commandBuffers,
+        const std::vector<std::reference_wrapper<const Semaphore>>& signalSemaphores,
+        const std::vector<TimelineWait>& timelineWaits,
+        const TimelineSemaphore& signalTimeline, uint64_t signalValue) const
+    {
+        vk::SubmitInfo submitInfo{};
+        submitInfo.sType = vk::StructureType::eSubmitInfo;
+
+        size_t waitCount = waitSenaphores.size() + timelineWaits.size();
+        size_t signalCount = signalSemaphores.size() + 1;
+
+        std::vector<vk::Semaphore> waitSemaphoresRaw;
+        waitSemaphoresRaw.reserve(waitCount);
+        std::vector<vk::PipelineStageFlags> waitStagesRaw;
+        waitStagesRaw.reserve(waitCount);
+        std::vector<uint64_t> waitValues;
+        waitValues.reserve(waitCount);
+
+        std::vector<vk::CommandBuffer> commandBuffersRaw;
+        commandBuffersRaw.reserve(commandBuffers.size());
+
+        std::vector<vk::Semaphore> signalSemaphoresRaw;
+        signalSemaphoresRaw.reserve(signalCount);
+        std::vector<uint64_t> signalValues;
+        signalValues.reserve(signalCount);
+
+        // values of binary semaphores are ignored but the arrays have to line up
+        for (int i = 0; i < waitSenaphores.size(); ++i) {
+            waitSemaphoresRaw.push_back(waitSenaphores[i].get().getSemaphore());
+            waitStagesRaw.push_back(waitStages[i]);
+            waitValues.push_back(0);
+        }
+        for (const auto& wait : timelineWaits) {
+            waitSemaphoresRaw.push_back(wait.semaphore.get().getSemaphore());
+            waitStagesRaw.push_back(wait.stage);
+            waitValues.push_back(wait.value);
+        }
+        for (int i = 0; i < commandBuffers.size(); ++i)
+            commandBuffersRaw.push_back(commandBuffers[i].get()->getCommandBuffer());
+        for (int i = 0; i < signalSemaphores.size(); ++i) {
+            signalSemaphoresRaw.push_back(signalSemaphores[i].get().getSemaphore());
+            signalValues.push_back(0);
+        }
+        signalSemaphoresRaw.push_back(signalTimeline.getSemaphore());
+        signalValues.push_back(signalValue);
+
+        vk::TimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = vk::StructureType::eTimelineSemaphoreSubmitInfo;
+        timelineInfo.waitSemaphoreValueCount = waitValues.size();
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = signalValues.size();
+        timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+        submitInfo.pNext = &timelineInfo;
+
+        submitInfo.waitSemaphoreCount = waitSemaphoresRaw.size();
+        submitInfo.pWaitSemaphores = waitSemaphoresRaw.data();
+        submitInfo.pWaitDstStageMask = waitStagesRaw.data();
+
+        submitInfo.commandBufferCount = commandBuffersRaw.size();
+        submitInfo.pCommandBuffers = commandBuffersRaw.data();
+
+        submitInfo.signalSemaphoreCount = signalSemaphoresRaw.size();
+        submitInfo.pSignalSemaphores = signalSemaphoresRaw.data();
+
+        try {
+            m_queue.submit(submitInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to submit command buffers: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when submitting command buffers: " + std::string(e.what()));
+        }
+    }
+
     //template<typename... SemaphoresWait, typename... CmdBuffers>
     //void Queue::submit(
     //    const Context& instance,
@@ -4,6 +4,7 @@
 #include "Device.h"
 #include "SwapChainFormat.h"
 #include "Semaphore.h"
+#include "TimelineSemaphore.h"
 #include "Fence.h"
 #include "CommandBuffer.h"
 #include "CommandPool.h"
@@ -49,6 +50,15 @@ namespace Graphics {
             const std::vector<std::reference_wrapper<const CommandBufferHandle>>& commandBuffers,
             const std::vector<std::reference_wrapper<const Semaphore>>& signalSemaphores) const;
 
+        // binary semaphores can be mixed with timeline waits, the timeline is set to signalValue once the batch is done
+        void submit(const Context& instance,
+            const std::vector<vk::PipelineStageFlags>& waitStages,
+            const std::vector<std::reference_wrapper<const Semaphore>>& waitSenaphores,
+            const std::vector<std::reference_wrapper<const CommandBufferHandle>>& commandBuffers,
+            const std::vector<std::reference_wrapper<const Semaphore>>& signalSemaphores,
+            const std::vector<TimelineWait>& timelineWaits,
+            const TimelineSemaphore& signalTimeline, uint64_t signalValue) const;
+
         template<size_t WaitSemaphoresSize, size_t CommandBuffersSize, size_t SignalSemaphoresSize>
         void submit(
             const Context& instance,
@@ -157,7 +167,8 @@ namespace Graphics {
 
             try {
                 vk::Result result = m_queue.presentKHR(presentInfo, instance.getDispatchLoader());
-                if (result != vk::Result::eSuccess)
+                // suboptimal is a success code, the image was still presented
+                if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
                     throw std::runtime_error("failed to present: " + vk::to_string(result));
             }
             catch (const vk::SystemError& e) {
@@ -200,7 +211,8 @@ namespace Graphics {
 
             try {
                 vk::Result result = m_queue.presentKHR(presentInfo, instance.getDispatchLoader());
-                if (result != vk::Result::eSuccess)
+                // suboptimal is a success code, the image was still presented
+                if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR)
                     throw std::runtime_error("failed to present: " + vk::to_string(result));
             }
             catch (const vk::SystemError& e) {
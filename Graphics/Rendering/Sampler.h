@@ -62,7 +62,7 @@ namespace Graphics {
                 m_samplerInfo.mipmapMode = vk::SamplerMipmapMode::eLinear;
                 m_samplerInfo.mipLodBias = 0.0f;
                 m_samplerInfo.minLod = 0.0f;
-                m_samplerInfo.maxLod = 0.0f;
+                m_samplerInfo.maxLod = VK_LOD_CLAMP_NONE; // images clamp to their own mip count
             }
 
             Descriptor(Descriptor&&) noexcept = default;
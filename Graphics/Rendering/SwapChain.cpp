@@ -11,18 +11,22 @@ namespace Graphics {
     void SwapChain::init(const Context& instance, const Device& device, const Surface& surface,
         const RenderPass& renderPass, const SwapChainFormat& format,
         uint32_t presentQueueIndex, uint32_t workerQueueIndex)
+    {
+        create(instance, device, surface, renderPass, format, presentQueueIndex, workerQueueIndex, nullptr);
+        m_initialized = true;
+    }
+
+    void SwapChain::create(const Context& instance, const Device& device, const Surface& surface,
+        const RenderPass& renderPass, const SwapChainFormat& format,
+        uint32_t presentQueueIndex, uint32_t workerQueueIndex, vk::SwapchainKHR oldSwapChain)
     {
         m_activeSwapChainFormat = format;
         auto supportDetails = device.getPhysicalDevice().getSwapChainSupportDetails(instance, surface);
 
-        m_imageCount = supportDetails.capabilities.minImageCount + 1;
-        auto d = supportDetails.capabilities.currentTransform;
-        if (supportDetails.capabilities.maxImageCount > 0 && m_imageCount > supportDetails.capabilities.maxImageCount) {
-            m_imageCount = supportDetails.capabilities.maxImageCount;
-        }
+        m_imageCount = SwapChainFormat::chooseImageCount(supportDetails, format.getImageCount());
 
         m_swapChain = createSwapChain(instance, device, supportDetails, surface,
-            m_activeSwapChainFormat, m_imageCount, presentQueueIndex, workerQueueIndex);
+            m_activeSwapChainFormat, m_imageCount, presentQueueIndex, workerQueueIndex, oldSwapChain);
         m_swapChainImages = getSwapChainImages(instance, device, m_swapChain, m_imageCount);
         m_swapChainImageViews = createImageViews(instance, device, m_activeSwapChainFormat, m_swapChainImages);
 
@@ -34,20 +38,69 @@ namespace Graphics {
         }
         else m_swapChainFrameBuffers = createFrameBuffers(instance, device, renderPass,
             m_swapChainImageViews, m_activeSwapChainFormat);
-        m_initialized = true;
     }
 
     void SwapChain::recreate(const Context& instance, const Device& device, const Surface& surface,
-        const RenderPass& renderPass, const SwapChainFormat& format, uint32_t presentQueueIndex, uint32_t workerQueueIndex)
+        const RenderPass& renderPass, const SwapChainFormat& format, uint32_t presentQueueIndex, uint32_t workerQueueIndex,
+        uint64_t lastFrame)
     {
-        destroy(instance, device);
-        init(instance, device, surface, renderPass, format, presentQueueIndex, workerQueueIndex);
+        if (!m_initialized) {
+            init(instance, device, surface, renderPass, format, presentQueueIndex, workerQueueIndex);
+            return;
+        }
+
+        Retired retired;
+        retired.swapChain = std::exchange(m_swapChain, nullptr);
+        retired.imageViews = std::exchange(m_swapChainImageViews, {});
+        retired.frameBuffers = std::exchange(m_swapChainFrameBuffers, {});
+        if (m_activeSwapChainFormat.getDepthFormat() != vk::Format::eUndefined) {
+            retired.depthImage = std::exchange(m_depthImage, nullptr);
+            retired.depthImageView = std::exchange(m_depthImageView, nullptr);
+            retired.depthImageMemory = std::exchange(m_depthImageMemory, Memory());
+        }
+        retired.lastFrame = lastFrame;
+        m_swapChainImages.clear();
+        m_suboptimal = false;
+
+        // the old swapchain is retired by the driver either way, so it goes to the list before creating
+        // and gets cleaned up normally even if the creation throws
+        m_retired.push_back(std::move(retired));
+        create(instance, device, surface, renderPass, format, presentQueueIndex, workerQueueIndex,
+            m_retired.back().swapChain);
+    }
+
+    void SwapChain::releaseRetired(const Context& instance, const Device& device, uint64_t completedFrame)
+    {
+        // retired in frame order, so the finished ones are always at the front
+        while (!m_retired.empty() && m_retired.front().lastFrame <= completedFrame) {
+            destroyRetired(instance, device, m_retired.front());
+            m_retired.pop_front();
+        }
+    }
+
+    void SwapChain::destroyRetired(const Context& instance, const Device& device, Retired& retired)
+    {
+        for (auto framebuffer : retired.frameBuffers)
+            device.getDevice().destroyFramebuffer(framebuffer, nullptr, instance.getDispatchLoader());
+
+        for (auto& imageView : retired.imageViews)
+            device.getDevice().destroyImageView(imageView, nullptr, instance.getDispatchLoader());
+
+        if (retired.depthImageView)
+            device.getDevice().destroyImageView(retired.depthImageView, nullptr, instance.getDispatchLoader());
+        if (retired.depthImage) {
+            retired.depthImageMemory.destroy(instance, device);
+            device.getDevice().destroyImage(retired.depthImage, nullptr, instance.getDispatchLoader());
+        }
+
+        if (retired.swapChain)
+            device.getDevice().destroySwapchainKHR(retired.swapChain, nullptr, instance.getDispatchLoader());
     }
 
     vk::SwapchainKHR SwapChain::createSwapChain(const Context& instance,
         const Device& device, const SwapChainSupportDetails& swapChainSupportDetails,
         const Surface& surface, const SwapChainFormat& activeSwapChainFormat, uint32_t imageCount,
-        uint32_t presentQueueIndex, uint32_t workerQueueIndex)
+        uint32_t presentQueueIndex, uint32_t workerQueueIndex, vk::SwapchainKHR oldSwapChain /*= nullptr*/)
     {
         vk::SwapchainCreateInfoKHR createInfo{};
         createInfo.sType = vk::StructureType::eSwapchainCreateInfoKHR;
@@ -73,7 +126,7 @@ namespace Graphics {
         createInfo.compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque;
         createInfo.presentMode = activeSwapChainFormat.getPresentMode();
         createInfo.clipped = VK_TRUE;
-        createInfo.oldSwapchain = VK_NULL_HANDLE;
+        createInfo.oldSwapchain = oldSwapChain;
 
         vk::SwapchainKHR swapChain;
         try {
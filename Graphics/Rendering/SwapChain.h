@@ -6,10 +6,30 @@
 #include "Semaphore.h"
 #include "../MemoryManagement/Memory.h"
 
+#include <deque>
+
 namespace Graphics {
 
+    // recreate() hands the current swapchain to the new one as oldSwapchain and keeps the old images,
+    // views, framebuffers and depth image around until the frames that used them are finished,
+    // so resizing never has to idle the whole device
     class SwapChain {
     private:
+        // everything a swapchain owns, kept alive after a recreate until the gpu is done with it
+        struct Retired
+        {
+            vk::SwapchainKHR swapChain = nullptr;
+            std::vector<vk::ImageView> imageViews;
+            std::vector<vk::Framebuffer> frameBuffers;
+
+            vk::Image depthImage = nullptr;
+            vk::ImageView depthImageView = nullptr;
+            Memory depthImageMemory;
+
+            // last frame number that may still use these
+            uint64_t lastFrame = 0;
+        };
+
         vk::SwapchainKHR m_swapChain;
         SwapChainFormat m_activeSwapChainFormat;
 
@@ -24,6 +44,9 @@ namespace Graphics {
 
         uint32_t m_imageCount;
 
+        std::deque<Retired> m_retired;
+        bool m_suboptimal = false;
+
         bool m_initialized = false;
     public:
         SwapChain() : m_swapChain(nullptr), m_activeSwapChainFormat(), m_imageCount(0), m_initialized(false) {};
@@ -44,6 +67,9 @@ namespace Graphics {
             m_depthImageView = std::exchange(other.m_depthImageView, vk::ImageView());
             m_depthImageMemory = std::exchange(other.m_depthImageMemory, Memory());
 
+            m_retired = std::exchange(other.m_retired, {});
+            m_suboptimal = std::exchange(other.m_suboptimal, false);
+
             m_initialized = std::exchange(other.m_initialized, false);
         };
 
@@ -66,6 +92,9 @@ namespace Graphics {
             m_depthImageView = std::exchange(other.m_depthImageView, vk::ImageView());
             m_depthImageMemory = std::exchange(other.m_depthImageMemory, Memory());
 
+            m_retired = std::exchange(other.m_retired, {});
+            m_suboptimal = std::exchange(other.m_suboptimal, false);
+
             m_initialized = std::exchange(other.m_initialized, false);
 
             return *this;
@@ -81,13 +110,28 @@ namespace Graphics {
 
         void initDepthImage(const Context& instance, const Device& device);
 
+        // builds the new swapchain from the current one without waiting on the device,
+        // the old resources are destroyed by releaseRetired() once lastFrame is finished,
+        // with a FrameScheduler that is the current getFrameNumber()
         void recreate(const Context& instance, const Device& device, const Surface& surface,
-            const RenderPass& renderPass, const SwapChainFormat& format, uint32_t presentQueueIndex, uint32_t workerQueueIndex);
+            const RenderPass& renderPass, const SwapChainFormat& format, uint32_t presentQueueIndex, uint32_t workerQueueIndex,
+            uint64_t lastFrame);
+
+        // destroys retired resources of every frame up to and including completedFrame,
+        // meant to be called once per frame after the frame slot has been waited on
+        void releaseRetired(const Context& instance, const Device& device, uint64_t completedFrame);
+
+        size_t getRetiredCount() const { return m_retired.size(); };
 
+        // the caller has to make sure the gpu is done with the swapchain, retired resources included
         void destroy(const Context& instance, const Device& device) {
             if (!m_initialized)
                 return;
 
+            for (auto& retired : m_retired)
+                destroyRetired(instance, device, retired);
+            m_retired.clear();
+
             for (auto framebuffer : m_swapChainFrameBuffers) {
                 device.getDevice().destroyFramebuffer(framebuffer, nullptr, instance.getDispatchLoader());
             }
@@ -119,7 +163,7 @@ namespace Graphics {
         static vk::SwapchainKHR createSwapChain(const Context& instance,
             const Device& device, const SwapChainSupportDetails& swapChainSupportDetails,
             const Surface& surface, const SwapChainFormat& activeSwapChainFormat, uint32_t imageCount,
-            uint32_t presentQueueIndex, uint32_t workerQueueIndex);
+            uint32_t presentQueueIndex, uint32_t workerQueueIndex, vk::SwapchainKHR oldSwapChain = nullptr);
 
         static std::vector<vk::Image> getSwapChainImages(const Context& instance,
             const Device& device, const vk::SwapchainKHR& swapChain, uint32_t& imageCount);
@@ -141,19 +185,33 @@ namespace Graphics {
 
         const std::vector<vk::Framebuffer>& getFrameBuffers() const { return m_swapChainFrameBuffers; };
 
+        // returns false if the swapchain is out of date and has to be recreated before rendering,
+        // a suboptimal image is still acquired and signals the semaphore, so it is returned as usable
+        // and only flagged, recreate after presenting it
         bool acquireNextImage(const Context& instance, const Device& device,
-            const Semaphore& semaphore, uint32_t& imageIndex) const {
+            const Semaphore& semaphore, uint32_t& imageIndex) {
             vk::Result result = device.getDevice().acquireNextImageKHR(
                 m_swapChain, UINT64_MAX, semaphore.getSemaphore(), nullptr, &imageIndex);
-            if (result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR)
+            if (result == vk::Result::eErrorOutOfDateKHR)
                 return false;
+            else if (result == vk::Result::eSuboptimalKHR)
+                m_suboptimal = true;
             else if (result != vk::Result::eSuccess)
                 throw std::runtime_error("Error acquiring next image");
             return true;
         };
 
+        bool isSuboptimal() const { return m_suboptimal; };
+
         const vk::SwapchainKHR& getSwapChain() const { return m_swapChain; };
         const size_t& getImageCount() const { return m_imageCount; };
+
+    private:
+        void create(const Context& instance, const Device& device, const Surface& surface,
+            const RenderPass& renderPass, const SwapChainFormat& format, uint32_t presentQueueIndex, uint32_t workerQueueIndex,
+            vk::SwapchainKHR oldSwapChain);
+
+        static void destroyRetired(const Context& instance, const Device& device, Retired& retired);
     };
 
 }
\ No newline at end of file
@@ -17,14 +17,35 @@ namespace Graphics {
     vk::PresentModeKHR SwapChainFormat::choosePresentMode(
         const SwapChainSupportDetails& supportDetails)
     {
-        for (const auto& availablePresentMode : supportDetails.presentModes) {
-            if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
-                return availablePresentMode;
-            }
+        return choosePresentMode(supportDetails, PresentPolicy::defaultPolicy().presentModes);
+    }
+
+    vk::PresentModeKHR SwapChainFormat::choosePresentMode(
+        const SwapChainSupportDetails& supportDetails,
+        const std::vector<vk::PresentModeKHR>& preferredModes)
+    {
+        for (const auto& preferredMode : preferredModes) {
+            if (std::find(supportDetails.presentModes.begin(), supportDetails.presentModes.end(),
+                preferredMode) != supportDetails.presentModes.end())
+                return preferredMode;
         }
         return vk::PresentModeKHR::eFifo;
     }
 
+    uint32_t SwapChainFormat::chooseImageCount(
+        const SwapChainSupportDetails& supportDetails, uint32_t imageCount)
+    {
+        const auto& capabilities = supportDetails.capabilities;
+        if (imageCount == 0)
+            imageCount = capabilities.minImageCount + 1;
+
+        imageCount = std::max(imageCount, capabilities.minImageCount);
+        // a max of 0 means there is no limit
+        if (capabilities.maxImageCount > 0)
+            imageCount = std::min(imageCount, capabilities.maxImageCount);
+        return imageCount;
+    }
+
     vk::Extent2D SwapChainFormat::chooseExtent(
         const SwapChainSupportDetails& supportDetails, Extent extent)
     {
@@ -6,6 +6,45 @@
 
 namespace Graphics {
 
+    // how the swapchain trades latency for throughput
+    struct PresentPolicy
+    {
+        // tried in order, the first one the surface supports wins,
+        // fifo is always supported so it is the fallback if none of them are
+        std::vector<vk::PresentModeKHR> presentModes = { vk::PresentModeKHR::eMailbox };
+
+        // 0 keeps the default of minImageCount + 1, anything else is clamped to what the surface allows
+        uint32_t imageCount = 0;
+
+        static PresentPolicy defaultPolicy() {
+            return PresentPolicy();
+        }
+
+        // vsync without tearing, every frame is shown
+        static PresentPolicy vsyncPolicy() {
+            PresentPolicy policy;
+            policy.presentModes = {};
+            return policy;
+        }
+
+        // lowest input lag, tears if immediate is available, fewest images the surface allows
+        static PresentPolicy lowLatencyPolicy() {
+            PresentPolicy policy;
+            policy.presentModes = { vk::PresentModeKHR::eImmediate,
+                vk::PresentModeKHR::eMailbox, vk::PresentModeKHR::eFifoRelaxed };
+            policy.imageCount = 2;
+            return policy;
+        }
+
+        // never blocks on present, the gpu always has an image to render to
+        static PresentPolicy throughputPolicy() {
+            PresentPolicy policy;
+            policy.presentModes = { vk::PresentModeKHR::eMailbox, vk::PresentModeKHR::eImmediate };
+            policy.imageCount = 3;
+            return policy;
+        }
+    };
+
     class SwapChainFormat
     {
     private:
@@ -13,6 +52,9 @@ namespace Graphics {
         vk::PresentModeKHR m_presentMode;
         vk::Extent2D m_swapChainExtent;
 
+        // 0 means minImageCount + 1
+        uint32_t m_imageCount = 0;
+
         //optional
         vk::Format m_depthFormat = vk::Format::eUndefined;
 
@@ -49,30 +91,40 @@ namespace Graphics {
         void setSurfaceFormat(vk::SurfaceFormatKHR surfaceFormat) { this->m_surfaceFormat = surfaceFormat; };
         void setPresentMode(vk::PresentModeKHR presentMode) { this->m_presentMode = presentMode; };
         void setSwapChainExtent(vk::Extent2D swapChainExtent) { this->m_swapChainExtent = swapChainExtent; };
+        void setImageCount(uint32_t imageCount) { this->m_imageCount = imageCount; };
 
         vk::SurfaceFormatKHR getSurfaceFormat() const { return m_surfaceFormat; };
         vk::PresentModeKHR getPresentMode() const { return m_presentMode; };
         vk::Extent2D getSwapChainExtent() const { return m_swapChainExtent; };
         vk::Format getDepthFormat() const { return m_depthFormat; };
+        uint32_t getImageCount() const { return m_imageCount; };
 
         static vk::SurfaceFormatKHR chooseSurfaceFormat(const SwapChainSupportDetails& supportDetails);
         static vk::PresentModeKHR choosePresentMode(const SwapChainSupportDetails& supportDetails);
+        static vk::PresentModeKHR choosePresentMode(const SwapChainSupportDetails& supportDetails,
+            const std::vector<vk::PresentModeKHR>& preferredModes);
         static vk::Extent2D chooseExtent(const SwapChainSupportDetails& supportDetails, Extent extent);
 
+        // image count the swapchain will actually be created with
+        static uint32_t chooseImageCount(const SwapChainSupportDetails& supportDetails, uint32_t imageCount);
+
         static SwapChainFormat create(
             const Context& instance,
             const Device& device,
             const Surface& surface,
-            const Extent& extent
+            const Extent& extent,
+            const PresentPolicy& policy = PresentPolicy::defaultPolicy()
         ) {
             SwapChainSupportDetails supports = device.getPhysicalDevice()
                 .getSwapChainSupportDetails(instance, surface);
 
-            return SwapChainFormat(instance, device,
+            SwapChainFormat format(instance, device,
                 chooseSurfaceFormat(supports),
-                choosePresentMode(supports),
+                choosePresentMode(supports, policy.presentModes),
                 chooseExtent(supports, extent)
             );
+            format.setImageCount(policy.imageCount);
+            return format;
         };
 
         bool isValid() const {
@@ -0,0 +1,71 @@
+#include "TimelineSemaphore.h"
+
+namespace Graphics {
+
+    TimelineSemaphore::TimelineSemaphore(const Context& instance, const Device& device, uint64_t initialValue /*= 0*/)
+    {
+        vk::SemaphoreTypeCreateInfo typeInfo{};
+        typeInfo.sType = vk::StructureType::eSemaphoreTypeCreateInfo;
+        typeInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+        typeInfo.initialValue = initialValue;
+
+        vk::SemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = vk::StructureType::eSemaphoreCreateInfo;
+        semaphoreInfo.pNext = &typeInfo;
+
+        try {
+            m_semaphore = device.getDevice().createSemaphore(semaphoreInfo, nullptr, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to create a timeline semaphore: " + std::string(e.what()));
+        }
+        catch (const std::exception& e) {
+            throw std::runtime_error("Unexpected error when creating a timeline semaphore: " + std::string(e.what()));
+        }
+
+        m_initialized = true;
+    }
+
+    uint64_t TimelineSemaphore::getValue(const Context& instance, const Device& device) const
+    {
+        try {
+            return device.getDevice().getSemaphoreCounterValue(m_semaphore, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to get timeline semaphore value: " + std::string(e.what()));
+        }
+    }
+
+    bool TimelineSemaphore::wait(const Context& instance, const Device& device,
+        uint64_t value, uint64_t timeout /*= UINT64_MAX*/) const
+    {
+        vk::SemaphoreWaitInfo waitInfo{};
+        waitInfo.sType = vk::StructureType::eSemaphoreWaitInfo;
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_semaphore;
+        waitInfo.pValues = &value;
+
+        vk::Result result = device.getDevice().waitSemaphores(waitInfo, timeout, instance.getDispatchLoader());
+        if (result == vk::Result::eSuccess)
+            return true;
+        if (result == vk::Result::eTimeout)
+            return false;
+        throw std::runtime_error("Error waiting for a timeline semaphore: " + vk::to_string(result));
+    }
+
+    void TimelineSemaphore::signal(const Context& instance, const Device& device, uint64_t value) const
+    {
+        vk::SemaphoreSignalInfo signalInfo{};
+        signalInfo.sType = vk::StructureType::eSemaphoreSignalInfo;
+        signalInfo.semaphore = m_semaphore;
+        signalInfo.value = value;
+
+        try {
+            device.getDevice().signalSemaphore(signalInfo, instance.getDispatchLoader());
+        }
+        catch (const vk::SystemError& e) {
+            throw std::runtime_error("failed to signal a timeline semaphore: " + std::string(e.what()));
+        }
+    }
+
+}
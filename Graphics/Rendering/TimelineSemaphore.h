@@ -0,0 +1,80 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+
+namespace Graphics {
+
+    // semaphore with a 64 bit counter instead of a signaled bit, requires DeviceFeature::TimelineSemaphore
+    // the gpu and the host can both wait for the counter to reach a value and both can signal it
+    class TimelineSemaphore
+    {
+    private:
+        vk::Semaphore m_semaphore;
+
+        bool m_initialized = false;
+    public:
+
+        TimelineSemaphore() {};
+        TimelineSemaphore(const Context& instance, const Device& device, uint64_t initialValue = 0);
+
+        TimelineSemaphore(TimelineSemaphore&& other) noexcept {
+
+            m_semaphore = std::exchange(other.m_semaphore, nullptr);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+        };
+
+        //moving to an initialized semaphore is undefined behavior, destroy before moving
+        TimelineSemaphore& operator=(TimelineSemaphore&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "TimelineSemaphore::operator=() - TimelineSemaphore already initialized");
+
+            m_semaphore = std::exchange(other.m_semaphore, nullptr);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        TimelineSemaphore(const TimelineSemaphore&) noexcept = delete;
+        TimelineSemaphore& operator=(const TimelineSemaphore&) noexcept = delete;
+
+        ~TimelineSemaphore() { assert(!m_initialized && "TimelineSemaphore was not destroyed!"); };
+
+        void destroy(const Context& instance, const Device& device) {
+            if (!m_initialized)
+                return;
+
+            device.getDevice().destroySemaphore(m_semaphore, nullptr, instance.getDispatchLoader());
+#ifdef _DEBUG
+            std::cout << "Destroyed timeline semaphore" << std::endl;
+#endif
+            m_initialized = false;
+        }
+
+        uint64_t getValue(const Context& instance, const Device& device) const;
+
+        // returns false if the timeout ran out before the counter reached the value
+        bool wait(const Context& instance, const Device& device, uint64_t value, uint64_t timeout = UINT64_MAX) const;
+
+        // the value has to be bigger than the current one and than any pending gpu signal
+        void signal(const Context& instance, const Device& device, uint64_t value) const;
+
+        bool isInitialized() const { return m_initialized; };
+
+        const vk::Semaphore& getSemaphore() const { return m_semaphore; };
+
+    };
+
+    // a wait on a timeline semaphore as part of a queue submission
+    struct TimelineWait
+    {
+        std::reference_wrapper<const TimelineSemaphore> semaphore;
+        uint64_t value;
+        vk::PipelineStageFlags stage;
+    };
+
+}
@@ -0,0 +1,215 @@
+#include "UploadQueue.h"
+
+namespace Graphics {
+
+    UploadQueue::UploadQueue(const Context& instance, const Device& device,
+        const Queue& queue, size_t maxBatchesInFlight /*= 4*/) :
+        m_queue(&queue), m_maxBatchesInFlight(maxBatchesInFlight)
+    {
+        assert(m_maxBatchesInFlight > 0 && "UploadQueue::UploadQueue() - At least one batch has to be allowed in flight");
+
+        m_pool = CommandPool(instance, device, queue.getFamily());
+        m_initialized = true;
+    }
+
+    void UploadQueue::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& batch : m_inFlight) {
+            batch.fence.wait(instance, device);
+            retire(batch);
+            m_freeBatches.push_back(std::move(batch));
+        }
+        m_inFlight.clear();
+
+        if (m_isRecording) {
+            m_recording.commandBuffer->stopRecord(instance);
+            m_freeBatches.push_back(std::move(m_recording));
+            m_isRecording = false;
+        }
+
+        for (auto& batch : m_freeBatches) {
+            m_pool.freeBuffer(instance, device, batch.commandBuffer);
+            batch.fence.destroy(instance, device);
+        }
+        m_freeBatches.clear();
+
+        m_pool.destroy(instance, device);
+#ifdef _DEBUG
+        std::cout << "Destroyed UploadQueue" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    void UploadQueue::beginBatch(const Context& instance, const Device& device)
+    {
+        if (m_isRecording)
+            return;
+
+        if (m_freeBatches.empty()) {
+            Batch batch;
+            batch.commandBuffer = m_pool.allocateBuffer(instance, device);
+            batch.fence = Fence(instance, device);
+            m_freeBatches.push_back(std::move(batch));
+        }
+
+        m_recording = std::move(m_freeBatches.back());
+        m_freeBatches.pop_back();
+
+        m_recording.ticket = m_nextTicket;
+        m_recording.empty = true;
+        m_recording.commandBuffer->reset(instance);
+        m_recording.commandBuffer->record(instance, CommandBufferUsage::Bits::OneTimeSubmit);
+        m_isRecording = true;
+    }
+
+    UploadQueue::Ticket UploadQueue::enqueue(const Context& instance, const Device& device, RecordFunc&& func)
+    {
+        assert(m_initialized && "UploadQueue::enqueue() - UploadQueue is not initialized");
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        beginBatch(instance, device);
+        func(m_recording.commandBuffer);
+        m_recording.empty = false;
+        return m_recording.ticket;
+    }
+
+    UploadQueue::Ticket UploadQueue::enqueueBufferCopy(const Context& instance, const Device& device,
+        const Buffer& srcBuffer, const Buffer& dstBuffer, const CopyRegion& copyRegion)
+    {
+        return enqueue(instance, device, [&](const CommandBufferHandle& commandBuffer) {
+            commandBuffer->transferBufferData(instance, srcBuffer, dstBuffer, copyRegion);
+            });
+    }
+
+    UploadQueue::Ticket UploadQueue::enqueueImageCopy(const Context& instance, const Device& device,
+        const Buffer& srcBuffer, Image& dstImage, size_t srcOffset /*= 0*/)
+    {
+        return enqueue(instance, device, [&](const CommandBufferHandle& commandBuffer) {
+            commandBuffer->setPipelineBarrier(instance,
+                vk::PipelineStageFlagBits::eTopOfPipe, vk::PipelineStageFlagBits::eTransfer,
+                dstImage, vk::ImageLayout::eTransferDstOptimal,
+                vk::AccessFlags(), vk::AccessFlagBits::eTransferWrite);
+
+            commandBuffer->transferImageData(instance, srcBuffer, dstImage, srcOffset);
+
+            commandBuffer->setPipelineBarrier(instance,
+                vk::PipelineStageFlagBits::eTransfer, vk::PipelineStageFlagBits::eFragmentShader,
+                dstImage, vk::ImageLayout::eShaderReadOnlyOptimal,
+                vk::AccessFlagBits::eTransferWrite, vk::AccessFlagBits::eShaderRead);
+            });
+    }
+
+    UploadQueue::Ticket UploadQueue::addCompletionCallback(std::function<void()>&& callback)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // nothing recorded, everything submitted so far has to finish first
+        if (!m_isRecording || m_recording.empty) {
+            if (m_inFlight.empty()) {
+                callback();
+                return m_completedTicket;
+            }
+            m_inFlight.back().callbacks.push_back(std::move(callback));
+            return m_inFlight.back().ticket;
+        }
+
+        m_recording.callbacks.push_back(std::move(callback));
+        return m_recording.ticket;
+    }
+
+    UploadQueue::Ticket UploadQueue::flush(const Context& instance, const Device& device)
+    {
+        assert(m_initialized && "UploadQueue::flush() - UploadQueue is not initialized");
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            // checked again after every wait, another thread may have flushed in the meantime
+            if (!m_isRecording || m_recording.empty)
+                return m_nextTicket - 1;
+
+            collectLocked(instance, device);
+            if (m_inFlight.size() < m_maxBatchesInFlight)
+                break;
+
+            // out of batches, the oldest one has to finish before we can submit another
+            waitUnlocked(lock, instance, device, m_inFlight.front());
+        }
+
+        m_recording.commandBuffer->stopRecord(instance);
+        m_recording.fence.reset(instance, device);
+
+        m_queue->submit(instance, {}, {}, { std::cref(m_recording.commandBuffer) }, {}, m_recording.fence);
+
+        Ticket ticket = m_recording.ticket;
+        m_inFlight.push_back(std::move(m_recording));
+        m_isRecording = false;
+        m_nextTicket++;
+
+        return ticket;
+    }
+
+    void UploadQueue::retire(Batch& batch)
+    {
+        for (auto& callback : batch.callbacks)
+            callback();
+        batch.callbacks.clear();
+        m_completedTicket = std::max(m_completedTicket, batch.ticket);
+    }
+
+    void UploadQueue::collectLocked(const Context& instance, const Device& device)
+    {
+        // batches are submitted to a single queue so they complete in order,
+        // one another thread is still waiting on stays until that thread has let go of it
+        while (!m_inFlight.empty() && m_inFlight.front().waiters == 0 && m_inFlight.front().fence.isSignaled(instance, device)) {
+            retire(m_inFlight.front());
+            m_freeBatches.push_back(std::move(m_inFlight.front()));
+            m_inFlight.pop_front();
+        }
+    }
+
+    void UploadQueue::collect(const Context& instance, const Device& device)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectLocked(instance, device);
+    }
+
+    bool UploadQueue::isComplete(const Context& instance, const Device& device, Ticket ticket)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectLocked(instance, device);
+        return ticket <= m_completedTicket;
+    }
+
+    void UploadQueue::waitUnlocked(std::unique_lock<std::mutex>& lock, const Context& instance, const Device& device, Batch& batch)
+    {
+        // deque elements stay where they are on push_back, and collectLocked never pops a batch with waiters
+        batch.waiters++;
+        lock.unlock();
+        batch.fence.wait(instance, device);
+        lock.lock();
+        batch.waiters--;
+    }
+
+    void UploadQueue::wait(const Context& instance, const Device& device, Ticket ticket)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        assert(ticket < m_nextTicket && "UploadQueue::wait() - Ticket was not flushed, waiting on it would never return");
+
+        while (true) {
+            collectLocked(instance, device);
+            if (ticket <= m_completedTicket || m_inFlight.empty())
+                return;
+
+            // the front is the oldest batch that isn't retired yet
+            waitUnlocked(lock, instance, device, m_inFlight.front());
+        }
+    }
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+#include "../Common.h"
+#include "Context.h"
+#include "Device.h"
+#include "Fence.h"
+#include "Queue.h"
+#include "CommandPool.h"
+#include "CommandBuffer.h"
+#include "../MemoryManagement/Buffer.h"
+#include "../MemoryManagement/Image.h"
+
+#include <deque>
+#include <mutex>
+
+namespace Graphics {
+
+    // records transfers into one command buffer per batch and submits them with a fence
+    // instead of a submit + waitIdle per copy, callers get a ticket they can poll or wait on
+    // meant to run on its own queue, recording is thread safe
+    // fence waits happen without the lock, so a thread waiting on a batch never blocks recording on the others
+    class UploadQueue
+    {
+    public:
+        using Ticket = uint64_t;
+        using RecordFunc = std::function<void(const CommandBufferHandle&)>;
+
+    private:
+        struct Batch
+        {
+            CommandBufferHandle commandBuffer;
+            Fence fence;
+            Ticket ticket = 0;
+            std::vector<std::function<void()>> callbacks;
+            bool empty = true;
+            // threads blocked on the fence without the lock, the batch isn't recycled until they are done
+            uint32_t waiters = 0;
+        };
+
+        const Queue* m_queue = nullptr;
+        CommandPool m_pool;
+
+        Batch m_recording;
+        bool m_isRecording = false;
+
+        std::deque<Batch> m_inFlight;
+        std::vector<Batch> m_freeBatches;
+        size_t m_maxBatchesInFlight = 0;
+
+        Ticket m_nextTicket = 1;
+        Ticket m_completedTicket = 0;
+
+        mutable std::mutex m_mutex;
+
+        bool m_initialized = false;
+    public:
+
+        UploadQueue() {};
+
+        UploadQueue(const Context& instance, const Device& device,
+            const Queue& queue, size_t maxBatchesInFlight = 4);
+
+        UploadQueue(UploadQueue&& other) noexcept {
+            m_queue = std::exchange(other.m_queue, nullptr);
+            m_pool = std::move(other.m_pool);
+            m_recording = std::exchange(other.m_recording, {});
+            m_isRecording = std::exchange(other.m_isRecording, false);
+            m_inFlight = std::exchange(other.m_inFlight, {});
+            m_freeBatches = std::exchange(other.m_freeBatches, {});
+            m_maxBatchesInFlight = std::exchange(other.m_maxBatchesInFlight, 0);
+            m_nextTicket = std::exchange(other.m_nextTicket, 1);
+            m_completedTicket = std::exchange(other.m_completedTicket, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+        };
+
+        //moving to an initialized upload queue is undefined behavior, destroy before moving
+        UploadQueue& operator=(UploadQueue&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            assert(!m_initialized && "UploadQueue::operator=() - UploadQueue already initialized");
+
+            m_queue = std::exchange(other.m_queue, nullptr);
+            m_pool = std::move(other.m_pool);
+            m_recording = std::exchange(other.m_recording, {});
+            m_isRecording = std::exchange(other.m_isRecording, false);
+            m_inFlight = std::exchange(other.m_inFlight, {});
+            m_freeBatches = std::exchange(other.m_freeBatches, {});
+            m_maxBatchesInFlight = std::exchange(other.m_maxBatchesInFlight, 0);
+            m_nextTicket = std::exchange(other.m_nextTicket, 1);
+            m_completedTicket = std::exchange(other.m_completedTicket, 0);
+            m_initialized = std::exchange(other.m_initialized, false);
+
+            return *this;
+        };
+
+        UploadQueue(const UploadQueue&) noexcept = delete;
+        UploadQueue& operator=(const UploadQueue&) noexcept = delete;
+
+        ~UploadQueue() { assert(!m_initialized && "UploadQueue was not destroyed!"); };
+
+        // waits for everything in flight, anything recorded but not flushed is dropped
+        void destroy(const Context& instance, const Device& device);
+
+        // records arbitrary transfer commands into the current batch, returns the batch ticket
+        Ticket enqueue(const Context& instance, const Device& device, RecordFunc&& func);
+
+        Ticket enqueueBufferCopy(const Context& instance, const Device& device,
+            const Buffer& srcBuffer, const Buffer& dstBuffer, const CopyRegion& copyRegion);
+
+        // transitions the image to transfer dst, copies and leaves it shader read only
+        Ticket enqueueImageCopy(const Context& instance, const Device& device,
+            const Buffer& srcBuffer, Image& dstImage, size_t srcOffset = 0);
+
+        // called from collect() once the current batch is complete on the gpu,
+        // callbacks run under the queue lock and must not call back into the queue
+        Ticket addCompletionCallback(std::function<void()>&& callback);
+
+        // submits the current batch, returns its ticket or the last submitted ticket if there was nothing to submit
+        Ticket flush(const Context& instance, const Device& device);
+
+        // retires finished batches and runs their callbacks, never blocks
+        void collect(const Context& instance, const Device& device);
+
+        bool isComplete(const Context& instance, const Device& device, Ticket ticket);
+        void wait(const Context& instance, const Device& device, Ticket ticket);
+
+        Ticket getCompletedTicket() const { std::lock_guard<std::mutex> lock(m_mutex); return m_completedTicket; };
+        Ticket getRecordingTicket() const { std::lock_guard<std::mutex> lock(m_mutex); return m_nextTicket; };
+        const Queue& getQueue() const { return *m_queue; };
+
+    private:
+        void beginBatch(const Context& instance, const Device& device);
+        void retire(Batch& batch);
+        void collectLocked(const Context& instance, const Device& device);
+        // waits on the batch's fence with the lock released, the lock is held again when it returns
+        void waitUnlocked(std::unique_lock<std::mutex>& lock, const Context& instance, const Device& device, Batch& batch);
+    };
+
+}
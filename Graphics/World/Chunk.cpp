@@ -0,0 +1,128 @@
+#include "Chunk.h"
+
+namespace Graphics {
+
+    static size_t getWordCount(uint32_t bits)
+    {
+        // plus the spare word readIndex() may touch
+        return (chunkVolume * bits + 63) / 64 + 1;
+    }
+
+    uint32_t Chunk::getBitsFor(size_t paletteSize)
+    {
+        uint32_t bits = 0;
+        while ((1ull << bits) < paletteSize)
+            bits++;
+        return bits;
+    }
+
+    void Chunk::repack(uint32_t bits)
+    {
+        Chunk packed;
+        packed.m_bits = bits;
+        packed.m_data.assign(getWordCount(bits), 0);
+
+        // a uniform chunk is all index 0, which the zeroed storage already is
+        if (m_bits != 0)
+            for (size_t i = 0; i < chunkVolume; i++)
+                packed.writeIndex(i, readIndex(i));
+
+        m_data = std::move(packed.m_data);
+        m_bits = bits;
+    }
+
+    Chunk Chunk::fromBlocks(std::span<const BlockId> blocks)
+    {
+        assert(blocks.size() == chunkVolume && "Chunk::fromBlocks() - blocks has to hold a whole chunk");
+
+        Chunk chunk(blocks[0]);
+
+        // terrain comes in long runs, only look the palette up when the block changes
+        BlockId last = blocks[0];
+        for (BlockId block : blocks) {
+            if (block == last)
+                continue;
+            last = block;
+            if (chunk.findPaletteIndex(block) == chunk.m_palette.size())
+                chunk.m_palette.push_back(block);
+        }
+
+        if (chunk.m_palette.size() == 1)
+            return chunk;
+
+        chunk.m_bits = getBitsFor(chunk.m_palette.size());
+        chunk.m_data.assign(getWordCount(chunk.m_bits), 0);
+
+        last = blocks[0];
+        uint32_t paletteIndex = 0;
+        for (size_t i = 0; i < chunkVolume; i++) {
+            if (blocks[i] != last) {
+                last = blocks[i];
+                paletteIndex = chunk.findPaletteIndex(last);
+            }
+            chunk.writeIndex(i, paletteIndex);
+        }
+
+        return chunk;
+    }
+
+    void Chunk::fill(BlockId block)
+    {
+        m_palette.assign(1, block);
+        m_data.clear();
+        m_data.shrink_to_fit();
+        m_bits = 0;
+    }
+
+    void Chunk::decode(std::span<BlockId> blocks) const
+    {
+        assert(blocks.size() == chunkVolume && "Chunk::decode() - blocks has to hold a whole chunk");
+
+        if (m_bits == 0) {
+            std::fill(blocks.begin(), blocks.end(), m_palette[0]);
+            return;
+        }
+
+        for (size_t i = 0; i < chunkVolume; i++)
+            blocks[i] = m_palette[readIndex(i)];
+    }
+
+    void Chunk::compact()
+    {
+        if (m_bits == 0)
+            return;
+
+        std::vector<uint32_t> counts(m_palette.size(), 0);
+        for (size_t i = 0; i < chunkVolume; i++)
+            counts[readIndex(i)]++;
+
+        std::vector<BlockId> palette;
+        std::vector<uint32_t> remap(m_palette.size(), 0);
+        for (size_t i = 0; i < m_palette.size(); i++) {
+            if (counts[i] == 0)
+                continue;
+            remap[i] = static_cast<uint32_t>(palette.size());
+            palette.push_back(m_palette[i]);
+        }
+
+        if (palette.size() == 1) {
+            fill(palette[0]);
+            return;
+        }
+
+        uint32_t bits = getBitsFor(palette.size());
+        if (palette.size() == m_palette.size() && bits == m_bits)
+            return;
+
+        Chunk packed;
+        packed.m_bits = bits;
+        packed.m_data.assign(getWordCount(bits), 0);
+        for (size_t i = 0; i < chunkVolume; i++)
+            packed.writeIndex(i, remap[readIndex(i)]);
+
+        m_palette = std::move(palette);
+        m_data = std::move(packed.m_data);
+        m_bits = bits;
+    }
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "../Common.h"
+#include "Voxel.h"
+
+#include <span>
+
+namespace Graphics {
+
+    // block storage for one chunk, blocks are stored as indices into a per chunk palette of block ids
+    // packed at the fewest bits the palette needs, a chunk of a single block has no storage at all
+    // indices are packed back to back and may straddle two words, the storage keeps one spare word
+    // at the end so reads never have to check for it
+    // set() only grows the palette, compact() drops entries that are no longer used
+    class Chunk
+    {
+    private:
+        std::vector<BlockId> m_palette;
+        std::vector<uint64_t> m_data;
+        uint32_t m_bits = 0; // 0 while the chunk is uniform
+
+        uint32_t findPaletteIndex(BlockId block) const
+        {
+            for (uint32_t i = 0; i < m_palette.size(); i++)
+                if (m_palette[i] == block)
+                    return i;
+            return static_cast<uint32_t>(m_palette.size());
+        }
+
+        uint32_t readIndex(size_t index) const
+        {
+            size_t bit = index * m_bits;
+            size_t word = bit >> 6;
+            uint32_t shift = bit & 63;
+            // the second word is shifted in two steps so a shift of 0 doesn't shift by 64
+            uint64_t value = (m_data[word] >> shift) | ((m_data[word + 1] << 1) << (63 - shift));
+            return static_cast<uint32_t>(value & ((1ull << m_bits) - 1));
+        }
+
+        void writeIndex(size_t index, uint32_t paletteIndex)
+        {
+            size_t bit = index * m_bits;
+            size_t word = bit >> 6;
+            uint32_t shift = bit & 63;
+            uint64_t mask = (1ull << m_bits) - 1;
+            m_data[word] = (m_data[word] & ~(mask << shift)) | (static_cast<uint64_t>(paletteIndex) << shift);
+            if (shift + m_bits > 64) {
+                uint32_t written = 64 - shift;
+                m_data[word + 1] = (m_data[word + 1] & ~(mask >> written)) | (static_cast<uint64_t>(paletteIndex) >> written);
+            }
+        }
+
+        // rebuilds the storage at the given width, indices stay the same
+        void repack(uint32_t bits);
+
+    public:
+
+        Chunk(BlockId fill = Block::Air) : m_palette{ fill } {};
+
+        // blocks has to hold chunkVolume blocks indexed with chunkIndex
+        static Chunk fromBlocks(std::span<const BlockId> blocks);
+
+        BlockId get(size_t index) const
+        {
+            return m_bits == 0 ? m_palette[0] : m_palette[readIndex(index)];
+        }
+
+        BlockId get(int32_t x, int32_t y, int32_t z) const { return get(chunkIndex(x, y, z)); };
+
+        void set(size_t index, BlockId block)
+        {
+            uint32_t paletteIndex = findPaletteIndex(block);
+            if (paletteIndex == m_palette.size()) {
+                m_palette.push_back(block);
+                if (m_palette.size() > (1ull << m_bits))
+                    repack(m_bits + 1);
+            }
+            else if (m_bits == 0)
+                return;
+
+            writeIndex(index, paletteIndex);
+        }
+
+        void set(int32_t x, int32_t y, int32_t z, BlockId block) { set(chunkIndex(x, y, z), block); };
+
+        // turns the chunk uniform and releases the storage
+        void fill(BlockId block);
+
+        // unpacks every block into blocks, which has to hold chunkVolume blocks
+        void decode(std::span<BlockId> blocks) const;
+
+        // drops unused palette entries and repacks at the smallest width, a chunk left with one block turns uniform
+        void compact();
+
+        bool isUniform() const { return m_bits == 0; };
+        bool isEmpty() const { return m_bits == 0 && m_palette[0] == Block::Air; };
+        uint32_t getBitsPerBlock() const { return m_bits; };
+        const std::vector<BlockId>& getPalette() const { return m_palette; };
+        size_t getMemoryUsage() const { return sizeof(Chunk) + m_palette.capacity() * sizeof(BlockId) + m_data.capacity() * sizeof(uint64_t); };
+
+        // bits needed to index a palette of the given size
+        static uint32_t getBitsFor(size_t paletteSize);
+    };
+
+}
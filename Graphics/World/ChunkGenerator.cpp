@@ -0,0 +1,184 @@
+#include "ChunkGenerator.h"
+
+#include <thread>
+
+namespace Graphics {
+
+    ChunkGenerator::ChunkGenerator(MT::ThreadPool& threadPool, const Settings& settings, uint32_t maxInFlight /*= 0*/) :
+        m_threadPool(&threadPool), m_settings(settings)
+    {
+        if (maxInFlight == 0)
+            maxInFlight = std::max(1u, static_cast<uint32_t>(m_threadPool->getWorkerAmount()) * 2);
+
+        m_heightNoise.setSeed(m_settings.seed);
+        m_caveNoise.setSeed(m_settings.seed + 1);
+
+        m_coordinator = std::make_unique<MT::UniqueTaskCoordinator<ChunkCoord>>(threadPool, maxInFlight);
+        // twice the in flight count, finished chunks can wait a frame while the next ones are generated
+        m_completed = std::make_unique<MT::LockFreeQueue<Result>>(static_cast<size_t>(maxInFlight) * 2);
+
+        m_initialized = true;
+    }
+
+    void ChunkGenerator::destroy()
+    {
+        if (!m_initialized)
+            return;
+
+        // only a few chunks are ever in flight, no need for anything smarter than the pool does in waitForAllAndPause
+        while (m_coordinator->getPendingCount() != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        Result result;
+        while (m_completed->tryPop(result));
+
+        m_coordinator.reset();
+        m_completed.reset();
+        m_requested.clear();
+        m_pending.clear();
+        m_outstanding = 0;
+
+#ifdef _DEBUG
+        std::cout << "Destroyed ChunkGenerator" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    bool ChunkGenerator::request(ChunkCoord coord)
+    {
+        assert(m_initialized && "ChunkGenerator::request() - ChunkGenerator is not initialized");
+
+        if (!m_requested.insert(coord).second)
+            return false;
+
+        m_pending.push_back(coord);
+        return true;
+    }
+
+    bool ChunkGenerator::cancel(ChunkCoord coord)
+    {
+        auto it = std::find(m_pending.begin(), m_pending.end(), coord);
+        if (it == m_pending.end())
+            return false;
+
+        m_pending.erase(it);
+        m_requested.erase(coord);
+        return true;
+    }
+
+    void ChunkGenerator::update(const glm::vec3& cameraPosition)
+    {
+        assert(m_initialized && "ChunkGenerator::update() - ChunkGenerator is not initialized");
+
+        size_t capacity = m_completed->capacity();
+        if (m_pending.empty() || m_outstanding >= capacity)
+            return;
+
+        // distances change with the camera, so the order is only settled for what goes out now
+        size_t slots = std::min(capacity - m_outstanding, m_pending.size());
+        auto distance = [&](const ChunkCoord& coord) {
+            glm::vec3 offset = coord.getCenter() - cameraPosition;
+            return glm::dot(offset, offset);
+            };
+        std::partial_sort(m_pending.begin(), m_pending.begin() + slots, m_pending.end(),
+            [&](const ChunkCoord& a, const ChunkCoord& b) { return distance(a) < distance(b); });
+
+        size_t dispatched = 0;
+        for (; dispatched < slots; dispatched++) {
+            ChunkCoord coord = m_pending[dispatched];
+            auto task = [this, coord]() {
+                // the dense scratch is reused by every chunk a worker generates
+                static thread_local std::vector<BlockId> blocks;
+
+                Result result;
+                result.coord = coord;
+                try {
+                    generate(coord, blocks);
+                    result.chunk = Chunk::fromBlocks(blocks);
+                    result.succeeded = true;
+                }
+                catch (const std::exception& e) {
+#ifdef _DEBUG
+                    std::cout << "ChunkGenerator failed to generate chunk " << coord.x << ", " << coord.y << ", " << coord.z
+                        << ": " << e.what() << std::endl;
+#endif
+                }
+
+                // update() never dispatches more than the queue can hold
+                [[maybe_unused]] bool pushed = m_completed->tryPush(std::move(result));
+                assert(pushed && "ChunkGenerator - completion queue overflow");
+                };
+
+            // coordinator is full, or the pool is shutting down
+            if (!m_coordinator->tryAddTask(task, coord))
+                break;
+            m_outstanding++;
+        }
+
+        m_pending.erase(m_pending.begin(), m_pending.begin() + dispatched);
+    }
+
+    bool ChunkGenerator::poll(Result& result)
+    {
+        if (!m_completed->tryPop(result))
+            return false;
+
+        m_outstanding--;
+        m_requested.erase(result.coord);
+        return true;
+    }
+
+    void ChunkGenerator::generate(ChunkCoord coord, std::vector<BlockId>& blocks) const
+    {
+        blocks.assign(chunkVolume, Block::Air);
+        glm::ivec3 origin = coord.getOrigin();
+
+        // one height per column, the noise y runs along world z
+        std::array<int32_t, chunkSize * chunkSize> surface;
+        {
+            std::array<float, chunkSize * chunkSize> heights;
+            m_heightNoise.fillFbmGrid(heights.data(), glm::vec2(origin.x, origin.z), glm::ivec2(chunkSize), glm::vec2(1.0f),
+                m_settings.heightOctaves, m_settings.heightFrequency);
+            for (size_t i = 0; i < heights.size(); i++)
+                surface[i] = static_cast<int32_t>(std::floor(m_settings.baseHeight + m_settings.heightScale * heights[i]));
+        }
+
+        int32_t highest = *std::max_element(surface.begin(), surface.end());
+        if (origin.y > std::max(highest, m_settings.seaLevel))
+            return;
+
+        std::vector<float> caves;
+        if (origin.y <= highest) {
+            caves.resize(chunkVolume);
+            m_caveNoise.fillFbmGrid(caves.data(), glm::vec3(origin), glm::ivec3(chunkSize), glm::vec3(1.0f),
+                m_settings.caveOctaves, m_settings.caveFrequency);
+        }
+
+        size_t index = 0;
+        for (int32_t z = 0; z < chunkSize; z++) {
+            for (int32_t y = 0; y < chunkSize; y++) {
+                int32_t worldY = origin.y + y;
+                for (int32_t x = 0; x < chunkSize; x++, index++) {
+                    int32_t height = surface[z * chunkSize + x];
+                    if (worldY > height) {
+                        if (worldY <= m_settings.seaLevel)
+                            blocks[index] = Block::Water;
+                        continue;
+                    }
+
+                    if (caves[index] > m_settings.caveThreshold)
+                        continue;
+
+                    int32_t depth = height - worldY;
+                    if (depth == 0)
+                        blocks[index] = worldY >= m_settings.seaLevel ? Block::Grass : Block::Dirt;
+                    else if (depth <= m_settings.dirtDepth)
+                        blocks[index] = Block::Dirt;
+                    else
+                        blocks[index] = Block::Stone;
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include "../Common.h"
+#include "Voxel.h"
+#include "Chunk.h"
+
+#include "Mathematics/PerlinNoise2d.h"
+#include "Mathematics/PerlinNoise3d.h"
+#include "MultiThreading/ThreadPool.h"
+#include "MultiThreading/UniqueTaskCoordinator.h"
+#include "MultiThreading/LockFreeQueue.h"
+
+#include <memory>
+
+namespace Graphics {
+
+    // generates terrain chunks on the thread pool
+    // requests wait in a pending list until update() hands the ones closest to the camera to the pool,
+    // only maxInFlight at a time so a moving camera keeps reprioritizing whatever is still pending,
+    // finished chunks come back through a lock free queue that poll() drains without ever blocking
+    // request(), cancel(), update() and poll() belong to one thread, usually the main loop
+    class ChunkGenerator
+    {
+    public:
+        struct Settings
+        {
+            uint32_t seed = 0;
+
+            // surface height is baseHeight + heightScale * fbm of the world xz
+            float baseHeight = 0.0f;
+            float heightScale = 48.0f;
+            float heightFrequency = 1.0f / 128.0f;
+            int heightOctaves = 5;
+
+            // air at or below sea level turns into water
+            int32_t seaLevel = 0;
+            int32_t dirtDepth = 3;
+
+            // ground where the 3d fbm is above caveThreshold gets carved out
+            float caveFrequency = 1.0f / 32.0f;
+            int caveOctaves = 3;
+            float caveThreshold = 0.35f;
+        };
+
+        struct Result
+        {
+            ChunkCoord coord;
+            Chunk chunk;
+            bool succeeded = false;
+        };
+
+    private:
+        MT::ThreadPool* m_threadPool = nullptr;
+        Settings m_settings;
+        Math::PerlinNoise2d m_heightNoise;
+        Math::PerlinNoise3d m_caveNoise;
+
+        std::unique_ptr<MT::UniqueTaskCoordinator<ChunkCoord>> m_coordinator;
+        std::unique_ptr<MT::LockFreeQueue<Result>> m_completed;
+
+        // everything requested and not polled yet, m_pending is the part that wasn't dispatched
+        std::set<ChunkCoord> m_requested;
+        std::vector<ChunkCoord> m_pending;
+
+        // dispatched and not polled yet, kept within the queue capacity so a worker never finds it full
+        size_t m_outstanding = 0;
+
+        bool m_initialized = false;
+    public:
+
+        ChunkGenerator() {};
+
+        // maxInFlight of 0 uses twice the worker count
+        ChunkGenerator(MT::ThreadPool& threadPool, const Settings& settings, uint32_t maxInFlight = 0);
+
+        // generation tasks hold a pointer to the generator, so it stays where it was created
+        ChunkGenerator(ChunkGenerator&&) noexcept = delete;
+        ChunkGenerator& operator=(ChunkGenerator&&) noexcept = delete;
+
+        ChunkGenerator(const ChunkGenerator&) noexcept = delete;
+        ChunkGenerator& operator=(const ChunkGenerator&) noexcept = delete;
+
+        ~ChunkGenerator() { assert(!m_initialized && "ChunkGenerator was not destroyed!"); };
+
+        // waits for the chunks in flight, undelivered results are dropped
+        void destroy();
+
+        // false if the chunk is already pending, in flight or waiting to be polled
+        bool request(ChunkCoord coord);
+
+        // drops a chunk that wasn't dispatched yet, chunks in flight are still delivered
+        bool cancel(ChunkCoord coord);
+
+        // dispatches the pending chunks closest to the camera into the free slots
+        void update(const glm::vec3& cameraPosition);
+
+        // takes one finished chunk, never blocks
+        bool poll(Result& result);
+
+        // fills blocks with the chunk at coord, deterministic for a seed and safe to call from any thread
+        // the dense layout is what the noise fills write, workers pack it into a Chunk afterwards
+        void generate(ChunkCoord coord, std::vector<BlockId>& blocks) const;
+
+        bool isRequested(ChunkCoord coord) const { return m_requested.contains(coord); };
+        size_t getPendingCount() const { return m_pending.size(); };
+        size_t getOutstandingCount() const { return m_outstanding; };
+        const Settings& getSettings() const { return m_settings; };
+    };
+
+}
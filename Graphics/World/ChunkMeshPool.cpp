@@ -0,0 +1,289 @@
+#include "ChunkMeshPool.h"
+
+namespace Graphics {
+
+    static constexpr size_t quadBytes = sizeof(VertexVoxel) * 4;
+
+    template <typename T>
+    static std::span<const uint8_t> asBytes(std::span<const T> data)
+    {
+        return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size_bytes());
+    }
+
+    ChunkMeshPool::ChunkMeshPool(const Context& instance, const Device& device, MemoryAllocator& allocator,
+        UploadQueue& uploadQueue, StagingRing& stagingRing, uint32_t quadCapacity, uint32_t maxChunks) :
+        m_allocator(&allocator), m_uploadQueue(&uploadQueue), m_stagingRing(&stagingRing),
+        m_quadCapacity(quadCapacity), m_maxChunks(maxChunks)
+    {
+        m_vertexBuffer = Buffer(instance, device, static_cast<size_t>(m_quadCapacity) * quadBytes,
+            BufferUsage::Bits::Vertex | BufferUsage::Bits::TransferDst);
+        m_vertexAllocation = m_allocator->allocate(instance, device, m_vertexBuffer, MemoryProperty::Bits::DeviceLocal);
+
+        m_transformBuffer = Buffer(instance, device, static_cast<size_t>(m_maxChunks) * sizeof(AffineTransform),
+            BufferUsage::Bits::Vertex | BufferUsage::Bits::TransferDst);
+        m_transformAllocation = m_allocator->allocate(instance, device, m_transformBuffer, MemoryProperty::Bits::DeviceLocal);
+
+        std::vector<uint16_t> indices = ChunkMesher::makeQuadIndices();
+        m_indexBuffer = Buffer(instance, device, indices.size() * sizeof(uint16_t),
+            BufferUsage::Bits::Index | BufferUsage::Bits::TransferDst);
+        m_indexAllocation = m_allocator->allocate(instance, device, m_indexBuffer, MemoryProperty::Bits::DeviceLocal);
+
+        // every section upload is recorded after this one, so a section that draws always has its indices
+        m_lastTicket = m_stagingRing->uploadBuffer(instance, device, *m_uploadQueue, m_indexBuffer,
+            asBytes(std::span<const uint16_t>(indices)));
+        m_uploadQueue->flush(instance, device);
+
+        m_initialized = true;
+    }
+
+    void ChunkMeshPool::destroy(const Context& instance, const Device& device)
+    {
+        if (!m_initialized)
+            return;
+
+        m_uploadQueue->flush(instance, device);
+        m_uploadQueue->wait(instance, device, m_lastTicket);
+
+        m_vertexBuffer.destroy(instance, device);
+        m_allocator->free(instance, device, m_vertexAllocation);
+        m_indexBuffer.destroy(instance, device);
+        m_allocator->free(instance, device, m_indexAllocation);
+        m_transformBuffer.destroy(instance, device);
+        m_allocator->free(instance, device, m_transformAllocation);
+
+        m_entries.clear();
+        m_uploading.clear();
+        m_retiredSlots.clear();
+        m_retiredTransforms.clear();
+        for (auto& freeSlots : m_freeSlots)
+            freeSlots.clear();
+        m_freeTransforms.clear();
+        m_slotTop = 0;
+        m_transformTop = 0;
+
+#ifdef _DEBUG
+        std::cout << "Destroyed ChunkMeshPool" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    ChunkMeshPool::Slot ChunkMeshPool::allocateSlot(uint32_t quadCount)
+    {
+        assert(quadCount <= ChunkMesher::maxSectionQuads && "ChunkMeshPool::allocateSlot() - Section has more quads than a section can have");
+
+        Slot slot;
+        slot.sizeClass = static_cast<uint32_t>(std::bit_width(std::bit_ceil(std::max(quadCount, minSlotQuads)) / minSlotQuads)) - 1;
+
+        auto& freeSlots = m_freeSlots[slot.sizeClass];
+        if (!freeSlots.empty()) {
+            slot.firstQuad = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+
+        if (m_quadCapacity - m_slotTop < slot.getCapacity())
+            throw std::runtime_error("ChunkMeshPool::allocateSlot() - Out of vertex memory");
+
+        slot.firstQuad = m_slotTop;
+        m_slotTop += slot.getCapacity();
+        return slot;
+    }
+
+    void ChunkMeshPool::retireSlot(const Slot& slot, uint64_t frameNumber)
+    {
+        // anything recorded so far may still be copying into the slot, so the batch being recorded has to finish too
+        m_retiredSlots.push_back({ slot, frameNumber, m_uploadQueue->getRecordingTicket() });
+    }
+
+    UploadQueue::Ticket ChunkMeshPool::writeSection(const Context& instance, const Device& device, Section& section,
+        const ChunkMesher::Section& mesh, uint64_t frameNumber)
+    {
+        uint32_t quadCount = mesh.getQuadCount();
+        if (quadCount > ChunkMesher::maxSectionQuads) {
+#ifdef _DEBUG
+            std::cout << "ChunkMeshPool::writeSection() - Section has " << quadCount << " quads, drawing the first "
+                << ChunkMesher::maxSectionQuads << std::endl;
+#endif
+            quadCount = ChunkMesher::maxSectionQuads;
+        }
+
+        // only a pending slot is patched, the drawn one stays untouched until the new one takes over
+        // and a pending one is only patched once its copy completed, the upload queue records no barrier
+        // between two copies to the same range so the older vertices could land last
+        Slot target = section.pending ? section.pendingSlot : Slot();
+        if (target.isValid() && (quadCount == 0 || quadCount > target.getCapacity() ||
+            section.pendingTicket > m_uploadQueue->getCompletedTicket())) {
+            retireSlot(target, frameNumber);
+            target = Slot();
+        }
+        if (quadCount != 0 && !target.isValid())
+            target = allocateSlot(quadCount);
+
+        UploadQueue::Ticket ticket = 0;
+        if (quadCount != 0) {
+            auto bytes = asBytes(std::span<const VertexVoxel>(mesh.vertices.data(), static_cast<size_t>(quadCount) * 4));
+            ticket = m_stagingRing->uploadBuffer(instance, device, *m_uploadQueue, m_vertexBuffer, bytes,
+                static_cast<size_t>(target.firstQuad) * quadBytes);
+            m_lastTicket = std::max(m_lastTicket, ticket);
+            m_uploadedBytes += bytes.size();
+        }
+
+        section.pendingSlot = target;
+        section.pendingQuadCount = quadCount;
+        section.pendingOpaqueQuadCount = std::min(mesh.opaqueQuadCount, quadCount);
+        section.pendingTicket = ticket;
+        section.pending = true;
+        return ticket;
+    }
+
+    void ChunkMeshPool::write(const Context& instance, const Device& device, const ChunkMesher::Mesh& mesh, uint64_t frameNumber)
+    {
+        assert(m_initialized && "ChunkMeshPool::write() - ChunkMeshPool is not initialized");
+
+        UploadQueue::Ticket ticket = 0;
+        auto it = m_entries.find(mesh.coord);
+        if (it == m_entries.end()) {
+            Entry entry;
+            if (!m_freeTransforms.empty()) {
+                entry.transformIndex = m_freeTransforms.back();
+                m_freeTransforms.pop_back();
+            }
+            else if (m_transformTop < m_maxChunks)
+                entry.transformIndex = m_transformTop++;
+            else
+                throw std::runtime_error("ChunkMeshPool::write() - Out of chunk transforms");
+
+            // recorded before the sections, so the transform is there by the time any of them draws
+            ticket = m_stagingRing->uploadBuffer(instance, device, *m_uploadQueue, m_transformBuffer,
+                asBytes(std::span<const AffineTransform>(&mesh.transform, 1)), entry.transformIndex * sizeof(AffineTransform));
+            m_lastTicket = std::max(m_lastTicket, ticket);
+
+            it = m_entries.emplace(mesh.coord, entry).first;
+        }
+
+        for (uint32_t i = 0; i < sectionCount; i++) {
+            if (!(mesh.sectionMask & (1u << i)))
+                continue;
+
+            Section& section = it->second.sections[i];
+            bool wasPending = section.pending;
+            ticket = std::max(ticket, writeSection(instance, device, section, mesh.sections[i], frameNumber));
+            if (!wasPending)
+                m_uploading.push_back({ mesh.coord, i });
+        }
+
+        if (mesh.priority)
+            m_priorityTicket = std::max(m_priorityTicket, ticket);
+    }
+
+    void ChunkMeshPool::remove(ChunkCoord coord, uint64_t frameNumber)
+    {
+        auto it = m_entries.find(coord);
+        if (it == m_entries.end())
+            return;
+
+        for (auto& section : it->second.sections) {
+            if (section.slot.isValid())
+                retireSlot(section.slot, frameNumber);
+            if (section.pending && section.pendingSlot.isValid() && !(section.pendingSlot == section.slot))
+                retireSlot(section.pendingSlot, frameNumber);
+        }
+
+        m_retiredTransforms.push_back({ frameNumber, it->second.transformIndex });
+        m_entries.erase(it);
+        // its entries in m_uploading are dropped by the next update()
+    }
+
+    void ChunkMeshPool::update(const Context& instance, const Device& device, uint64_t frameNumber, uint64_t completedFrameNumber,
+        bool waitForUploads /*= false*/)
+    {
+        assert(m_initialized && "ChunkMeshPool::update() - ChunkMeshPool is not initialized");
+
+        m_uploadQueue->flush(instance, device);
+        // background meshes in the same batches are waited for too, but never a batch with only background meshes
+        if (waitForUploads && m_priorityTicket > m_uploadQueue->getCompletedTicket())
+            m_uploadQueue->wait(instance, device, m_priorityTicket);
+        m_uploadQueue->collect(instance, device);
+        UploadQueue::Ticket completedTicket = m_uploadQueue->getCompletedTicket();
+
+        std::erase_if(m_uploading, [&](const std::pair<ChunkCoord, uint32_t>& uploading) {
+            auto it = m_entries.find(uploading.first);
+            if (it == m_entries.end())
+                return true;
+
+            // a chunk removed and added again can leave a second entry for a section that was already applied
+            Section& section = it->second.sections[uploading.second];
+            if (!section.pending)
+                return true;
+            if (section.pendingTicket > completedTicket)
+                return false;
+
+            if (section.slot.isValid() && !(section.slot == section.pendingSlot))
+                retireSlot(section.slot, frameNumber);
+
+            section.slot = section.pendingSlot;
+            section.quadCount = section.pendingQuadCount;
+            section.opaqueQuadCount = section.pendingOpaqueQuadCount;
+            section.pending = false;
+            return true;
+            });
+
+        std::erase_if(m_retiredSlots, [&](const RetiredSlot& retired) {
+            if (retired.frameNumber > completedFrameNumber || retired.ticket > completedTicket)
+                return false;
+            m_freeSlots[retired.slot.sizeClass].push_back(retired.slot.firstQuad);
+            return true;
+            });
+
+        std::erase_if(m_retiredTransforms, [&](const std::pair<uint64_t, uint32_t>& retired) {
+            if (retired.first > completedFrameNumber)
+                return false;
+            m_freeTransforms.push_back(retired.second);
+            return true;
+            });
+    }
+
+    void ChunkMeshPool::addDraws(IndirectDrawBuilder& builder, bool transparent) const
+    {
+        for (const auto& [coord, entry] : m_entries) {
+            for (const auto& section : entry.sections) {
+                uint32_t firstQuad = transparent ? section.opaqueQuadCount : 0;
+                uint32_t quadCount = transparent ? section.quadCount - section.opaqueQuadCount : section.opaqueQuadCount;
+                if (quadCount == 0)
+                    continue;
+
+                builder.add(quadCount * 6, 1, 0,
+                    static_cast<int32_t>((section.slot.firstQuad + firstQuad) * 4), entry.transformIndex);
+            }
+        }
+    }
+
+    void ChunkMeshPool::bind(const Context& instance, CommandBuffer& commandBuffer) const
+    {
+        commandBuffer.bindVertexBuffers(instance, std::array{ std::cref(m_vertexBuffer) }, std::array{ vk::DeviceSize(0) },
+            VertexDefinition::bindings[0].binding);
+        commandBuffer.bindVertexBuffers(instance, std::array{ std::cref(m_transformBuffer) }, std::array{ vk::DeviceSize(0) },
+            InstanceDefinition::bindings[0].binding);
+        commandBuffer.bindIndexBuffer(instance, m_indexBuffer, 0, IndexType::Uint16);
+    }
+
+    ChunkMeshPool::Statistics ChunkMeshPool::getStatistics() const
+    {
+        Statistics statistics;
+        statistics.chunkCount = m_entries.size();
+        statistics.uploadedBytes = m_uploadedBytes;
+        statistics.slotQuads = m_slotTop;
+
+        for (const auto& [coord, entry] : m_entries)
+            for (const auto& section : entry.sections)
+                statistics.drawnQuads += section.quadCount;
+
+        for (uint32_t sizeClass = 0; sizeClass < slotClassCount; sizeClass++)
+            statistics.freeSlotQuads += m_freeSlots[sizeClass].size() * (static_cast<size_t>(minSlotQuads) << sizeClass);
+        for (const auto& retired : m_retiredSlots)
+            statistics.freeSlotQuads += retired.slot.getCapacity();
+
+        return statistics;
+    }
+
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include "../Common.h"
+#include "../BufferDataLayouts.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "../Rendering/UploadQueue.h"
+#include "../Rendering/CommandBuffer.h"
+#include "../Rendering/IndirectDrawBuilder.h"
+#include "../MemoryManagement/Buffer.h"
+#include "../MemoryManagement/MemoryAllocator.h"
+#include "../MemoryManagement/StagingRing.h"
+#include "ChunkMesher.h"
+
+#include <unordered_map>
+#include <bit>
+
+namespace Graphics {
+
+    // device side storage for chunk meshes, every section of every chunk lives in one shared vertex buffer
+    // sections get a slot of a power of two quads, only their vertices go through the staging ring
+    // the slot a section draws from is never written again since frames in flight may still read it, a remesh goes
+    // to a fresh slot and the section switches over once the upload completes, the old slot is retired then
+    // a slot written by a remesh that hasn't taken over yet is patched in place once its copy completed, nothing draws from it
+    // slots and transforms that were given up wait until the frames that could still read them are done
+    // sections draw with the shared 16 bit quad indices, the chunk transform is the instance at firstInstance
+    // everything here belongs to the render thread
+    class ChunkMeshPool
+    {
+    public:
+        using Vertex = VertexVoxel;
+        using VertexDefinition = VertexDefinitionVoxel;
+        using InstanceDefinition = VertexDefinitionAffineTransform;
+
+        static constexpr uint32_t minSlotQuads = 16;
+        static constexpr uint32_t slotClassCount = std::bit_width(std::bit_ceil(ChunkMesher::maxSectionQuads) / minSlotQuads);
+
+        struct Statistics
+        {
+            size_t chunkCount = 0;
+            size_t drawnQuads = 0;
+            size_t slotQuads = 0;
+            size_t freeSlotQuads = 0;
+            size_t uploadedBytes = 0;
+        };
+
+    private:
+        static constexpr uint32_t invalidSlotClass = std::numeric_limits<uint32_t>::max();
+
+        struct Slot
+        {
+            uint32_t firstQuad = 0;
+            uint32_t sizeClass = invalidSlotClass;
+
+            bool isValid() const { return sizeClass != invalidSlotClass; };
+            uint32_t getCapacity() const { return minSlotQuads << sizeClass; };
+            bool operator==(const Slot& other) const { return firstQuad == other.firstQuad && sizeClass == other.sizeClass; };
+        };
+
+        struct Section
+        {
+            // what draws right now
+            Slot slot;
+            uint32_t quadCount = 0;
+            uint32_t opaqueQuadCount = 0;
+
+            // the latest write, takes over once its ticket completes
+            Slot pendingSlot;
+            uint32_t pendingQuadCount = 0;
+            uint32_t pendingOpaqueQuadCount = 0;
+            UploadQueue::Ticket pendingTicket = 0;
+            bool pending = false;
+        };
+
+        struct Entry
+        {
+            uint32_t transformIndex = 0;
+            std::array<Section, sectionCount> sections;
+        };
+
+        struct RetiredSlot
+        {
+            Slot slot;
+            uint64_t frameNumber = 0;
+            UploadQueue::Ticket ticket = 0;
+        };
+
+        MemoryAllocator* m_allocator = nullptr;
+        UploadQueue* m_uploadQueue = nullptr;
+        StagingRing* m_stagingRing = nullptr;
+
+        Buffer m_vertexBuffer;
+        Allocation m_vertexAllocation;
+        Buffer m_indexBuffer;
+        Allocation m_indexAllocation;
+        Buffer m_transformBuffer;
+        Allocation m_transformAllocation;
+
+        uint32_t m_quadCapacity = 0;
+        uint32_t m_maxChunks = 0;
+
+        // slots are bump allocated and recycled per size class, sections rarely change class once meshed
+        uint32_t m_slotTop = 0;
+        std::array<std::vector<uint32_t>, slotClassCount> m_freeSlots;
+        std::vector<RetiredSlot> m_retiredSlots;
+
+        uint32_t m_transformTop = 0;
+        std::vector<uint32_t> m_freeTransforms;
+        std::vector<std::pair<uint64_t, uint32_t>> m_retiredTransforms;
+
+        std::unordered_map<ChunkCoord, Entry, ChunkCoordHash> m_entries;
+        // sections with a write that hasn't been applied yet
+        std::vector<std::pair<ChunkCoord, uint32_t>> m_uploading;
+        UploadQueue::Ticket m_lastTicket = 0;
+        // the last upload of a priority mesh, what update() waits for
+        UploadQueue::Ticket m_priorityTicket = 0;
+
+        size_t m_uploadedBytes = 0;
+
+        bool m_initialized = false;
+    public:
+
+        ChunkMeshPool() {};
+
+        // quadCapacity sizes the shared vertex buffer, maxChunks the transform buffer,
+        // the shared quad indices are uploaded right away
+        ChunkMeshPool(const Context& instance, const Device& device, MemoryAllocator& allocator,
+            UploadQueue& uploadQueue, StagingRing& stagingRing, uint32_t quadCapacity, uint32_t maxChunks);
+
+        ChunkMeshPool(ChunkMeshPool&&) noexcept = delete;
+        ChunkMeshPool& operator=(ChunkMeshPool&&) noexcept = delete;
+
+        ChunkMeshPool(const ChunkMeshPool&) noexcept = delete;
+        ChunkMeshPool& operator=(const ChunkMeshPool&) noexcept = delete;
+
+        ~ChunkMeshPool() { assert(!m_initialized && "ChunkMeshPool was not destroyed!"); };
+
+        // waits for the uploads in flight, the gpu must be done drawing from the pool
+        void destroy(const Context& instance, const Device& device);
+
+        // records the sections in the mesh's mask into the upload queue, the chunk is added on its first mesh
+        // a section with more than maxSectionQuads quads loses the quads past it
+        void write(const Context& instance, const Device& device, const ChunkMesher::Mesh& mesh, uint64_t frameNumber);
+
+        // stops drawing the chunk, its slots are recycled once completedFrameNumber passes frameNumber
+        void remove(ChunkCoord coord, uint64_t frameNumber);
+
+        // submits what write() recorded, switches the sections whose uploads completed and recycles retired slots,
+        // waitForUploads blocks until the priority meshes written so far are on the gpu so they draw this frame
+        void update(const Context& instance, const Device& device, uint64_t frameNumber, uint64_t completedFrameNumber,
+            bool waitForUploads = false);
+
+        // adds one record per non empty section, the transparent pass draws the quads after opaqueQuadCount
+        void addDraws(IndirectDrawBuilder& builder, bool transparent) const;
+
+        // binds the vertex buffer to binding 0, the transforms to the instance binding and the quad indices
+        void bind(const Context& instance, CommandBuffer& commandBuffer) const;
+
+        bool contains(ChunkCoord coord) const { return m_entries.contains(coord); };
+        bool isUploading() const { return !m_uploading.empty(); };
+        Statistics getStatistics() const;
+
+        const Buffer& getVertexBuffer() const { return m_vertexBuffer; };
+        const Buffer& getIndexBuffer() const { return m_indexBuffer; };
+        const Buffer& getTransformBuffer() const { return m_transformBuffer; };
+        uint32_t getQuadCapacity() const { return m_quadCapacity; };
+        uint32_t getMaxChunks() const { return m_maxChunks; };
+
+    private:
+        Slot allocateSlot(uint32_t quadCount);
+        void retireSlot(const Slot& slot, uint64_t frameNumber);
+        UploadQueue::Ticket writeSection(const Context& instance, const Device& device, Section& section,
+            const ChunkMesher::Section& mesh, uint64_t frameNumber);
+    };
+
+}
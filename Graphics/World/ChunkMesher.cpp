@@ -0,0 +1,397 @@
+#include "ChunkMesher.h"
+
+#include <thread>
+
+namespace Graphics {
+
+    // the chunk with a one block border of its neighbours around it, so every face test is a plain lookup
+    static constexpr int32_t paddedSize = chunkSize + 2;
+    static constexpr size_t paddedVolume = static_cast<size_t>(paddedSize) * paddedSize * paddedSize;
+    static constexpr int32_t paddedStrides[3] = { 1, paddedSize, paddedSize * paddedSize };
+
+    static size_t paddedIndex(const glm::ivec3& position)
+    {
+        return (static_cast<size_t>(position.z + 1) * paddedSize + (position.y + 1)) * paddedSize + (position.x + 1);
+    }
+
+    // the two axes spanning a face layer in chunkIndex order, used for the border layers
+    static constexpr int32_t layerAxes[3][2] = { { 1, 2 }, { 0, 2 }, { 0, 1 } };
+
+    // the two axes the greedy mask runs along, b is y on side faces so merged quads keep the texture upright
+    static constexpr int32_t maskAxes[3][2] = { { 2, 1 }, { 0, 2 }, { 0, 1 } };
+
+    // unpacks the chunk and its border layers into padded, missing neighbours stay air
+    static void fillPadded(const ChunkMesher::Input& input, std::vector<BlockId>& padded)
+    {
+        static thread_local std::vector<BlockId> blocks;
+        blocks.resize(chunkVolume);
+        input.chunk.decode(blocks);
+
+        padded.assign(paddedVolume, Block::Air);
+        for (int32_t z = 0; z < chunkSize; z++)
+            for (int32_t y = 0; y < chunkSize; y++)
+                std::copy_n(blocks.begin() + chunkIndex(0, y, z), chunkSize, padded.begin() + paddedIndex(glm::ivec3(0, y, z)));
+
+        for (uint32_t face = 0; face < Face::Count; face++) {
+            const auto& border = input.borders[face];
+            if (border.empty())
+                continue;
+            assert(border.size() == static_cast<size_t>(chunkSize) * chunkSize && "ChunkMesher::build() - border layers have to hold chunkSize * chunkSize blocks");
+
+            int32_t axis = face >> 1;
+            glm::ivec3 position;
+            position[axis] = (face & 1) ? chunkSize : -1;
+            size_t index = 0;
+            for (int32_t v = 0; v < chunkSize; v++) {
+                position[layerAxes[axis][1]] = v;
+                for (int32_t u = 0; u < chunkSize; u++, index++) {
+                    position[layerAxes[axis][0]] = u;
+                    padded[paddedIndex(position)] = border[index];
+                }
+            }
+        }
+
+        // every face test indexes the block table with these, an id it doesn't know is meshed as air
+        for (BlockId& block : padded) {
+            assert(block < Block::Count && "ChunkMesher::build() - Unknown block id");
+            if (block >= Block::Count)
+                block = Block::Air;
+        }
+    }
+
+    // greedy meshes the faces of the blocks inside one section
+    static void meshSection(const std::vector<BlockId>& padded, const ChunkMesher::BlockTable& blockTable,
+        uint32_t sectionIndex, ChunkMesher::Section& section)
+    {
+        static thread_local std::vector<VertexVoxel> transparent;
+        transparent.clear();
+
+        glm::ivec3 origin = sectionOrigin(sectionIndex);
+
+        // 0 is no face, otherwise the texture and transparency plus one, only equal keys are merged
+        std::array<uint32_t, sectionSize * sectionSize> mask;
+
+        for (uint32_t face = 0; face < Face::Count; face++) {
+            int32_t axis = face >> 1;
+            int32_t a = maskAxes[axis][0];
+            int32_t b = maskAxes[axis][1];
+            bool positive = face & 1;
+            int32_t neighbourOffset = positive ? paddedStrides[axis] : -paddedStrides[axis];
+
+            glm::ivec3 normal = Face::getNormal(face);
+            bool side = axis != 1;
+            // uvs run right and down when the face is looked at from outside, right is up x normal
+            glm::vec3 right = side ? glm::vec3(normal.z, 0.0f, -normal.x) : glm::vec3(1.0f, 0.0f, 0.0f);
+
+            glm::vec3 axisA(0.0f), axisB(0.0f);
+            axisA[a] = 1.0f;
+            axisB[b] = 1.0f;
+            // corners go origin, +a, +a+b, +b, which is counter clockwise from outside when a x b points outwards,
+            // otherwise they are emitted backwards so every quad works with the same indices
+            bool counterClockwise = glm::dot(glm::cross(axisA, axisB), glm::vec3(normal)) > 0.0f;
+
+            for (int32_t slice = origin[axis]; slice < origin[axis] + sectionSize; slice++) {
+                glm::ivec3 position;
+                position[axis] = slice;
+
+                size_t maskIndex = 0;
+                for (int32_t vb = 0; vb < sectionSize; vb++) {
+                    position[b] = origin[b] + vb;
+                    position[a] = origin[a];
+                    size_t index = paddedIndex(position);
+                    for (int32_t va = 0; va < sectionSize; va++, maskIndex++, index += paddedStrides[a]) {
+                        BlockId block = padded[index];
+                        const ChunkMesher::BlockInfo& info = blockTable[block];
+
+                        uint32_t key = 0;
+                        if (info.visible) {
+                            BlockId neighbour = padded[index + neighbourOffset];
+                            if (neighbour != block && !blockTable[neighbour].opaque)
+                                key = ((info.getTexture(face) << 1) | (info.opaque ? 0 : 1)) + 1;
+                        }
+                        mask[maskIndex] = key;
+                    }
+                }
+
+                for (int32_t vb = 0; vb < sectionSize; vb++) {
+                    for (int32_t va = 0; va < sectionSize;) {
+                        uint32_t key = mask[vb * sectionSize + va];
+                        if (key == 0) {
+                            va++;
+                            continue;
+                        }
+
+                        int32_t width = 1;
+                        while (va + width < sectionSize && mask[vb * sectionSize + va + width] == key)
+                            width++;
+
+                        int32_t height = 1;
+                        for (; vb + height < sectionSize; height++) {
+                            const uint32_t* row = &mask[(vb + height) * sectionSize + va];
+                            if (std::any_of(row, row + width, [key](uint32_t other) { return other != key; }))
+                                break;
+                        }
+
+                        for (int32_t clear = 0; clear < height; clear++)
+                            std::fill_n(&mask[(vb + clear) * sectionSize + va], width, 0u);
+
+                        glm::vec3 corner(0.0f);
+                        corner[axis] = static_cast<float>(slice + (positive ? 1 : 0));
+                        corner[a] = static_cast<float>(origin[a] + va);
+                        corner[b] = static_cast<float>(origin[b] + vb);
+
+                        glm::vec3 corners[4] = {
+                            corner,
+                            corner + axisA * static_cast<float>(width),
+                            corner + axisA * static_cast<float>(width) + axisB * static_cast<float>(height),
+                            corner + axisB * static_cast<float>(height)
+                        };
+                        if (!counterClockwise)
+                            std::swap(corners[1], corners[3]);
+
+                        auto& target = ((key - 1) & 1) ? transparent : section.vertices;
+                        uint32_t textureId = (key - 1) >> 1;
+                        for (const auto& point : corners) {
+                            glm::vec2 uv(glm::dot(point, right), side ? -point.y : point.z);
+                            target.push_back({ PackedVec3(point), PackedVec2(uv), textureId });
+                        }
+
+                        va += width;
+                    }
+                }
+            }
+        }
+
+        section.opaqueQuadCount = section.getQuadCount();
+        section.vertices.insert(section.vertices.end(), transparent.begin(), transparent.end());
+    }
+
+    ChunkMesher::ChunkMesher(MT::ThreadPool& threadPool, const BlockTable& blockTable /*= getDefaultBlockTable()*/, uint32_t maxInFlight /*= 0*/) :
+        m_threadPool(&threadPool), m_blockTable(blockTable)
+    {
+        if (maxInFlight == 0)
+            maxInFlight = std::max(1u, static_cast<uint32_t>(m_threadPool->getWorkerAmount()) * 2);
+        m_maxInFlight = maxInFlight;
+
+        m_coordinator = std::make_unique<MT::UniqueTaskCoordinator<ChunkCoord>>(threadPool, maxInFlight * 2);
+        m_completed = std::make_unique<MT::LockFreeQueue<Mesh>>(static_cast<size_t>(maxInFlight) * 2);
+
+        m_initialized = true;
+    }
+
+    void ChunkMesher::destroy()
+    {
+        if (!m_initialized)
+            return;
+
+        while (m_coordinator->getPendingCount() != 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+        Mesh mesh;
+        while (m_completed->tryPop(mesh));
+
+        m_coordinator.reset();
+        m_completed.reset();
+        m_pending.clear();
+        m_inFlight.clear();
+        m_priorityInFlight = 0;
+
+#ifdef _DEBUG
+        std::cout << "Destroyed ChunkMesher" << std::endl;
+#endif
+        m_initialized = false;
+    }
+
+    void ChunkMesher::request(Input&& input)
+    {
+        assert(m_initialized && "ChunkMesher::request() - ChunkMesher is not initialized");
+
+        for (auto& pending : m_pending) {
+            if (pending.coord == input.coord) {
+                input.sectionMask |= pending.sectionMask;
+                input.priority |= pending.priority;
+                pending = std::move(input);
+                return;
+            }
+        }
+
+        m_pending.push_back(std::move(input));
+    }
+
+    bool ChunkMesher::cancel(ChunkCoord coord)
+    {
+        auto it = std::find_if(m_pending.begin(), m_pending.end(), [&](const Input& input) { return input.coord == coord; });
+        if (it == m_pending.end())
+            return false;
+
+        m_pending.erase(it);
+        return true;
+    }
+
+    void ChunkMesher::update(const glm::vec3& cameraPosition)
+    {
+        assert(m_initialized && "ChunkMesher::update() - ChunkMesher is not initialized");
+
+        size_t capacity = m_completed->capacity();
+        if (m_pending.empty() || m_inFlight.size() >= capacity)
+            return;
+
+        auto distance = [&](const ChunkCoord& coord) {
+            glm::vec3 offset = coord.getCenter() - cameraPosition;
+            return glm::dot(offset, offset);
+            };
+        std::sort(m_pending.begin(), m_pending.end(), [&](const Input& a, const Input& b) {
+            if (a.priority != b.priority)
+                return a.priority;
+            return distance(a.coord) < distance(b.coord);
+            });
+
+        // dispatched inputs are moved out and compacted away, the ones waiting on an older mesh of the same chunk stay
+        size_t kept = 0;
+        size_t i = 0;
+        for (; i < m_pending.size() && m_inFlight.size() < capacity; i++) {
+            ChunkCoord coord = m_pending[i].coord;
+            bool priority = m_pending[i].priority;
+            bool waiting = m_inFlight.contains(coord) || !m_coordinator->canAddTask(coord);
+
+            // everything after the first regular request is regular too
+            if (!priority && m_inFlight.size() >= m_maxInFlight)
+                break;
+
+            if (waiting) {
+                if (kept != i)
+                    m_pending[kept] = std::move(m_pending[i]);
+                kept++;
+                continue;
+            }
+
+            auto task = [this, input = std::move(m_pending[i])]() {
+                Mesh mesh;
+                try {
+                    mesh = build(input, m_blockTable);
+                }
+                catch (const std::exception& e) {
+                    mesh = Mesh();
+                    mesh.coord = input.coord;
+                    mesh.sectionMask = input.sectionMask;
+                    mesh.priority = input.priority;
+#ifdef _DEBUG
+                    std::cout << "ChunkMesher failed to mesh chunk " << input.coord.x << ", " << input.coord.y << ", " << input.coord.z
+                        << ": " << e.what() << std::endl;
+#endif
+                }
+
+                // update() never dispatches more than the queue can hold
+                [[maybe_unused]] bool pushed = m_completed->tryPush(std::move(mesh));
+                assert(pushed && "ChunkMesher - completion queue overflow");
+                };
+
+            // only the pool shutting down gets here, the input goes with the task
+            if (!m_coordinator->tryAddTask(std::move(task), coord, priority)) {
+                i++;
+                break;
+            }
+            m_inFlight.insert(coord);
+            if (priority)
+                m_priorityInFlight++;
+        }
+
+        for (; i < m_pending.size(); i++, kept++)
+            if (kept != i)
+                m_pending[kept] = std::move(m_pending[i]);
+        m_pending.resize(kept);
+    }
+
+    bool ChunkMesher::poll(Mesh& mesh)
+    {
+        if (!m_completed->tryPop(mesh))
+            return false;
+
+        m_inFlight.erase(mesh.coord);
+        if (mesh.priority)
+            m_priorityInFlight--;
+        return true;
+    }
+
+    ChunkMesher::Mesh ChunkMesher::build(const Input& input, const BlockTable& blockTable)
+    {
+        Mesh mesh;
+        mesh.coord = input.coord;
+        mesh.transform = AffineTransform::fromMatrix(glm::translate(glm::mat4(1.0f), glm::vec3(input.coord.getOrigin())));
+        mesh.sectionMask = input.sectionMask;
+        mesh.priority = input.priority;
+        mesh.succeeded = true;
+
+        if (input.chunk.isEmpty() || input.sectionMask == 0)
+            return mesh;
+
+        // reused by every chunk a worker meshes
+        static thread_local std::vector<BlockId> padded;
+        fillPadded(input, padded);
+
+        for (uint32_t section = 0; section < sectionCount; section++)
+            if (input.sectionMask & (1u << section))
+                meshSection(padded, blockTable, section, mesh.sections[section]);
+
+        return mesh;
+    }
+
+    std::vector<uint16_t> ChunkMesher::makeQuadIndices(uint32_t quadCount /*= maxSectionQuads*/)
+    {
+        assert(static_cast<size_t>(quadCount) * 4 <= 0xFFFF && "ChunkMesher::makeQuadIndices() - quads don't fit 16 bit indices");
+
+        std::vector<uint16_t> indices;
+        indices.reserve(static_cast<size_t>(quadCount) * 6);
+        for (uint32_t quad = 0; quad < quadCount; quad++) {
+            uint16_t first = static_cast<uint16_t>(quad * 4);
+            indices.insert(indices.end(), { first, static_cast<uint16_t>(first + 1), static_cast<uint16_t>(first + 2),
+                first, static_cast<uint16_t>(first + 2), static_cast<uint16_t>(first + 3) });
+        }
+        return indices;
+    }
+
+    std::vector<BlockId> ChunkMesher::extractBorder(const Chunk& neighbour, uint32_t face)
+    {
+        std::vector<BlockId> border(static_cast<size_t>(chunkSize) * chunkSize);
+        if (neighbour.isUniform()) {
+            std::fill(border.begin(), border.end(), neighbour.get(0));
+            return border;
+        }
+
+        // the neighbour on the positive side touches this chunk with its first layer
+        int32_t axis = face >> 1;
+        glm::ivec3 position;
+        position[axis] = (face & 1) ? 0 : chunkSize - 1;
+        size_t index = 0;
+        for (int32_t v = 0; v < chunkSize; v++) {
+            position[layerAxes[axis][1]] = v;
+            for (int32_t u = 0; u < chunkSize; u++, index++) {
+                position[layerAxes[axis][0]] = u;
+                border[index] = neighbour.get(position.x, position.y, position.z);
+            }
+        }
+        return border;
+    }
+
+    ChunkMesher::Input ChunkMesher::makeInput(ChunkCoord coord, const Chunk& chunk, const std::array<const Chunk*, Face::Count>& neighbours)
+    {
+        Input input;
+        input.coord = coord;
+        input.chunk = chunk;
+        for (uint32_t face = 0; face < Face::Count; face++)
+            if (neighbours[face])
+                input.borders[face] = extractBorder(*neighbours[face], face);
+        return input;
+    }
+
+    ChunkMesher::BlockTable ChunkMesher::getDefaultBlockTable()
+    {
+        BlockTable table{};
+        table[Block::Grass] = { 1, 2, 0, true, true };
+        table[Block::Dirt] = { 2, 2, 2, true, true };
+        table[Block::Stone] = { 3, 3, 3, true, true };
+        table[Block::Water] = { 5, 5, 5, true, false };
+        return table;
+    }
+
+}
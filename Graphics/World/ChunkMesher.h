@@ -0,0 +1,179 @@
+#pragma once
+#include "../Common.h"
+#include "../BufferDataLayouts.h"
+#include "Voxel.h"
+#include "Chunk.h"
+
+#include "MultiThreading/ThreadPool.h"
+#include "MultiThreading/UniqueTaskCoordinator.h"
+#include "MultiThreading/LockFreeQueue.h"
+
+#include <array>
+#include <memory>
+
+namespace Graphics {
+
+    // turns chunks into VertexVoxel meshes on the thread pool
+    // only faces between a block and a non opaque neighbour are emitted, and coplanar faces with the same
+    // texture are merged into rectangles (greedy meshing), so a flat 16x16 floor is one quad instead of 256
+    // meshes are built per section so an edit only rebuilds the sections it touches, merging stops at section borders
+    // every quad is four vertices in counter clockwise order, drawn with the shared index list from makeQuadIndices()
+    // requests carry a copy of the chunk and the layers of its six neighbours, workers never touch live chunks
+    // request(), update() and poll() belong to one thread, build() is safe to call from any thread
+    class ChunkMesher
+    {
+    public:
+        // one quad for every face between two blocks of the section plus every face on its border,
+        // a checkerboard against air comes close, four vertices each still fit 16 bit indices
+        // two different non opaque blocks next to each other both get a face, a section full of those
+        // can go past it and is cut off by ChunkMeshPool
+        static constexpr uint32_t maxSectionQuads =
+            static_cast<uint32_t>(sectionVolume) * 3 + 6 * sectionSize * sectionSize;
+        static_assert(static_cast<size_t>(maxSectionQuads) * 4 <= 0xFFFF, "section quads have to fit 16 bit indices");
+
+        // how a block id is drawn, texture ids index the bindless textures[] array
+        struct BlockInfo
+        {
+            uint32_t topTexture = 0;
+            uint32_t bottomTexture = 0;
+            uint32_t sideTexture = 0;
+            bool visible = false;
+            // opaque blocks hide the faces of whatever is next to them
+            bool opaque = false;
+
+            uint32_t getTexture(uint32_t face) const
+            {
+                if (face == Face::PositiveY)
+                    return topTexture;
+                if (face == Face::NegativeY)
+                    return bottomTexture;
+                return sideTexture;
+            }
+        };
+
+        using BlockTable = std::array<BlockInfo, Block::Count>;
+
+        struct Input
+        {
+            ChunkCoord coord;
+            Chunk chunk;
+
+            // the layer of each neighbour that touches this chunk, indexed by Face, chunkSize * chunkSize blocks
+            // in chunkIndex order with the face axis left out, an empty layer means the neighbour isn't loaded
+            // and counts as air, so the border gets faces until the neighbour shows up and the chunk is remeshed
+            std::array<std::vector<BlockId>, Face::Count> borders;
+
+            // sections to rebuild, one bit per sectionIndex
+            uint32_t sectionMask = allSections;
+
+            // edits are dispatched before everything else and go to the front of the pool queue
+            bool priority = false;
+        };
+
+        struct Section
+        {
+            // four vertices per quad, the transparent quads come after the opaque ones
+            // so they can be drawn in a second, blended pass
+            std::vector<VertexVoxel> vertices;
+            uint32_t opaqueQuadCount = 0;
+
+            uint32_t getQuadCount() const { return static_cast<uint32_t>(vertices.size() / 4); };
+        };
+
+        struct Mesh
+        {
+            ChunkCoord coord;
+            // positions are local to the chunk, the transform moves them to the chunk origin
+            AffineTransform transform;
+            // only the sections in the mask were built, the others are left empty
+            std::array<Section, sectionCount> sections;
+            uint32_t sectionMask = 0;
+            bool priority = false;
+            bool succeeded = false;
+
+            uint32_t getQuadCount() const
+            {
+                uint32_t count = 0;
+                for (const auto& section : sections)
+                    count += section.getQuadCount();
+                return count;
+            }
+        };
+
+    private:
+        MT::ThreadPool* m_threadPool = nullptr;
+        BlockTable m_blockTable;
+        uint32_t m_maxInFlight = 0;
+
+        std::unique_ptr<MT::UniqueTaskCoordinator<ChunkCoord>> m_coordinator;
+        std::unique_ptr<MT::LockFreeQueue<Mesh>> m_completed;
+
+        // a chunk requested again before it was dispatched only keeps the latest input
+        std::vector<Input> m_pending;
+        // dispatched and not polled yet, a newer request for one of these waits so meshes arrive in request order
+        std::set<ChunkCoord> m_inFlight;
+        size_t m_priorityInFlight = 0;
+
+        bool m_initialized = false;
+    public:
+
+        ChunkMesher() {};
+
+        // maxInFlight of 0 uses twice the worker count, priority requests may go up to twice maxInFlight
+        // so edits never wait for a slot behind chunks that are being meshed for the first time
+        ChunkMesher(MT::ThreadPool& threadPool, const BlockTable& blockTable = getDefaultBlockTable(), uint32_t maxInFlight = 0);
+
+        // meshing tasks hold a pointer to the mesher, so it stays where it was created
+        ChunkMesher(ChunkMesher&&) noexcept = delete;
+        ChunkMesher& operator=(ChunkMesher&&) noexcept = delete;
+
+        ChunkMesher(const ChunkMesher&) noexcept = delete;
+        ChunkMesher& operator=(const ChunkMesher&) noexcept = delete;
+
+        ~ChunkMesher() { assert(!m_initialized && "ChunkMesher was not destroyed!"); };
+
+        // waits for the meshes in flight, undelivered results are dropped
+        void destroy();
+
+        // queues a chunk for meshing, a request for the same chunk that wasn't dispatched yet takes the new input
+        // and keeps the sections and priority of both
+        void request(Input&& input);
+
+        // drops a request that wasn't dispatched yet
+        bool cancel(ChunkCoord coord);
+
+        // dispatches the priority requests, then the pending chunks closest to the camera into the free slots
+        void update(const glm::vec3& cameraPosition);
+
+        // takes one finished mesh, never blocks
+        bool poll(Mesh& mesh);
+
+        size_t getPendingCount() const { return m_pending.size(); };
+        size_t getInFlightCount() const { return m_inFlight.size(); };
+
+        // true while a priority request is pending, in flight or waiting to be polled
+        bool hasPriorityWork() const
+        {
+            return m_priorityInFlight != 0 ||
+                std::any_of(m_pending.begin(), m_pending.end(), [](const Input& input) { return input.priority; });
+        }
+
+        const BlockTable& getBlockTable() const { return m_blockTable; };
+
+        // greedy meshes the sections of one chunk in the input's mask, safe to call from any thread
+        static Mesh build(const Input& input, const BlockTable& blockTable);
+
+        // index list for quadCount quads of four vertices each, shared by every section
+        static std::vector<uint16_t> makeQuadIndices(uint32_t quadCount = maxSectionQuads);
+
+        // copies the layer of neighbour that touches the chunk on the given face
+        static std::vector<BlockId> extractBorder(const Chunk& neighbour, uint32_t face);
+
+        // builds an input from the chunk and its neighbours indexed by Face, null for the ones that aren't loaded
+        static Input makeInput(ChunkCoord coord, const Chunk& chunk, const std::array<const Chunk*, Face::Count>& neighbours);
+
+        // the textures in textureNames.txt order: grass side, grass top, dirt, stone, highlight, water
+        static BlockTable getDefaultBlockTable();
+    };
+
+}
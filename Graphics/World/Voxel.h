@@ -0,0 +1,104 @@
+#pragma once
+#include "../Common.h"
+
+#include <tuple>
+
+namespace Graphics {
+
+    // block ids as stored in chunks, 0 is always air
+    using BlockId = uint16_t;
+
+    namespace Block
+    {
+        constexpr BlockId Air = 0;
+        constexpr BlockId Grass = 1;
+        constexpr BlockId Dirt = 2;
+        constexpr BlockId Stone = 3;
+        constexpr BlockId Water = 4;
+
+        constexpr BlockId Count = 5;
+    }
+
+    // the six sides of a block or chunk, the axis is face / 2 and the low bit picks the positive side
+    namespace Face
+    {
+        constexpr uint32_t NegativeX = 0;
+        constexpr uint32_t PositiveX = 1;
+        constexpr uint32_t NegativeY = 2;
+        constexpr uint32_t PositiveY = 3;
+        constexpr uint32_t NegativeZ = 4;
+        constexpr uint32_t PositiveZ = 5;
+
+        constexpr uint32_t Count = 6;
+
+        inline uint32_t opposite(uint32_t face) { return face ^ 1; };
+
+        inline glm::ivec3 getNormal(uint32_t face)
+        {
+            glm::ivec3 normal(0);
+            normal[face >> 1] = (face & 1) ? 1 : -1;
+            return normal;
+        }
+    }
+
+    // chunks are cubes of chunkSize blocks, y is up like the rest of the engine
+    constexpr int32_t chunkSize = 32;
+    constexpr size_t chunkVolume = static_cast<size_t>(chunkSize) * chunkSize * chunkSize;
+
+    // x varies fastest, then y, then z, the same order the noise grid fills write in
+    inline size_t chunkIndex(int32_t x, int32_t y, int32_t z)
+    {
+        return (static_cast<size_t>(z) * chunkSize + y) * chunkSize + x;
+    }
+
+    // chunks are meshed and uploaded in sections of sectionSize cubed blocks, so an edit only rebuilds the sections it touches
+    constexpr int32_t sectionSize = 16;
+    constexpr int32_t sectionsPerAxis = chunkSize / sectionSize;
+    constexpr uint32_t sectionCount = sectionsPerAxis * sectionsPerAxis * sectionsPerAxis;
+    constexpr size_t sectionVolume = static_cast<size_t>(sectionSize) * sectionSize * sectionSize;
+    constexpr uint32_t allSections = (1u << sectionCount) - 1;
+
+    // section holding the block at a local position, in the same x, y, z order as chunkIndex
+    inline uint32_t sectionIndex(int32_t x, int32_t y, int32_t z)
+    {
+        return ((z / sectionSize) * sectionsPerAxis + (y / sectionSize)) * sectionsPerAxis + (x / sectionSize);
+    }
+
+    // local position of the first block of a section
+    inline glm::ivec3 sectionOrigin(uint32_t section)
+    {
+        return glm::ivec3(section % sectionsPerAxis, (section / sectionsPerAxis) % sectionsPerAxis,
+            section / (sectionsPerAxis * sectionsPerAxis)) * sectionSize;
+    }
+
+    struct ChunkCoord
+    {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t z = 0;
+
+        bool operator==(const ChunkCoord& other) const { return x == other.x && y == other.y && z == other.z; };
+        bool operator!=(const ChunkCoord& other) const { return !(*this == other); };
+        bool operator<(const ChunkCoord& other) const { return std::tie(x, y, z) < std::tie(other.x, other.y, other.z); };
+
+        // world position of the block at local (0, 0, 0)
+        glm::ivec3 getOrigin() const { return glm::ivec3(x, y, z) * chunkSize; };
+        glm::vec3 getCenter() const { return glm::vec3(getOrigin()) + glm::vec3(chunkSize * 0.5f); };
+
+        // chunk holding the block at a world position, rounds towards negative infinity
+        static ChunkCoord fromBlock(glm::ivec3 block)
+        {
+            auto divide = [](int32_t value) { return value >= 0 ? value / chunkSize : (value - chunkSize + 1) / chunkSize; };
+            return { divide(block.x), divide(block.y), divide(block.z) };
+        }
+    };
+
+    struct ChunkCoordHash
+    {
+        size_t operator()(const ChunkCoord& coord) const
+        {
+            return static_cast<size_t>(hashBytes(&coord, sizeof(ChunkCoord)));
+        }
+    };
+
+}
@@ -0,0 +1,159 @@
+#include "VoxelWorld.h"
+
+#include <thread>
+
+namespace Graphics {
+
+    static ChunkCoord getNeighbour(ChunkCoord coord, uint32_t face)
+    {
+        glm::ivec3 normal = Face::getNormal(face);
+        return { coord.x + normal.x, coord.y + normal.y, coord.z + normal.z };
+    }
+
+    VoxelWorld::VoxelWorld(ChunkMesher& mesher, ChunkMeshPool& meshPool, std::chrono::microseconds editBudget /*= defaultEditBudget*/) :
+        m_mesher(&mesher), m_meshPool(&meshPool), m_editBudget(editBudget)
+    {
+    }
+
+    uint32_t VoxelWorld::getBorderSections(uint32_t face)
+    {
+        int32_t axis = face >> 1;
+        int32_t border = (face & 1) ? chunkSize - sectionSize : 0;
+
+        uint32_t sections = 0;
+        for (uint32_t section = 0; section < sectionCount; section++)
+            if (sectionOrigin(section)[axis] == border)
+                sections |= 1u << section;
+        return sections;
+    }
+
+    void VoxelWorld::markDirty(ChunkCoord coord, uint32_t sections, bool edited)
+    {
+        auto it = m_chunks.find(coord);
+        if (it == m_chunks.end())
+            return;
+
+        Entry& entry = it->second;
+        if (entry.dirtySections == 0)
+            m_dirty.push_back(coord);
+        entry.dirtySections |= sections;
+        entry.edited |= edited;
+    }
+
+    void VoxelWorld::insertChunk(ChunkCoord coord, Chunk&& chunk)
+    {
+        m_chunks[coord].chunk = std::move(chunk);
+        markDirty(coord, allSections, false);
+
+        // their border faces were built against air
+        for (uint32_t face = 0; face < Face::Count; face++)
+            markDirty(getNeighbour(coord, face), getBorderSections(Face::opposite(face)), false);
+    }
+
+    void VoxelWorld::removeChunk(ChunkCoord coord, uint64_t frameNumber)
+    {
+        if (m_chunks.erase(coord) == 0)
+            return;
+
+        m_mesher->cancel(coord);
+        m_meshPool->remove(coord, frameNumber);
+
+        for (uint32_t face = 0; face < Face::Count; face++)
+            markDirty(getNeighbour(coord, face), getBorderSections(Face::opposite(face)), false);
+    }
+
+    BlockId VoxelWorld::getBlock(const glm::ivec3& position) const
+    {
+        ChunkCoord coord = ChunkCoord::fromBlock(position);
+        const Chunk* chunk = getChunk(coord);
+        if (!chunk)
+            return Block::Air;
+
+        glm::ivec3 local = position - coord.getOrigin();
+        return chunk->get(local.x, local.y, local.z);
+    }
+
+    bool VoxelWorld::setBlock(const glm::ivec3& position, BlockId block)
+    {
+        ChunkCoord coord = ChunkCoord::fromBlock(position);
+        auto it = m_chunks.find(coord);
+        if (it == m_chunks.end())
+            return false;
+
+        glm::ivec3 local = position - coord.getOrigin();
+        if (it->second.chunk.get(local.x, local.y, local.z) == block)
+            return true;
+        it->second.chunk.set(local.x, local.y, local.z, block);
+
+        // the block's own faces and the faces its neighbours have towards it
+        markDirty(coord, 1u << sectionIndex(local.x, local.y, local.z), true);
+        for (uint32_t face = 0; face < Face::Count; face++) {
+            glm::ivec3 neighbour = position + Face::getNormal(face);
+            ChunkCoord neighbourCoord = ChunkCoord::fromBlock(neighbour);
+            glm::ivec3 neighbourLocal = neighbour - neighbourCoord.getOrigin();
+            markDirty(neighbourCoord, 1u << sectionIndex(neighbourLocal.x, neighbourLocal.y, neighbourLocal.z), true);
+        }
+
+        return true;
+    }
+
+    void VoxelWorld::update(const Context& instance, const Device& device, const glm::vec3& cameraPosition,
+        uint64_t frameNumber, uint64_t completedFrameNumber)
+    {
+        assert(m_mesher && "VoxelWorld::update() - VoxelWorld has no mesher");
+
+        // inputs are copies, the chunks can keep changing while the workers mesh them
+        for (ChunkCoord coord : m_dirty) {
+            auto it = m_chunks.find(coord);
+            if (it == m_chunks.end())
+                continue;
+
+            std::array<const Chunk*, Face::Count> neighbours;
+            for (uint32_t face = 0; face < Face::Count; face++)
+                neighbours[face] = getChunk(getNeighbour(coord, face));
+
+            ChunkMesher::Input input = ChunkMesher::makeInput(coord, it->second.chunk, neighbours);
+            input.sectionMask = it->second.dirtySections;
+            input.priority = it->second.edited;
+            m_mesher->request(std::move(input));
+
+            it->second.dirtySections = 0;
+            it->second.edited = false;
+        }
+        m_dirty.clear();
+
+        m_mesher->update(cameraPosition);
+
+        // edited sections are a few hundred microseconds of work at the front of the pool queue, waiting for them
+        // here is what keeps an edit from showing up a frame or two late
+        bool edited = false;
+        auto deadline = std::chrono::steady_clock::now() + m_editBudget;
+        while (true) {
+            ChunkMesher::Mesh mesh;
+            while (m_mesher->poll(mesh)) {
+                // the chunk was removed while its mesh was in flight
+                if (!m_chunks.contains(mesh.coord))
+                    continue;
+
+                // the sections are still out of date, try them again next update
+                if (!mesh.succeeded) {
+                    markDirty(mesh.coord, mesh.sectionMask, mesh.priority);
+                    continue;
+                }
+
+                m_meshPool->write(instance, device, mesh, frameNumber);
+                edited |= mesh.priority;
+            }
+
+            if (!m_mesher->hasPriorityWork() || std::chrono::steady_clock::now() >= deadline)
+                break;
+
+            // another edit of a chunk waits for the mesh of the previous one, dispatch it as soon as that is back
+            m_mesher->update(cameraPosition);
+            std::this_thread::yield();
+        }
+
+        m_meshPool->update(instance, device, frameNumber, completedFrameNumber, edited);
+    }
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "../Common.h"
+#include "../Rendering/Context.h"
+#include "../Rendering/Device.h"
+#include "Voxel.h"
+#include "Chunk.h"
+#include "ChunkMesher.h"
+#include "ChunkMeshPool.h"
+
+#include <unordered_map>
+
+namespace Graphics {
+
+    // the loaded chunks and the bookkeeping that keeps their meshes in sync with block edits
+    // an edit marks the section of the block and the sections of its six neighbours dirty, which reaches into
+    // the neighbouring chunk when the block sits on a border, so only those sections are remeshed and uploaded
+    // edits are meshed as priority requests and update() waits up to editBudget for them, then waits on their upload,
+    // so an edit made before update() is drawn the same frame, loads are meshed in the background like before
+    // everything here belongs to the render thread
+    class VoxelWorld
+    {
+    public:
+        static constexpr std::chrono::microseconds defaultEditBudget = std::chrono::microseconds(4000);
+
+    private:
+        struct Entry
+        {
+            Chunk chunk;
+            uint32_t dirtySections = 0;
+            bool edited = false;
+        };
+
+        ChunkMesher* m_mesher = nullptr;
+        ChunkMeshPool* m_meshPool = nullptr;
+        std::chrono::microseconds m_editBudget = defaultEditBudget;
+
+        std::unordered_map<ChunkCoord, Entry, ChunkCoordHash> m_chunks;
+        // chunks with dirty sections in the order they got dirty, handed to the mesher in update()
+        std::vector<ChunkCoord> m_dirty;
+
+        void markDirty(ChunkCoord coord, uint32_t sections, bool edited);
+
+    public:
+
+        VoxelWorld() {};
+
+        VoxelWorld(ChunkMesher& mesher, ChunkMeshPool& meshPool, std::chrono::microseconds editBudget = defaultEditBudget);
+
+        // takes over a generated chunk and queues all of it for meshing, loaded neighbours remesh the sections facing it
+        void insertChunk(ChunkCoord coord, Chunk&& chunk);
+
+        // drops the chunk and its mesh, loaded neighbours remesh the sections that faced it
+        void removeChunk(ChunkCoord coord, uint64_t frameNumber);
+
+        // air for blocks in chunks that aren't loaded
+        BlockId getBlock(const glm::ivec3& position) const;
+
+        // false if the chunk holding the block isn't loaded
+        bool setBlock(const glm::ivec3& position, BlockId block);
+
+        // hands the dirty sections to the mesher, uploads every finished mesh and switches what completed,
+        // frameNumber and completedFrameNumber are the FrameScheduler ones
+        void update(const Context& instance, const Device& device, const glm::vec3& cameraPosition,
+            uint64_t frameNumber, uint64_t completedFrameNumber);
+
+        const Chunk* getChunk(ChunkCoord coord) const
+        {
+            auto it = m_chunks.find(coord);
+            return it == m_chunks.end() ? nullptr : &it->second.chunk;
+        }
+
+        bool isLoaded(ChunkCoord coord) const { return m_chunks.contains(coord); };
+        size_t getChunkCount() const { return m_chunks.size(); };
+        size_t getDirtyCount() const { return m_dirty.size(); };
+
+        // sections of a chunk that touch the given face
+        static uint32_t getBorderSections(uint32_t face);
+    };
+
+}
@@ -22,6 +22,6 @@ vec4 adjustContrast(vec4 color, float contrast) {
 }
 
 void main() {
-    vec4 texColor = texture(textures[textureId], fragTexCoord);
+    vec4 texColor = texture(textures[nonuniformEXT(textureId)], fragTexCoord);
     outColor = adjustContrast(texColor, 1.0);
 }
\ No newline at end of file
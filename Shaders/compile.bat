@@ -1,3 +1,5 @@
 "E:/Program Files (x86)/API/Vulkan/Bin/glslc.exe" basic.vert -o vert.spv
 "E:/Program Files (x86)/API/Vulkan/Bin/glslc.exe" basic.frag -o frag.spv
+"E:/Program Files (x86)/API/Vulkan/Bin/glslc.exe" voxel.vert -o voxel.vert.spv
+"E:/Program Files (x86)/API/Vulkan/Bin/glslc.exe" cull.comp -o cull.comp.spv
 pause
\ No newline at end of file
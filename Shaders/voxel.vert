@@ -0,0 +1,26 @@
+#version 450
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in uint inTextureId;
+
+// chunk placement, top 3 rows of the model matrix
+layout(location = 3) in vec4 inModelRow0;
+layout(location = 4) in vec4 inModelRow1;
+layout(location = 5) in vec4 inModelRow2;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint textureId;
+
+layout(set = 0, binding = 0) uniform UniformTransforms {
+    mat4 view;
+    mat4 proj;
+} ubo;
+
+void main() {
+    vec4 position = vec4(inPosition, 1.0);
+    vec3 worldPosition = vec3(dot(inModelRow0, position), dot(inModelRow1, position), dot(inModelRow2, position));
+
+    gl_Position = ubo.proj * ubo.view * vec4(worldPosition, 1.0);
+    fragTexCoord = inTexCoord;
+    textureId = inTextureId;
+}
\ No newline at end of file
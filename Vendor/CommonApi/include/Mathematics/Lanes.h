@@ -0,0 +1,95 @@
+#pragma once
+#include "../Namespaces.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#endif
+
+namespace Mathematics
+{
+	// thin wrappers so one kernel can be written for scalar, sse4 and avx2 floats
+	// every op maps to exactly one instruction, no fused multiply add, so a kernel gives the same bits on every width
+	// (the scalar side needs fp contraction off, the msvc default, -ffp-contract=off on gcc and clang)
+	namespace Lanes
+	{
+		struct Scalar
+		{
+			using Float = float;
+			static constexpr int width = 1;
+
+			static Float set(float value) { return value; }
+			static Float load(const float* source) { return *source; }
+			static void store(float* destination, Float value) { *destination = value; }
+			static Float toFloat(const int* source) { return (float)*source; }
+			static Float gather(const float* base, const int* indices) { return base[*indices]; }
+
+			static Float add(Float a, Float b) { return a + b; }
+			static Float sub(Float a, Float b) { return a - b; }
+			static Float mul(Float a, Float b) { return a * b; }
+		};
+
+#if defined(__AVX2__) || defined(__SSE4_1__) || defined(__AVX__)
+		struct Sse4
+		{
+			using Float = __m128;
+			static constexpr int width = 4;
+
+			static Float set(float value) { return _mm_set1_ps(value); }
+			static Float load(const float* source) { return _mm_loadu_ps(source); }
+			static void store(float* destination, Float value) { _mm_storeu_ps(destination, value); }
+			static Float toFloat(const int* source) { return _mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)source)); }
+			static Float gather(const float* base, const int* indices)
+			{
+				return _mm_setr_ps(base[indices[0]], base[indices[1]], base[indices[2]], base[indices[3]]);
+			}
+
+			static Float add(Float a, Float b) { return _mm_add_ps(a, b); }
+			static Float sub(Float a, Float b) { return _mm_sub_ps(a, b); }
+			static Float mul(Float a, Float b) { return _mm_mul_ps(a, b); }
+		};
+#endif
+
+#if defined(__AVX2__)
+		struct Avx2
+		{
+			using Float = __m256;
+			static constexpr int width = 8;
+
+			static Float set(float value) { return _mm256_set1_ps(value); }
+			static Float load(const float* source) { return _mm256_loadu_ps(source); }
+			static void store(float* destination, Float value) { _mm256_storeu_ps(destination, value); }
+			static Float toFloat(const int* source) { return _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)source)); }
+			static Float gather(const float* base, const int* indices)
+			{
+				return _mm256_i32gather_ps(base, _mm256_loadu_si256((const __m256i*)indices), 4);
+			}
+
+			static Float add(Float a, Float b) { return _mm256_add_ps(a, b); }
+			static Float sub(Float a, Float b) { return _mm256_sub_ps(a, b); }
+			static Float mul(Float a, Float b) { return _mm256_mul_ps(a, b); }
+		};
+
+		using Native = Avx2;
+#elif defined(__SSE4_1__) || defined(__AVX__)
+		using Native = Sse4;
+#else
+		using Native = Scalar;
+#endif
+
+		// same operation order as Mathematics::lerp and Mathematics::fade
+		template<typename L>
+		inline typename L::Float lerp(typename L::Float a, typename L::Float b, typename L::Float alpha)
+		{
+			return L::add(a, L::mul(alpha, L::sub(b, a)));
+		}
+
+		template<typename L>
+		inline typename L::Float fade(typename L::Float alpha)
+		{
+			typename L::Float polynomial = L::add(L::mul(L::sub(L::mul(L::set(6), alpha), L::set(15)), alpha), L::set(10));
+			return L::mul(L::mul(L::mul(polynomial, alpha), alpha), alpha);
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "../Namespaces.h"
 #include "Common.h"
+#include "Lanes.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -8,6 +9,7 @@
 
 #include <random>
 #include <array>
+#include <vector>
 
 namespace Mathematics
 {
@@ -60,6 +62,184 @@ namespace Mathematics
 			return permutationTable[permutationTable[permutationTable[x & 255] + (y & 255)] + (z & 255)];
 		}
 
+		// scratch for one octave of a grid fill, the samples of a row are split into slots, one for every run
+		// of samples in the same lattice cell, cells only depend on x so the slots are shared by every row
+		// corner bit 0 is x + 1, bit 1 is y + 1, bit 2 is z + 1
+		struct RowScratch
+		{
+			std::vector<int> cells;
+			std::vector<int> slots;
+			std::vector<float> gradients; // x, y and z of every corner gradient per slot
+			std::vector<float> weighted; // gradient y and z times the row constant offsets
+			int stride = 0;
+			int slotCount = 0;
+
+			// lattice y and z of the last row, rows in the same cells reuse its gradients if they were looked up
+			int yCellCoord = 0;
+			int zCellCoord = 0;
+			bool hasRow = false;
+			bool looked = false;
+
+			RowScratch(int count) : cells(count), slots(count), gradients(8 * 3 * count), weighted(8 * 2 * count), stride(count) {}
+		};
+
+		void splitCells(const float* xs, int count, RowScratch& scratch) const
+		{
+			scratch.slotCount = 0;
+			scratch.hasRow = false;
+			scratch.looked = false;
+			for (int i = 0; i < count; i++)
+			{
+				int xCellCoord = xs[i];
+				if (xs[i] < 0)
+					xCellCoord -= 1;
+				scratch.cells[i] = xCellCoord;
+
+				if (i == 0 || xCellCoord != scratch.cells[i - 1])
+					scratch.slotCount++;
+				scratch.slots[i] = scratch.slotCount - 1;
+			}
+		}
+
+		void lookupGradients(int yCellCoord, int zCellCoord, int count, RowScratch& scratch) const
+		{
+			int slot = -1;
+			for (int i = 0; i < count; i++)
+			{
+				if (scratch.slots[i] == slot)
+					continue;
+				slot = scratch.slots[i];
+
+				// stepping into the next cell, its left corners are the right corners of the last slot
+				int xCellCoord = scratch.cells[i];
+				bool adjacent = i > 0 && xCellCoord == scratch.cells[i - 1] + 1;
+				for (int corner = 0; corner < 8; corner++)
+				{
+					float* target = scratch.gradients.data() + corner * 3 * scratch.stride + slot;
+					glm::vec3 gradient;
+					if (adjacent && !(corner & 1))
+					{
+						const float* previous = scratch.gradients.data() + (corner | 1) * 3 * scratch.stride + slot - 1;
+						gradient = glm::vec3(previous[0], previous[scratch.stride], previous[2 * scratch.stride]);
+					}
+					else
+						gradient = getGradient(xCellCoord + (corner & 1), yCellCoord + (corner >> 1 & 1), zCellCoord + (corner >> 2 & 1));
+
+					target[0] = gradient.x;
+					target[scratch.stride] = gradient.y;
+					target[2 * scratch.stride] = gradient.z;
+				}
+			}
+
+			scratch.looked = true;
+		}
+
+		template<typename L>
+		int fillRowLanes(float* row, const float* xs, int begin, int count, const RowScratch& scratch,
+			float v, float w, float amplitude, bool accumulate) const
+		{
+			using Float = typename L::Float;
+			const Float one = L::set(1.0f);
+
+			int i = begin;
+			for (; i + L::width <= count; i += L::width)
+			{
+				Float X = L::sub(L::load(xs + i), L::toFloat(scratch.cells.data() + i));
+				Float Xinverse = L::sub(one, X);
+
+				// slots only grow along the row, usually the whole group sits in one cell
+				const int* slots = scratch.slots.data() + i;
+				bool uniform = slots[0] == slots[L::width - 1];
+				auto fetch = [&](const float* base) {
+					return uniform ? L::set(base[slots[0]]) : L::gather(base, slots);
+				};
+
+				// (gradient.x * x + gradient.y * y) + gradient.z * z, the glm::dot order
+				Float dots[8];
+				for (int corner = 0; corner < 8; corner++)
+				{
+					Float gradientX = fetch(scratch.gradients.data() + corner * 3 * scratch.stride);
+					Float weightedY = fetch(scratch.weighted.data() + corner * 2 * scratch.stride);
+					Float weightedZ = fetch(scratch.weighted.data() + (corner * 2 + 1) * scratch.stride);
+					dots[corner] = L::add(L::add(L::mul(gradientX, (corner & 1) ? Xinverse : X), weightedY), weightedZ);
+				}
+
+				Float u = Lanes::fade<L>(X);
+				Float lerpFront = Lanes::lerp<L>(Lanes::lerp<L>(dots[4], dots[5], u), Lanes::lerp<L>(dots[6], dots[7], u), L::set(v));
+				Float lerpBack = Lanes::lerp<L>(Lanes::lerp<L>(dots[0], dots[1], u), Lanes::lerp<L>(dots[2], dots[3], u), L::set(v));
+				Float value = Lanes::lerp<L>(lerpBack, lerpFront, L::set(w));
+
+				if (accumulate)
+					L::store(row + i, L::add(L::load(row + i), L::mul(value, L::set(amplitude))));
+				else
+					L::store(row + i, value);
+			}
+			return i;
+		}
+
+		// one row of getOctave(xs[i], y, z), either stored or added to row scaled by amplitude
+		void fillRow(float* row, const float* xs, int count, float y, float z, float amplitude, bool accumulate, RowScratch& scratch) const
+		{
+			int yCellCoord = y;
+			int zCellCoord = z;
+			if (y < 0)
+				yCellCoord -= 1;
+			if (z < 0)
+				zCellCoord -= 1;
+
+			float Y = y - yCellCoord;
+			float Z = z - zCellCoord;
+
+			bool sameCells = scratch.hasRow && yCellCoord == scratch.yCellCoord && zCellCoord == scratch.zCellCoord;
+			scratch.yCellCoord = yCellCoord;
+			scratch.zCellCoord = zCellCoord;
+			scratch.hasRow = true;
+
+			if (!sameCells || !scratch.looked)
+			{
+				// hardly any samples share a cell and the last row was in other cells, nothing to hoist
+				if (!sameCells && scratch.slotCount * 2 > count)
+				{
+					scratch.looked = false;
+					for (int i = 0; i < count; i++)
+					{
+						float value = getOctave(xs[i], y, z);
+						row[i] = accumulate ? row[i] + value * amplitude : value;
+					}
+					return;
+				}
+				lookupGradients(yCellCoord, zCellCoord, count, scratch);
+			}
+
+			for (int corner = 0; corner < 8; corner++)
+			{
+				float offsetY = (corner >> 1 & 1) ? 1 - Y : Y;
+				float offsetZ = (corner >> 2 & 1) ? 1 - Z : Z;
+				const float* gradient = scratch.gradients.data() + corner * 3 * scratch.stride;
+				float* weighted = scratch.weighted.data() + corner * 2 * scratch.stride;
+				for (int slot = 0; slot < scratch.slotCount; slot++)
+				{
+					weighted[slot] = gradient[scratch.stride + slot] * offsetY;
+					weighted[scratch.stride + slot] = gradient[2 * scratch.stride + slot] * offsetZ;
+				}
+			}
+
+			float v = fade(Y);
+			float w = fade(Z);
+
+			int i = fillRowLanes<Lanes::Native>(row, xs, 0, count, scratch, v, w, amplitude, accumulate);
+			fillRowLanes<Lanes::Scalar>(row, xs, i, count, scratch, v, w, amplitude, accumulate);
+		}
+
+		void fillOctaveGrid(float* out, const float* xs, const float* ys, const float* zs, glm::ivec3 size,
+			float amplitude, bool accumulate, RowScratch& scratch) const
+		{
+			splitCells(xs, size.x, scratch);
+			for (int z = 0; z < size.z; z++)
+				for (int y = 0; y < size.y; y++)
+					fillRow(out + ((size_t)z * size.y + y) * size.x, xs, size.x, ys[y], zs[z], amplitude, accumulate, scratch);
+		}
+
 	public:
 
 		void setSeed(unsigned int newSeed)
@@ -138,5 +318,67 @@ namespace Mathematics
 			return total / maxValue;
 		}
 
+		// evaluates getOctave over a size.x * size.y * size.z lattice into out, laid out as out[(z * size.y + y) * size.x + x]
+		// sample (x, y, z) sits at origin + (x, y, z) * spacing, with each coordinate computed as origin.x + x * spacing.x,
+		// the result is bit identical to calling getOctave at those coordinates
+		void fillGrid(float* out, glm::vec3 origin, glm::ivec3 size, glm::vec3 spacing = glm::vec3(1.0f)) const
+		{
+			if (size.x <= 0 || size.y <= 0 || size.z <= 0)
+				return;
+
+			std::vector<float> xs(size.x), ys(size.y), zs(size.z);
+			for (int i = 0; i < size.x; i++)
+				xs[i] = origin.x + i * spacing.x;
+			for (int i = 0; i < size.y; i++)
+				ys[i] = origin.y + i * spacing.y;
+			for (int i = 0; i < size.z; i++)
+				zs[i] = origin.z + i * spacing.z;
+
+			RowScratch scratch(size.x);
+			fillOctaveGrid(out, xs.data(), ys.data(), zs.data(), size, 1.0f, false, scratch);
+		}
+
+		// getFbm over the same lattice as fillGrid, bit identical to calling getFbm at every sample
+		void fillFbmGrid(float* out, glm::vec3 origin, glm::ivec3 size, glm::vec3 spacing, int octaves,
+			float frequency = 1.0f, float amplitude = 1.0f, float persistence = 0.5f, float lacunarity = 2.0f) const
+		{
+			if (size.x <= 0 || size.y <= 0 || size.z <= 0)
+				return;
+
+			std::vector<float> xs(size.x), ys(size.y), zs(size.z);
+			for (int i = 0; i < size.x; i++)
+				xs[i] = origin.x + i * spacing.x;
+			for (int i = 0; i < size.y; i++)
+				ys[i] = origin.y + i * spacing.y;
+			for (int i = 0; i < size.z; i++)
+				zs[i] = origin.z + i * spacing.z;
+
+			size_t sampleCount = (size_t)size.x * size.y * size.z;
+			std::fill(out, out + sampleCount, 0.0f);
+
+			std::vector<float> octaveXs(size.x), octaveYs(size.y), octaveZs(size.z);
+			RowScratch scratch(size.x);
+			float maxValue = 0.0f;
+
+			for (int octave = 0; octave < octaves; octave++)
+			{
+				for (int i = 0; i < size.x; i++)
+					octaveXs[i] = xs[i] * frequency;
+				for (int i = 0; i < size.y; i++)
+					octaveYs[i] = ys[i] * frequency;
+				for (int i = 0; i < size.z; i++)
+					octaveZs[i] = zs[i] * frequency;
+
+				fillOctaveGrid(out, octaveXs.data(), octaveYs.data(), octaveZs.data(), size, amplitude, true, scratch);
+
+				maxValue += amplitude;
+				amplitude *= persistence;
+				frequency *= lacunarity;
+			}
+
+			for (size_t i = 0; i < sampleCount; i++)
+				out[i] /= maxValue;
+		}
+
 	};
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+#include "../Namespaces.h"
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+namespace MultiThreading
+{
+	// bounded multi producer multi consumer queue, every cell carries a sequence number
+	// that tells producers and consumers whose turn it is, so neither side ever takes a lock
+	// the capacity is rounded up to a power of two, tryPush fails instead of blocking once it is full
+	template <typename T>
+	class LockFreeQueue
+	{
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			T data;
+		};
+
+		std::unique_ptr<Cell[]> m_cells;
+		size_t m_mask = 0;
+
+		// producers and consumers hammer different counters, keep them off the same cache line
+		alignas(64) std::atomic<size_t> m_enqueuePosition = 0;
+		alignas(64) std::atomic<size_t> m_dequeuePosition = 0;
+
+	public:
+		explicit LockFreeQueue(size_t capacity)
+		{
+			size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+
+			m_cells = std::make_unique<Cell[]>(size);
+			for (size_t i = 0; i < size; i++)
+				m_cells[i].sequence.store(i, std::memory_order_relaxed);
+			m_mask = size - 1;
+		}
+
+		LockFreeQueue(const LockFreeQueue&) = delete;
+		LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+		LockFreeQueue(LockFreeQueue&&) = delete;
+		LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+
+		bool tryPush(T value)
+		{
+			Cell* cell;
+			size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				cell = &m_cells[position & m_mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+				if (difference == 0)
+				{
+					if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false; // full
+				else
+					position = m_enqueuePosition.load(std::memory_order_relaxed);
+			}
+
+			cell->data = std::move(value);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool tryPop(T& value)
+		{
+			Cell* cell;
+			size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				cell = &m_cells[position & m_mask];
+				size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+				if (difference == 0)
+				{
+					if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false; // empty
+				else
+					position = m_dequeuePosition.load(std::memory_order_relaxed);
+			}
+
+			value = std::move(cell->data);
+			cell->data = T();
+			cell->sequence.store(position + m_mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		// only a snapshot while other threads are pushing or popping
+		size_t size() const
+		{
+			return m_enqueuePosition.load(std::memory_order_relaxed) - m_dequeuePosition.load(std::memory_order_relaxed);
+		}
+
+		size_t capacity() const { return m_mask + 1; };
+	};
+}
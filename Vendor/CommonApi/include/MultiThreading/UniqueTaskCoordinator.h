@@ -16,13 +16,12 @@ namespace MultiThreading
 		Synchronized<std::set<T, Hash>> m_pendingTasks;
 	public:
 		UniqueTaskCoordinator(ThreadPool& threadPool, unsigned int maxPendingTasks) :
-			m_threadPoolHandle(threadPool),
 			m_maxPendingTasks(maxPendingTasks),
-			m_pendingTasks(Synchronized<std::vector<T>>()) {
-			m_pendingTasks.getWriteAccess()->reserve(maxPendingTasks);
+			m_threadPoolHandle(threadPool) {
 		}
 
-		bool tryAddTask(std::function<void()> task, T identifier)
+		// priority tasks go to the front of the pool queue
+		bool tryAddTask(std::function<void()> task, T identifier, bool priority = false)
 		{
 			{
 				auto access = m_pendingTasks.getWriteAccess();
@@ -32,11 +31,20 @@ namespace MultiThreading
 				access->insert(identifier);
 			}
 
-			m_threadPoolHandle.pushTask([this, f = std::move(task), identifier] {
+			auto wrapped = [this, f = std::move(task), identifier] {
 				f();
 				auto access = m_pendingTasks.getWriteAccess();
 				access->erase(identifier);
-				});
+				};
+			bool pushed = priority ? m_threadPoolHandle.pushPriorityTask(std::move(wrapped)) :
+				m_threadPoolHandle.pushTask(std::move(wrapped));
+
+			// pool is shutting down, don't leave the identifier pending forever
+			if (!pushed)
+			{
+				m_pendingTasks.getWriteAccess()->erase(identifier);
+				return 0;
+			}
 			return 1;
 		}
 
@@ -57,6 +65,11 @@ namespace MultiThreading
 			return 1;
 		}
 
+		size_t getPendingCount() const
+		{
+			return m_pendingTasks.getReadAccess()->size();
+		}
+
 		inline ThreadPool& getPoolHandle() const {
 			return m_threadPoolHandle;
 		};